@@ -35,6 +35,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -42,6 +43,22 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Is 'sect' held in the sector cache? */
+
+#define bchlib_cached(b, sect) \
+  ((sect) >= (b)->sector && (sect) - (b)->sector < (b)->ncached)
+
+/* Address of cached sector 'sect' in the cache buffer */
+
+#define bchlib_sectorbuf(b, sect) \
+  (&(b)->buffer[((sect) - (b)->sector) * (b)->sectsize])
+
+#ifdef CONFIG_BCH_STATISTICS
+#  define BCH_STATS_ADD(b, f, n) ((b)->stats.f += (n))
+#else
+#  define BCH_STATS_ADD(b, f, n)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -51,13 +68,22 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the buffer */
+  size_t ncached;          /* Number of valid sectors in the buffer */
+  size_t dirtystart;       /* First dirty sector, relative to 'sector' */
+  size_t dirtyend;         /* One past the last dirty sector */
+  uint16_t cachesize;      /* Capacity of the buffer in sectors */
+  uint16_t readahead;      /* Sectors to read on a cache miss */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Sector cache buffer */
+
+#ifdef CONFIG_BCH_STATISTICS
+  struct bchlib_stats_s stats; /* Cache statistics */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -85,6 +111,7 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 
@@ -60,6 +61,8 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
+static ssize_t bch_readv(FAR struct file *filep, FAR struct uio *uio);
+static ssize_t bch_writev(FAR struct file *filep, FAR struct uio *uio);
 static int     bch_ioctl(FAR struct file *filep, int cmd,
                          unsigned long arg);
 static int     bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
@@ -83,8 +86,8 @@ const struct file_operations g_bch_fops =
   NULL,        /* mmap */
   NULL,        /* truncate */
   bch_poll,    /* poll */
-  NULL,        /* readv */
-  NULL         /* writev */
+  bch_readv,   /* readv */
+  bch_writev   /* writev */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , bch_unlink /* unlink */
 #endif
@@ -351,6 +354,122 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: bch_readv
+ *
+ * Description:
+ *   Scatter read.  The lock is held across the whole vector so that the
+ *   elements see one consistent device state, and an element ending in the
+ *   middle of a sector leaves that sector in the buffer for the next one.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_readv(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = bchlib_read(bch, iov[i].iov_base, filep->f_pos, iov[i].iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      if (ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&bch->lock);
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: bch_writev
+ *
+ * Description:
+ *   Gather write.  The whole vector is written under one hold of the lock.
+ *   A short element only updates the sector buffer, which is not flushed
+ *   until a following element moves past it, so a header plus payload costs
+ *   one read-modify-write of the shared sector plus one multi-sector
+ *   transfer for the aligned part of the payload.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_writev(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  if (bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = bchlib_write(bch, iov[i].iov_base, filep->f_pos,
+                         iov[i].iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      if (ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&bch->lock);
+  return ntotal > 0 ? ntotal : ret;
+}
+
 /****************************************************************************
  * Name: bch_ioctl
  *
@@ -435,11 +554,76 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+      /* Set the number of sectors read on a cache miss */
+
+      case DIOC_SETREADAHEAD:
+        {
+          if (arg < 1 || arg > bch->cachesize)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret >= 0)
+            {
+              bch->readahead = arg;
+              nxmutex_unlock(&bch->lock);
+            }
+        }
+        break;
+
+      case DIOC_GETREADAHEAD:
+        {
+          FAR unsigned int *readahead =
+            (FAR unsigned int *)((uintptr_t)arg);
+
+          if (readahead == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              *readahead = bch->readahead;
+              ret = OK;
+            }
+        }
+        break;
+
+#ifdef CONFIG_BCH_STATISTICS
+      case DIOC_GETSTATS:
+        {
+          FAR struct bchlib_stats_s *stats =
+            (FAR struct bchlib_stats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret >= 0)
+            {
+              memcpy(stats, &bch->stats, sizeof(*stats));
+              nxmutex_unlock(&bch->lock);
+            }
+        }
+        break;
+#endif
+
       case BIOC_DISCARD:
         {
-          /* Invalidate the sector so next read is from the device- */
+          /* Write back anything dirty and invalidate the cache so the next
+           * read is from the device.
+           */
+
+          ret = bchlib_flushsector(bch, true);
+          if (ret < 0)
+            {
+              break;
+            }
 
-          bch->sector = (size_t)-1;
           goto ioctl_default;
         }
 
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #include <nuttx/kmalloc.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <errno.h>
@@ -59,38 +60,91 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 
 /****************************************************************************
  * Name: bch_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt 'count' cached sectors beginning at cache index
+ *   'index'.  Each sector is tweaked with its own sector number.
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t index, size_t count,
+                      int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer;
+  size_t sector;
   int i;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (; count > 0; index++, count--)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
-
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
-
-      /* Xor-Encrypt-Xor */
+      sector = bch->sector + index;
+      buffer = (FAR uint32_t *)bchlib_sectorbuf(bch, sector);
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+        {
+          uint32_t T[4];
+          uint32_t X[4] =
+          {
+            sector, 0, 0, i
+          };
+
+          aes_cypher(X, X, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, CYPHER_ENCRYPT);
+
+          /* Xor-Encrypt-Xor */
+
+          bch_xor(T, X, buffer);
+          aes_cypher(T, T, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, encrypt);
+          bch_xor(buffer, X, T);
+        }
     }
 
   return OK;
 }
 #endif
 
+/****************************************************************************
+ * Name: bchlib_fillcache
+ *
+ * Description:
+ *   Read up to 'count' sectors starting at 'sector' into the cache buffer
+ *   at cache index 'index'.
+ *
+ * Returned Value:
+ *   The number of sectors read, at least one, on success.  The driver may
+ *   return fewer than 'count' sectors, only those may be cached.  A
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t bchlib_fillcache(FAR struct bchlib_s *bch, size_t index,
+                                size_t sector, size_t count)
+{
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+
+  ret = inode->u.i_bops->read(inode, &bch->buffer[index * bch->sectsize],
+                              sector, count);
+  if (ret < 0)
+    {
+      ferr("Read failed: %zd\n", ret);
+      return ret;
+    }
+  else if (ret == 0 || (size_t)ret > count)
+    {
+      ferr("Bad read of %zu sectors: %zd\n", count, ret);
+      return -EIO;
+    }
+
+  BCH_STATS_ADD(bch, misses, 1);
+  BCH_STATS_ADD(bch, fillsectors, ret);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,7 +153,9 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the dirty sectors of the cache buffer (if any) back to the media
+ *   as one contiguous transfer.  If 'discard' is true, the cache is
+ *   invalidated afterwards.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -109,25 +165,30 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 {
   FAR struct inode *inode;
+  size_t count;
   ssize_t ret = OK;
 
-  /* Check if the sector has been modified and is out of synch with the
+  /* Check if the sectors have been modified and are out of synch with the
    * media.
    */
 
   if (bch->dirty && bch->buffer != NULL)
     {
       inode = bch->inode;
+      count = bch->dirtyend - bch->dirtystart;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->dirtystart, count, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
+      /* Write the dirty range to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode,
+                                   &bch->buffer[bch->dirtystart *
+                                                bch->sectsize],
+                                   bch->sector + bch->dirtystart, count);
       if (ret < 0)
         {
           ferr("Write failed: %zd\n", ret);
@@ -139,17 +200,21 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->dirtystart, count, CYPHER_DECRYPT);
 #endif
 
-      /* The sector is now in sync with the media */
+      BCH_STATS_ADD(bch, flushes, 1);
+      BCH_STATS_ADD(bch, flushsectors, count);
+
+      /* The sectors are now in sync with the media */
 
       bch->dirty = false;
     }
 
   if (discard)
     {
-      bch->sector = (size_t)-1;
+      bch->sector  = (size_t)-1;
+      bch->ncached = 0;
     }
 
   return (int)ret;
@@ -159,7 +224,10 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make sure that 'sector' is held in the cache buffer.  On a miss the
+ *   cache is either extended (if 'sector' immediately follows the cached
+ *   window and there is room) or flushed and refilled starting at
+ *   'sector'.  Up to bch->readahead sectors are read in either case.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -168,15 +236,18 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  ssize_t nread;
+  size_t count;
+  int ret = OK;
 
   if (bch->buffer == NULL)
     {
+      size_t size = (size_t)bch->cachesize * bch->sectsize;
+
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, size);
 #else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      bch->buffer = kmm_malloc(size);
 #endif
       if (bch->buffer == NULL)
         {
@@ -185,29 +256,93 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
         }
     }
 
-  if (bch->sector != sector)
+  if (bchlib_cached(bch, sector))
     {
-      inode = bch->inode;
+      BCH_STATS_ADD(bch, hits, 1);
+      return OK;
+    }
 
-      ret = bchlib_flushsector(bch, true);
-      if (ret < 0)
-        {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
-        }
+  if (bch->ncached > 0 && sector == bch->sector + bch->ncached &&
+      bch->ncached < bch->cachesize)
+    {
+      /* Sequential access: grow the window so that dirty sectors before
+       * this one stay cached and are written back together later.
+       */
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+      count = MIN(bch->readahead, bch->cachesize - bch->ncached);
+      count = MIN(count, bch->nsectors - sector);
+
+      nread = bchlib_fillcache(bch, bch->ncached, sector, count);
+      if (nread < 0)
         {
-          ferr("Read failed: %zd\n", ret);
-          return (int)ret;
+          return (int)nread;
         }
 
-      bch->sector = sector;
+      count = nread;
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->ncached, count, CYPHER_DECRYPT);
 #endif
+      bch->ncached += count;
+      return OK;
     }
 
-  return (int)ret;
+  ret = bchlib_flushsector(bch, true);
+  if (ret < 0)
+    {
+      ferr("Flush failed: %d\n", ret);
+      return ret;
+    }
+
+  count = MIN(bch->readahead, bch->nsectors - sector);
+
+  nread = bchlib_fillcache(bch, 0, sector, count);
+  if (nread < 0)
+    {
+      return (int)nread;
+    }
+
+  count        = nread;
+  bch->sector  = sector;
+  bch->ncached = count;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  bch_cypher(bch, 0, count, CYPHER_DECRYPT);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark cached 'sector' as modified.  The dirty range only ever grows
+ *   until the next flush, so that it can be written back in one transfer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion and 'sector' must be cached.
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector)
+{
+  size_t index;
+
+  DEBUGASSERT(bchlib_cached(bch, sector));
+
+  index = sector - bch->sector;
+  if (!bch->dirty)
+    {
+      bch->dirtystart = index;
+      bch->dirtyend   = index + 1;
+      bch->dirty      = true;
+    }
+  else if (index < bch->dirtystart)
+    {
+      bch->dirtystart = index;
+    }
+  else if (index >= bch->dirtyend)
+    {
+      bch->dirtyend = index + 1;
+    }
 }
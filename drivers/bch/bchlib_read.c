@@ -120,7 +120,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, bchlib_sectorbuf(bch, sector) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -136,11 +136,12 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
       len       -= nbytes;
     }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+  /* Then read all of the full sectors following the partial sector.  Those
+   * already held in the cache are copied from it (they may be dirty); the
+   * rest are read directly into the user buffer.
    */
 
-  if (len >= bch->sectsize)
+  while (len >= bch->sectsize)
     {
       nsectors = len / bch->sectsize;
       if (sector + nsectors > bch->nsectors)
@@ -148,12 +149,37 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
+      if (bchlib_cached(bch, sector))
         {
-          ferr("ERROR: Read failed: %d\n", ret);
-          return ret;
+          if (nsectors > bch->sector + bch->ncached - sector)
+            {
+              nsectors = bch->sector + bch->ncached - sector;
+            }
+
+          memcpy(buffer, bchlib_sectorbuf(bch, sector),
+                 nsectors * bch->sectsize);
+          BCH_STATS_ADD(bch, hits, 1);
+        }
+      else
+        {
+          /* Stop short of the cached window, if it lies ahead */
+
+          if (bch->ncached > 0 && sector < bch->sector &&
+              sector + nsectors > bch->sector)
+            {
+              nsectors = bch->sector - sector;
+            }
+
+          ret = bch->inode->u.i_bops->read(bch->inode,
+                                           (FAR uint8_t *)buffer,
+                                           sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
+
+          BCH_STATS_ADD(bch, directread, nsectors);
         }
 
       /* Adjust pointers and counts */
@@ -185,7 +211,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, bchlib_sectorbuf(bch, sector), len);
 
       /* Adjust counts */
 
@@ -113,6 +113,9 @@ int bchlib_setup(FAR const char *blkdev, int oflags, FAR void **handle)
   bch->sectsize = geo.geo_sectorsize;
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+
+  bch->cachesize = CONFIG_BCH_CACHE_SECTORS;
+  bch->readahead = CONFIG_BCH_READAHEAD_SECTORS;
   *handle = bch;
   return OK;
 
@@ -106,8 +106,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(bchlib_sectorbuf(bch, sector) + sectoffset, buffer, nbytes);
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust pointers and counts */
 
@@ -143,17 +143,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       /* Copy the data from the user buffer to the sector buffer */
 
       nbytes = len > bch->sectsize ? bch->sectsize : len;
-      memcpy(bch->buffer, buffer, nbytes);
-      bch->dirty = true;
+      memcpy(bchlib_sectorbuf(bch, sector), buffer, nbytes);
 
-      /* Write the sector back to the block device */
+      /* The sector is written back together with its dirty neighbours
+       * when the cache window moves or is flushed.
+       */
 
-      ret = bchlib_flushsector(bch, false);
-      if (ret < 0)
-        {
-          ferr("ERROR: Flush failed: %d\n", ret);
-          return ret;
-        }
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust pointers and counts */
 
@@ -175,10 +171,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      /* Flush the dirty sectors to keep the sector sequence, and drop the
+       * cache if the direct write overlaps it.
+       */
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
+      ret = bchlib_flushsector(bch, bch->ncached > 0 &&
+                               sector < bch->sector + bch->ncached &&
+                               bch->sector < sector + nsectors);
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -195,6 +194,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           return ret;
         }
 
+      BCH_STATS_ADD(bch, directwrite, nsectors);
+
       /* Adjust pointers and counts */
 
       sector       += nsectors;
@@ -224,8 +225,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(bchlib_sectorbuf(bch, sector), buffer, len);
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust counts */
 
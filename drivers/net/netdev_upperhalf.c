@@ -36,9 +36,12 @@
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -51,6 +54,10 @@
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
 
+/* Packets pulled from one RX queue before the device is locked */
+
+#define NETDEV_RX_BATCH 16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +93,14 @@ struct netdev_upperhalf_s
   struct netdev_vlan_entry_s vlan[CONFIG_NET_VLAN_COUNT];
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+  /* TCP segments merged during the current RX poll, not yet passed to the
+   * stack.
+   */
+
+  FAR netpkt_t *gro;
+#endif
+
   bool txing;
 
   /* Deferring process to work queue or thread */
@@ -255,6 +270,234 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return quota > 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_transmit
+ *
+ * Description:
+ *   Hand a packet to the lower half.  Multi-queue devices get it on the TX
+ *   queue selected by its flow hash, so a flow is never reordered across
+ *   queues.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_transmit(FAR struct netdev_lowerhalf_s *lower,
+                                 FAR netpkt_t *pkt)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->txqueues > 1 && lower->ops->transmit_queue != NULL)
+    {
+      int qid = netpkt_flowhash(lower, pkt) % lower->txqueues;
+      int ret = lower->ops->transmit_queue(lower, pkt, qid);
+
+      if (ret == OK)
+        {
+          NETDEV_TXQPACKETS(&lower->netdev, qid);
+        }
+
+      return ret;
+    }
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_check
+ *
+ * Description:
+ *   Check that the packet in the device buffer is an IPv4 TCP segment with
+ *   more than d_gso_size bytes of payload, the only kind of packet that
+ *   d_gso_size applies to.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   true if the packet is to be split into d_gso_size segments.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static bool netdev_upper_gso_check(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct tcp_hdr_s  *tcp;
+  unsigned int           llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int           hdrlen;
+
+  if (dev->d_len < llhdrlen + IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return false;
+    }
+
+  if ((dev->d_lltype == NET_LL_ETHERNET ||
+       dev->d_lltype == NET_LL_IEEE80211) &&
+      ((FAR struct eth_hdr_s *)NETLLBUF)->type != HTONS(ETHTYPE_IP))
+    {
+      return false;
+    }
+
+  if ((ipv4->vhl & IP_VERSION_MASK) != IPv4_VERSION ||
+      ipv4->proto != IP_PROTO_TCP)
+    {
+      return false;
+    }
+
+  hdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  if (dev->d_len < llhdrlen + hdrlen + TCP_HDRLEN)
+    {
+      return false;
+    }
+
+  tcp     = (FAR struct tcp_hdr_s *)((FAR uint8_t *)ipv4 + hdrlen);
+  hdrlen += (tcp->tcpoffset >> 4) << 2;
+
+  return dev->d_len > llhdrlen + hdrlen + dev->d_gso_size;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_gso_segment
+ *
+ * Description:
+ *   Split an outgoing TCP segment larger than the MSS into segments of at
+ *   most gso bytes of payload each and queue them on the TX queue, for
+ *   lower halves without hardware segmentation.  Every segment gets a copy
+ *   of the L2, IPv4 and TCP headers with the length, IP identification,
+ *   sequence number and checksums fixed up; PSH and FIN stay on the last
+ *   segment only.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   gso - The payload size of each segment
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - The segments are queued, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static int netdev_upper_gso_segment(FAR struct net_driver_s *dev,
+                                    uint16_t gso)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR netpkt_t                  *pkt   = dev->d_iob;
+  FAR struct ipv4_hdr_s         *ipv4  = IPv4BUF;
+  FAR struct tcp_hdr_s          *tcp;
+  unsigned int                   llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int                   hdrlen;
+  unsigned int                   off;
+  uint32_t                       seq;
+  uint16_t                       ipid;
+  int                            ret = NETDEV_TX_CONTINUE;
+
+  hdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  tcp    = (FAR struct tcp_hdr_s *)((FAR uint8_t *)ipv4 + hdrlen);
+  hdrlen += (tcp->tcpoffset >> 4) << 2;
+
+  if ((ipv4->vhl & IP_VERSION_MASK) != IPv4_VERSION ||
+      ipv4->proto != IP_PROTO_TCP || pkt->io_len < hdrlen ||
+      NETDEV_PKTSIZE(dev) <= llhdrlen + hdrlen)
+    {
+      nerr("ERROR: Cannot segment packet!\n");
+      netdev_iob_release(dev);
+      return -EMSGSIZE;
+    }
+
+  /* The TCP header may carry more options than the MSS accounts for */
+
+  gso  = MIN(gso, NETDEV_PKTSIZE(dev) - llhdrlen - hdrlen);
+  seq  = ((uint32_t)tcp->seqno[0] << 24) | ((uint32_t)tcp->seqno[1] << 16) |
+         ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+  ipid = ((uint16_t)ipv4->ipid[0] << 8) | ipv4->ipid[1];
+
+  netdev_iob_clear(dev);
+
+  for (off = hdrlen; off < pkt->io_pktlen; off += gso)
+    {
+      unsigned int len = MIN(gso, pkt->io_pktlen - off);
+      FAR struct ipv4_hdr_s *sipv4;
+      FAR struct tcp_hdr_s *stcp;
+      FAR netpkt_t *seg;
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      /* Copy the headers, then the payload of this segment */
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      memcpy(IOB_DATA(seg) - llhdrlen, IOB_DATA(pkt) - llhdrlen,
+             llhdrlen + hdrlen);
+      seg->io_len    = hdrlen;
+      seg->io_pktlen = hdrlen;
+
+      if (iob_clone_partial(pkt, len, off, seg, hdrlen, false, false) < 0)
+        {
+          iob_free_chain(seg);
+          ret = -ENOMEM;
+          break;
+        }
+
+      sipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(seg);
+      stcp  = (FAR struct tcp_hdr_s *)
+              ((FAR uint8_t *)tcp - (FAR uint8_t *)ipv4 + IOB_DATA(seg));
+
+      sipv4->len[0]   = (hdrlen + len) >> 8;
+      sipv4->len[1]   = (hdrlen + len) & 0xff;
+      sipv4->ipid[0]  = ipid >> 8;
+      sipv4->ipid[1]  = ipid & 0xff;
+      sipv4->ipchksum = 0;
+      sipv4->ipchksum = ~ipv4_chksum(sipv4);
+      ipid++;
+
+      stcp->seqno[0] = (seq + off - hdrlen) >> 24;
+      stcp->seqno[1] = (seq + off - hdrlen) >> 16;
+      stcp->seqno[2] = (seq + off - hdrlen) >> 8;
+      stcp->seqno[3] = (seq + off - hdrlen);
+
+      if (off + len < pkt->io_pktlen)
+        {
+          stcp->flags &= ~(TCP_PSH | TCP_FIN);
+        }
+
+      stcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+        {
+          netdev_iob_replace_l2(dev, seg);
+          stcp->tcpchksum = ~ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
+          netdev_iob_clear(dev);
+        }
+#endif
+
+      if (iob_tryadd_queue(seg, &upper->txq) < 0)
+        {
+          iob_free_chain(seg);
+          ret = -ENOMEM;
+          break;
+        }
+    }
+
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to segment packet: %d\n", ret);
+      NETDEV_TXERRORS(dev);
+    }
+
+  iob_free_chain(pkt);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -289,6 +532,26 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   DEBUGASSERT(dev->d_len > 0);
 
+#ifdef CONFIG_NETDEV_GSO
+  if (dev->d_gso_size > 0 && !netdev_upper_gso_check(dev))
+    {
+      /* Not a TCP segment to split, e.g. an ARP request that replaced it */
+
+      dev->d_gso_size = 0;
+    }
+  else if (dev->d_gso_size > 0 && (dev->d_features & NETDEV_TSO) == 0)
+    {
+      /* Split in software, the segments are sent from the TX queue.  This
+       * must happen even if the frame fits in the MTU: the payload is
+       * larger than the MSS and the TCP checksum has not been computed.
+       */
+
+      ret = netdev_upper_gso_segment(dev, dev->d_gso_size);
+      dev->d_gso_size = 0;
+      return ret;
+    }
+#endif
+
   NETDEV_TXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
@@ -299,16 +562,21 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      NETDEV_GSO_SIZE(dev) == 0)
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+      ret = netdev_upper_transmit(lower, pkt);
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gso_size = 0;
+#endif
+
   if (ret != OK)
     {
       /* Stop polling on any error
@@ -484,7 +752,11 @@ netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
 {
   int i;
 
-  net_lock();
+  /* The VLAN table is protected by the lock of the real device, which is
+   * always taken before the lock of a VLAN device (see eth_input).
+   */
+
+  netdev_lock(&upper->lower->netdev);
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
       if (upper->vlan[i].dev)
@@ -493,7 +765,7 @@ netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
         }
     }
 
-  net_unlock();
+  netdev_unlock(&upper->lower->netdev);
 }
 #endif
 
@@ -687,6 +959,325 @@ static void ip_input(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass the packet in d_iob to the input of its link layer.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct net_driver_s *dev)
+{
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+      case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+      case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+      case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+        eth_input(dev);
+        break;
+#endif
+#ifdef CONFIG_NET_MBIM
+      case NET_LL_MBIM:
+        ip_input(dev);
+        break;
+#endif
+#ifdef CONFIG_NET_CAN
+      case NET_LL_CAN:
+        ninfo("CAN frame");
+        can_input(dev);
+        break;
+#endif
+      default:
+        nerr("Unknown link type %d\n", dev->d_lltype);
+        break;
+    }
+}
+
+#ifdef CONFIG_NETDEV_GRO
+/****************************************************************************
+ * Name: netdev_upper_gro_tcp
+ *
+ * Description:
+ *   Return the TCP header of a received frame if GRO may merge it: an
+ *   unfragmented IPv4 TCP segment without IP options, addressed to this
+ *   device, carrying data and no flags besides ACK and PSH.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_hdr_s *
+netdev_upper_gro_tcp(FAR struct net_driver_s *dev, FAR netpkt_t *pkt)
+{
+  FAR struct eth_hdr_s  *eth;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s  *tcp;
+  uint16_t               hdrlen;
+  uint16_t               iplen;
+
+  if (dev->d_lltype != NET_LL_ETHERNET || pkt->io_len < IPv4TCP_HDRLEN)
+    {
+      return NULL;
+    }
+
+  eth  = (FAR struct eth_hdr_s *)(IOB_DATA(pkt) - NET_LL_HDRLEN(dev));
+  ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  tcp  = (FAR struct tcp_hdr_s *)(ipv4 + 1);
+
+  if (eth->type != HTONS(ETHTYPE_IP) ||
+      ipv4->vhl != (IPv4_VERSION | (IPv4_HDRLEN >> 2)) ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (((ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) &
+       ~IP_FLAG_DONTFRAG) != 0 ||
+      !net_ipv4addr_hdrcmp(ipv4->destipaddr, &dev->d_ipaddr) ||
+      (tcp->flags & TCP_CTL & ~TCP_PSH) != TCP_ACK)
+    {
+      return NULL;
+    }
+
+  hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+  iplen  = (ipv4->len[0] << 8) | ipv4->len[1];
+
+  if (hdrlen < IPv4TCP_HDRLEN || pkt->io_len < hdrlen ||
+      iplen <= hdrlen || iplen > pkt->io_pktlen)
+    {
+      return NULL;
+    }
+
+  return tcp;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Pass the merged TCP segments, if any, to the stack.
+ *
+ * Assumptions:
+ *   Called with the network locked and d_iob not in use.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR struct ipv4_hdr_s   *ipv4;
+  FAR netpkt_t            *pkt = upper->gro;
+  uint8_t                  features;
+
+  if (pkt == NULL)
+    {
+      return;
+    }
+
+  upper->gro      = NULL;
+  ipv4            = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  ipv4->ipchksum  = 0;
+  ipv4->ipchksum  = ~ipv4_chksum(ipv4);
+
+  netdev_iob_replace_l2(dev, pkt);
+
+  /* Every merged segment had its checksum verified on arrival */
+
+  features         = dev->d_features;
+  dev->d_features |= NETDEV_RX_CSUM;
+  netdev_upper_input(dev);
+  dev->d_features  = features;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_receive
+ *
+ * Description:
+ *   Try to merge the frame in d_iob into the pending GRO packet.  A TCP
+ *   segment continuing the pending one (same flow, next sequence number,
+ *   same ACK, window and options) has its headers stripped and its data
+ *   appended to the pending chain.  Any other mergeable segment flushes
+ *   the pending packet and becomes the new one.
+ *
+ * Returned Value:
+ *   true if the frame was taken over by GRO, false if it should be passed
+ *   to the stack as is (after anything pending, to keep the order).
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_receive(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR netpkt_t            *pkt = dev->d_iob;
+  FAR struct ipv4_hdr_s   *ipv4;
+  FAR struct ipv4_hdr_s   *gipv4;
+  FAR struct tcp_hdr_s    *tcp;
+  FAR struct tcp_hdr_s    *gtcp;
+  uint16_t                 hdrlen;
+  uint16_t                 giplen;
+  uint16_t                 iplen;
+  uint32_t                 gseq;
+  uint32_t                 seq;
+  uint8_t                  psh;
+
+  tcp = netdev_upper_gro_tcp(dev, pkt);
+  if (tcp == NULL)
+    {
+      goto passthrough;
+    }
+
+  ipv4   = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+  iplen  = (ipv4->len[0] << 8) | ipv4->len[1];
+
+  /* Drop the link layer padding and check the segment now; a bad one is
+   * left for the stack to count and drop.
+   */
+
+  if (iob_update_pktlen(pkt, iplen, false) < 0)
+    {
+      goto passthrough;
+    }
+
+  dev->d_len = iplen + NET_LL_HDRLEN(dev);
+
+  if ((dev->d_features & NETDEV_RX_CSUM) == 0)
+    {
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      if (ipv4_chksum(ipv4) != 0xffff)
+        {
+          goto passthrough;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if (ipv4_upperlayer_chksum(dev, IP_PROTO_TCP) != 0xffff)
+        {
+          goto passthrough;
+        }
+#endif
+    }
+
+  netdev_iob_clear(dev);
+
+  if (upper->gro != NULL)
+    {
+      gipv4  = (FAR struct ipv4_hdr_s *)IOB_DATA(upper->gro);
+      gtcp   = (FAR struct tcp_hdr_s *)(gipv4 + 1);
+      giplen = (gipv4->len[0] << 8) | gipv4->len[1];
+      gseq   = ((uint32_t)gtcp->seqno[0] << 24) |
+               ((uint32_t)gtcp->seqno[1] << 16) |
+               ((uint32_t)gtcp->seqno[2] << 8) | gtcp->seqno[3];
+      seq    = ((uint32_t)tcp->seqno[0] << 24) |
+               ((uint32_t)tcp->seqno[1] << 16) |
+               ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+
+      if (seq == gseq + giplen - hdrlen &&
+          giplen + iplen - hdrlen <= CONFIG_NETDEV_GRO_MAXSIZE &&
+          gipv4->tos == ipv4->tos &&
+          net_ipv4addr_hdrcmp(gipv4->srcipaddr, ipv4->srcipaddr) &&
+          gtcp->srcport == tcp->srcport &&
+          gtcp->destport == tcp->destport &&
+          gtcp->tcpoffset == tcp->tcpoffset &&
+          (gtcp->flags & TCP_PSH) == 0 &&
+          memcmp(gtcp->ackno, tcp->ackno, sizeof(tcp->ackno)) == 0 &&
+          memcmp(gtcp->wnd, tcp->wnd, sizeof(tcp->wnd)) == 0 &&
+          memcmp(gtcp->optdata, tcp->optdata,
+                 hdrlen - IPv4TCP_HDRLEN) == 0)
+        {
+          /* Append the payload to the pending chain */
+
+          psh = tcp->flags & TCP_PSH;
+          pkt = iob_trimhead(pkt, hdrlen);
+          iob_concat(upper->gro, pkt);
+
+          giplen         += iplen - hdrlen;
+          gipv4->len[0]   = giplen >> 8;
+          gipv4->len[1]   = giplen & 0xff;
+          gtcp->flags    |= psh;
+          return true;
+        }
+
+      netdev_upper_gro_flush(upper);
+    }
+
+  upper->gro = pkt;
+  return true;
+
+passthrough:
+  if (upper->gro != NULL)
+    {
+      netdev_iob_clear(dev);
+      netdev_upper_gro_flush(upper);
+      netdev_iob_replace_l2(dev, pkt);
+    }
+
+  return false;
+}
+#endif /* CONFIG_NETDEV_GRO */
+
+/****************************************************************************
+ * Name: netdev_upper_rxpkt
+ *
+ * Description:
+ *   Pass one received packet into the IP stack.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Assumptions:
+ *   Called with the device locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpkt(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+
+  if (!IFF_IS_UP(dev->d_flags))
+    {
+      /* Interface down, drop frame */
+
+      NETDEV_RXDROPPED(dev);
+      netpkt_free(lower, pkt, NETPKT_RX);
+      nerr("ERROR: Dropped frame due to lower dev not up\n");
+      return;
+    }
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  if (netdev_upper_gro_receive(upper))
+    {
+      return;
+    }
+#endif
+
+  netdev_upper_input(dev);
+}
+
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
  *
@@ -713,59 +1304,110 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
   netdev_lock(dev);
   while ((pkt = lower->ops->receive(lower)) != NULL)
     {
-      if (!IFF_IS_UP(dev->d_flags))
+      netdev_upper_rxpkt(upper, pkt);
+    }
+
+#ifdef CONFIG_NETDEV_GRO
+  netdev_upper_gro_flush(upper);
+#endif
+
+  netdev_unlock(dev);
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_queue
+ *
+ * Description:
+ *   Receive the packets of one RX queue of a multi-queue device.  Packets
+ *   are pulled from the queue in batches without the device lock, so the
+ *   driver work of each queue runs in parallel with the stack input of the
+ *   others.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   qid   - The RX queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_rxpoll_queue(FAR struct netdev_upperhalf_s *upper,
+                                      int qid)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR netpkt_t                  *batch[NETDEV_RX_BATCH];
+  int                            npkts;
+  int                            i;
+
+  do
+    {
+      for (npkts = 0; npkts < NETDEV_RX_BATCH; npkts++)
         {
-          /* Interface down, drop frame */
+          batch[npkts] = lower->ops->receive_queue(lower, qid);
+          if (batch[npkts] == NULL)
+            {
+              break;
+            }
 
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          nerr("ERROR: Dropped frame due to lower dev not up\n");
-          continue;
+          NETDEV_RXQPACKETS(dev, qid);
         }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+      if (npkts > 0)
+        {
+          netdev_lock(dev);
+          for (i = 0; i < npkts; i++)
+            {
+              netdev_upper_rxpkt(upper, batch[i]);
+            }
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+#ifdef CONFIG_NETDEV_GRO
+          netdev_upper_gro_flush(upper);
+#endif
 
-      pkt_input(dev);
+          netdev_unlock(dev);
+        }
+    }
+  while (npkts == NETDEV_RX_BATCH);
+}
 #endif
 
-      switch (dev->d_lltype)
+/****************************************************************************
+ * Name: netdev_upper_rxpoll
+ *
+ * Description:
+ *   Receive on behalf of one RX worker.  For a multi-queue device, worker
+ *   n serves the RX queues n, n + nworkers, ...; otherwise worker n polls
+ *   the single queue.
+ *
+ * Input Parameters:
+ *   upper  - Reference to the upper half driver structure
+ *   worker - Index of the RX worker (CPU index in RSS mode)
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpoll(FAR struct netdev_upperhalf_s *upper,
+                                int worker)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+  if (lower->rxqueues > 1 && lower->ops->receive_queue != NULL)
+    {
+      int nworkers = lower->rxtype == NETDEV_RX_THREAD_RSS ?
+                     CONFIG_SMP_NCPUS : 1;
+      int qid;
+
+      for (qid = worker % nworkers; qid < lower->rxqueues; qid += nworkers)
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+          netdev_upper_rxpoll_queue(upper, qid);
         }
+
+      return;
     }
+#endif
 
-  netdev_unlock(dev);
+  UNUSED(worker);
+  netdev_upper_rxpoll_work(upper);
 }
 
 /****************************************************************************
@@ -785,7 +1427,7 @@ static void netdev_upper_work(FAR void *arg)
 
   /* RX may release quota and driver buffer, so do RX first. */
 
-  netdev_upper_rxpoll_work(upper);
+  netdev_upper_rxpoll(upper, 0);
   netdev_upper_txavail_work(upper);
 }
 
@@ -815,7 +1457,10 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
 
   while (nxsem_wait(&t->sem) == OK && t->tid != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      /* RX may release quota and driver buffer, so do RX first. */
+
+      netdev_upper_rxpoll(upper, cpu);
+      netdev_upper_txavail_work(upper);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -823,6 +1468,26 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   return 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_post_thread
+ *
+ * Description:
+ *   Wake up the dedicated thread of the given CPU index.
+ *
+ ****************************************************************************/
+
+static inline void
+netdev_upper_post_thread(FAR struct netdev_upperhalf_s *upper, int cpu)
+{
+  FAR struct netdev_thread_s *t = &upper->thread[cpu];
+  int semcount;
+
+  if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
+    {
+      nxsem_post(&t->sem);
+    }
+}
+
 /****************************************************************************
  * Name: netdev_upper_queue_work
  *
@@ -856,15 +1521,7 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
       case NETDEV_RX_THREAD_RSS:
         cpu = this_cpu();
       case NETDEV_RX_THREAD:
-        {
-          FAR struct netdev_thread_s *t = &upper->thread[cpu];
-          int semcount;
-
-          if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
-            {
-              nxsem_post(&t->sem);
-            }
-        }
+        netdev_upper_post_thread(upper, cpu);
         break;
     }
 }
@@ -1391,6 +2048,15 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->rxqueues > CONFIG_NETDEV_MAX_QUEUES ||
+      dev->txqueues > CONFIG_NETDEV_MAX_QUEUES)
+    {
+      nerr("ERROR: Too many queues: %d/%d\n", dev->rxqueues, dev->txqueues);
+      return -EINVAL;
+    }
+#endif
+
   switch (dev->rxtype)
     {
       case NETDEV_RX_WORK:
@@ -1419,6 +2085,12 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 
   upper->txing = false;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Oversized TCP segments are split here if the lower half can't */
+
+  dev->netdev.d_features |= NETDEV_GSO;
+#endif
+
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
@@ -1585,7 +2257,7 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 
   if (dev->rxtype == NETDEV_RX_DIRECT)
     {
-      netdev_upper_rxpoll_work(dev->netdev.d_private);
+      netdev_upper_rxpoll(dev->netdev.d_private, 0);
     }
   else
     {
@@ -1593,6 +2265,46 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer that RX queue qid of a multi-queue
+ *   device has packets ready to read.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The RX queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int qid)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  if (dev->rxqueues <= 1 || dev->ops->receive_queue == NULL)
+    {
+      netdev_lower_rxready(dev);
+      return;
+    }
+
+  switch (dev->rxtype)
+    {
+      case NETDEV_RX_DIRECT:
+        netdev_upper_rxpoll_queue(upper, qid);
+        break;
+      case NETDEV_RX_THREAD_RSS:
+        netdev_upper_post_thread(upper, qid % CONFIG_SMP_NCPUS);
+        break;
+      default:
+        netdev_upper_queue_work(&dev->netdev);
+        break;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -1644,13 +2356,16 @@ int netdev_lower_vlan_add(FAR struct netdev_lowerhalf_s *dev, uint16_t vid,
 {
   FAR struct netdev_upperhalf_s  *upper = dev->netdev.d_private;
   FAR struct netdev_vlan_entry_s *entry = NULL;
+  int ret = -ENOMEM;
   int i;
 
+  netdev_lock(&dev->netdev);
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
       if (upper->vlan[i].vid == vid)
         {
-          return -EEXIST;
+          ret = -EEXIST;
+          goto out;
         }
 
       if (upper->vlan[i].vid == 0 && entry == NULL)
@@ -1663,10 +2378,12 @@ int netdev_lower_vlan_add(FAR struct netdev_lowerhalf_s *dev, uint16_t vid,
     {
       entry->vid = vid;
       entry->dev = vlan;
-      return OK;
+      ret = OK;
     }
 
-  return -ENOMEM;
+out:
+  netdev_unlock(&dev->netdev);
+  return ret;
 }
 
 /****************************************************************************
@@ -1687,19 +2404,23 @@ int netdev_lower_vlan_add(FAR struct netdev_lowerhalf_s *dev, uint16_t vid,
 int netdev_lower_vlan_del(FAR struct netdev_lowerhalf_s *dev, uint16_t vid)
 {
   FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+  int ret = -ENOENT;
   int i;
 
+  netdev_lock(&dev->netdev);
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
       if (upper->vlan[i].vid == vid)
         {
           upper->vlan[i].vid = 0;
           upper->vlan[i].dev = NULL;
-          return OK;
+          ret = OK;
+          break;
         }
     }
 
-  return -ENOENT;
+  netdev_unlock(&dev->netdev);
+  return ret;
 }
 #endif
 
@@ -1969,3 +2690,81 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_flowhash
+ *
+ * Description:
+ *   Compute the Toeplitz hash of the packet's flow with the default RSS
+ *   key: addresses and TCP/UDP ports for IPv4 and IPv6, addresses only
+ *   for other protocols.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet
+ *
+ * Returned Value:
+ *   The flow hash, 0 for packets that are not IP.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+uint32_t netpkt_flowhash(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  uint8_t tuple[36];
+  size_t addrlen;
+  size_t hdrlen;
+  uint8_t proto;
+
+  UNUSED(dev);
+
+#ifdef CONFIG_NET_IPv4
+  if (pkt->io_len >= IPv4_HDRLEN &&
+      (ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      addrlen = 2 * sizeof(in_addr_t);
+      hdrlen  = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto   = ipv4->proto;
+      memcpy(tuple, ipv4->srcipaddr, addrlen);
+
+      /* Only the first fragment carries the ports */
+
+      if ((((ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) &
+           ~IP_FLAG_DONTFRAG) != 0)
+        {
+          proto = 0;
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (pkt->io_len >= IPv6_HDRLEN &&
+      (ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      addrlen = 2 * sizeof(net_ipv6addr_t);
+      hdrlen  = IPv6_HDRLEN;
+      proto   = ipv6->proto;
+      memcpy(tuple, ipv6->srcipaddr, addrlen);
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      pkt->io_len >= hdrlen + 4)
+    {
+      memcpy(&tuple[addrlen], ip + hdrlen, 4);
+      addrlen += 4;
+    }
+
+  return netdev_toeplitz_hash(tuple, addrlen);
+}
+#endif
@@ -60,7 +60,7 @@ FAR void *find_driver(FAR const char *pathname)
 
   /* Get the search results */
 
-  inode_lock();
+  inode_rlock();
   if (inode_find(&desc) < 0)
     {
       ferr("ERROR: Failed to find %s\n", pathname);
@@ -71,7 +71,7 @@ FAR void *find_driver(FAR const char *pathname)
       inode_release(desc.node);
     }
 
-  inode_unlock();
+  inode_runlock();
   RELEASE_SEARCH(&desc);
 
   return drvr;
@@ -26,10 +26,12 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/uio.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -60,6 +62,16 @@
 #define ROUND_UP(a, b)          (((a) + (b) - 1) & ~((b) - 1))
 #define DIV_ROUND_UP(a, b)      (ROUND_UP(a, b) / (b))
 
+#ifdef CONFIG_FAT_PERFILE_LOCK
+#  define fat_lock_file(ff)     nxrmutex_lock(&(ff)->ff_lock)
+#  define fat_unlock_file(ff)   nxrmutex_unlock(&(ff)->ff_lock)
+#else
+#  define fat_lock_file(ff)     OK
+#  define fat_unlock_file(ff)
+#  define fat_breaklock(fs, l)
+#  define fat_restorelock(fs, l) OK
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -71,6 +83,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
+static ssize_t fat_readv(FAR struct file *filep, FAR struct uio *uio);
+static ssize_t fat_writev(FAR struct file *filep, FAR struct uio *uio);
 static off_t   fat_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fat_ioctl(FAR struct file *filep, int cmd,
                  unsigned long arg);
@@ -134,8 +148,8 @@ const struct mountpt_operations g_fat_operations =
   NULL,              /* mmap */
   fat_truncate,      /* truncate */
   NULL,              /* poll */
-  NULL,              /* readv */
-  NULL,              /* writev */
+  fat_readv,         /* readv */
+  fat_writev,        /* writev */
 
   fat_sync,          /* sync */
   fat_dup,           /* dup */
@@ -163,6 +177,102 @@ const struct mountpt_operations g_fat_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_lock
+ *
+ * Description:
+ *   Get exclusive access to an open file and to the volume that holds it.
+ *   The file lock is always taken before the volume lock.
+ *
+ ****************************************************************************/
+
+static int fat_lock(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff)
+{
+  int ret;
+
+  ret = fat_lock_file(ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      fat_unlock_file(ff);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_unlock
+ *
+ * Description:
+ *   Undo fat_lock().  The volume lock is not held any more if
+ *   fat_restorelock() failed during a data transfer, so it is only
+ *   released here if the caller still owns it.
+ *
+ ****************************************************************************/
+
+static void fat_unlock(FAR struct fat_mountpt_s *fs,
+                       FAR struct fat_file_s *ff)
+{
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  if (nxmutex_is_hold(&fs->fs_lock))
+#endif
+    {
+      nxmutex_unlock(&fs->fs_lock);
+    }
+
+  fat_unlock_file(ff);
+}
+
+#ifdef CONFIG_FAT_PERFILE_LOCK
+/****************************************************************************
+ * Name: fat_breaklock
+ *
+ * Description:
+ *   Release the volume lock for the duration of a file data transfer.  The
+ *   caller still holds the file lock; fs_nbusy keeps a forced unmount from
+ *   freeing the volume underneath the transfer.
+ *
+ ****************************************************************************/
+
+static void fat_breaklock(FAR struct fat_mountpt_s *fs,
+                          FAR unsigned int *locked)
+{
+  fs->fs_nbusy++;
+  nxmutex_breaklock(&fs->fs_lock, locked);
+}
+
+/****************************************************************************
+ * Name: fat_restorelock
+ *
+ * Description:
+ *   Retake the volume lock after a data transfer.  On failure the lock is
+ *   not held, so fs_nbusy is left alone and the volume stays busy rather
+ *   than being updated unlocked.
+ *
+ ****************************************************************************/
+
+static int fat_restorelock(FAR struct fat_mountpt_s *fs,
+                           unsigned int locked)
+{
+  int ret;
+
+  ret = nxmutex_restorelock(&fs->fs_lock, locked);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to retake the volume lock: %d\n", ret);
+      return ret;
+    }
+
+  fs->fs_nbusy--;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_open
  ****************************************************************************/
@@ -359,6 +469,9 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
   ff->ff_currentcluster   = ff->ff_startcluster;
   ff->ff_sectorsincluster = fs->fs_fatsecperclus;
   ff->ff_size             = DIR_GETFILESIZE(direntry);
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  nxrmutex_init(&ff->ff_lock);
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -474,6 +587,9 @@ static int fat_close(FAR struct file *filep)
 
   /* Then free the file structure itself. */
 
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  nxrmutex_destroy(&ff->ff_lock);
+#endif
   fs_heap_free(ff);
   filep->f_priv = NULL;
   return ret;
@@ -618,8 +734,27 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
       cluster = ff->ff_startcluster;
       num_traversed = 1;
+      fat_chaincache_add(ff, 0, cluster);
     }
 
+#if CONFIG_FAT_CLUSTER_CACHE > 0
+  /* Skip ahead to the nearest cached cluster if that is closer */
+
+  if (num_traversed > 0 && num_clu > 0 && new_num_clu > 0)
+    {
+      uint32_t cached;
+      int known;
+
+      known = fat_chaincache_lookup(ff, MIN(num_clu, new_num_clu) - 1,
+                                    &cached);
+      if (known > num_traversed)
+        {
+          cluster = cached;
+          num_traversed = known;
+        }
+    }
+#endif
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
@@ -630,8 +765,11 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
       if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
         {
+          fat_chaincache_reset(ff);
           return -EIO;
         }
+
+      fat_chaincache_add(ff, i, cluster);
     }
 
   if (read)
@@ -684,6 +822,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_chaincache_add(ff, i, cluster);
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -707,6 +847,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_chaincache_add(ff, i, cluster);
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -745,19 +887,23 @@ out:
 }
 
 /****************************************************************************
- * Name: fat_read
+ * Name: fat_read_locked
+ *
+ * Description:
+ *   Read from the current file position into a single user buffer.  The
+ *   caller must hold fat_lock() and must have verified the mount and the
+ *   file access mode.
+ *
  ****************************************************************************/
 
-static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+static ssize_t fat_read_locked(FAR struct file *filep,
+                               FAR uint8_t *userbuffer, size_t buflen)
 {
-  FAR struct inode *inode;
-  FAR struct fat_mountpt_s *fs;
-  FAR struct fat_file_s *ff;
+  FAR struct fat_mountpt_s *fs = filep->f_inode->i_private;
+  FAR struct fat_file_s *ff = filep->f_priv;
   unsigned int bytesread;
   unsigned int readsize;
   size_t bytesleft;
-  FAR uint8_t *userbuffer = (FAR uint8_t *)buffer;
   int sectorindex;
   int ret;
 
@@ -765,48 +911,10 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   unsigned int nsectors;
   bool force_indirect = false;
 #endif
-
-  /* Sanity checks */
-
-  DEBUGASSERT(filep->f_priv != NULL);
-
-  /* Recover our private data from the struct file instance */
-
-  ff = filep->f_priv;
-
-  /* Check for the forced mount condition */
-
-  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
-    {
-      return -EPIPE;
-    }
-
-  inode = filep->f_inode;
-  fs    = inode->i_private;
-
-  DEBUGASSERT(fs != NULL);
-
-  /* Make sure that the mount is still healthy */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  ret = fat_checkmount(fs);
-  if (ret != OK)
-    {
-      goto errout_with_lock;
-    }
-
-  /* Check if the file was opened with read access */
-
-  if ((ff->ff_oflags & O_RDOK) == 0)
-    {
-      ret = -EACCES;
-      goto errout_with_lock;
-    }
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  unsigned int locked;
+#endif
+  int lockret;
 
   /* Check that the file position is not past the end of the file */
 
@@ -814,8 +922,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
     {
       /* Return EOF */
 
-      ret = 0;
-      goto errout_with_lock;
+      return 0;
     }
   else
     {
@@ -848,7 +955,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
       ret = fat_get_sectors(filep, true);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
 
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
@@ -883,9 +990,19 @@ fat_read_restart:
 
           fat_ffcacheinvalidate(fs, ff);
 
-          /* Read all of the sectors directly into user memory */
+          /* Read all of the sectors directly into user memory.  Only the
+           * file is accessed here, so other files may use the volume
+           * meanwhile.
+           */
 
+          fat_breaklock(fs, &locked);
           ret = fat_hwread(fs, userbuffer, ff->ff_currentsector, nsectors);
+          lockret = fat_restorelock(fs, locked);
+          if (lockret < 0)
+            {
+              return lockret;
+            }
+
           if (ret < 0)
             {
 #ifdef CONFIG_FAT_DIRECT_RETRY
@@ -906,7 +1023,7 @@ fat_read_restart:
                 }
 #endif /* CONFIG_FAT_DIRECT_RETRY */
 
-              goto errout_with_lock;
+              return ret;
             }
 
           ff->ff_sectorsincluster -= nsectors;
@@ -922,10 +1039,17 @@ fat_read_restart:
            * it is already there then all is well.
            */
 
+          fat_breaklock(fs, &locked);
           ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
+          lockret = fat_restorelock(fs, locked);
+          if (lockret < 0)
+            {
+              return lockret;
+            }
+
           if (ret < 0)
             {
-              goto errout_with_lock;
+              return ret;
             }
 
           /* Copy the requested part of the sector into the user buffer */
@@ -957,34 +1081,22 @@ fat_read_restart:
       sectorindex   = filep->f_pos & SEC_NDXMASK(fs);
     }
 
-  nxmutex_unlock(&fs->fs_lock);
   return readsize;
-
-errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
-  return ret;
 }
 
 /****************************************************************************
- * Name: fat_write
+ * Name: fat_read
  ****************************************************************************/
 
-static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
 {
   FAR struct inode *inode;
   FAR struct fat_mountpt_s *fs;
   FAR struct fat_file_s *ff;
-  unsigned int byteswritten;
-  unsigned int writesize;
-  FAR uint8_t *userbuffer = (FAR uint8_t *)buffer;
-  int sectorindex;
-  int ret;
+  ssize_t ret;
 
-#ifndef CONFIG_FAT_FORCE_INDIRECT
-  unsigned int nsectors;
-  bool force_indirect = false;
-#endif
+  /* Sanity checks */
 
   DEBUGASSERT(filep->f_priv != NULL);
 
@@ -1006,7 +1118,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Make sure that the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, ff);
   if (ret < 0)
     {
       return ret;
@@ -1018,20 +1130,138 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
-  /* Check if the file was opened for write access */
+  /* Check if the file was opened with read access */
 
-  if ((ff->ff_oflags & O_WROK) == 0)
+  if ((ff->ff_oflags & O_RDOK) == 0)
     {
       ret = -EACCES;
       goto errout_with_lock;
     }
 
+  ret = fat_read_locked(filep, (FAR uint8_t *)buffer, buflen);
+
+errout_with_lock:
+  fat_unlock(fs, ff);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_readv
+ *
+ * Description:
+ *   Scatter read.  The whole vector is transferred under a single
+ *   fat_lock() so that it is atomic with respect to other users of the
+ *   file, and so that consecutive elements continue from the sector
+ *   cache and the cluster position left by the previous one.  Aligned,
+ *   sector-multiple elements are still read directly into user memory.
+ *
+ ****************************************************************************/
+
+static ssize_t fat_readv(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  ssize_t ntotal = 0;
+  ssize_t nread;
+  int ret;
+  int i;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  ff = filep->f_priv;
+  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  fs = filep->f_inode->i_private;
+  DEBUGASSERT(fs != NULL);
+
+  ret = fat_lock(fs, ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  if ((ff->ff_oflags & O_RDOK) == 0)
+    {
+      ret = -EACCES;
+      goto errout_with_lock;
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = fat_read_locked(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = nread;
+            }
+
+          break;
+        }
+
+      ntotal += nread;
+
+      /* Stop at end-of-file */
+
+      if (nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  fat_unlock(fs, ff);
+  return ntotal;
+
+errout_with_lock:
+  fat_unlock(fs, ff);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_write_locked
+ *
+ * Description:
+ *   Write a single user buffer at the current file position.  The caller
+ *   must hold fat_lock() and must have verified the mount and the file
+ *   access mode.
+ *
+ ****************************************************************************/
+
+static ssize_t fat_write_locked(FAR struct file *filep,
+                                FAR uint8_t *userbuffer, size_t buflen)
+{
+  FAR struct fat_mountpt_s *fs = filep->f_inode->i_private;
+  FAR struct fat_file_s *ff = filep->f_priv;
+  unsigned int byteswritten;
+  unsigned int writesize;
+  int sectorindex;
+  int ret;
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+  unsigned int nsectors;
+  bool force_indirect = false;
+#endif
+
   /* Check if the file size would exceed the range of off_t */
 
   if (buflen > OFF_MAX || ff->ff_size > OFF_MAX - (off_t)buflen)
     {
-      ret = -EFBIG;
-      goto errout_with_lock;
+      return -EFBIG;
     }
 
   /* Loop until either (1) all data has been transferred, or (2) an
@@ -1047,7 +1277,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       ret = fat_get_sectors(filep, false);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
 
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
@@ -1105,7 +1335,7 @@ fat_write_restart:
                 }
 #endif /* CONFIG_FAT_DIRECT_RETRY */
 
-              goto errout_with_lock;
+              return ret;
             }
 
           ff->ff_sectorsincluster -= nsectors;
@@ -1139,7 +1369,7 @@ fat_write_restart:
               ret = fat_ffcacheflush(fs, ff);
               if (ret < 0)
                 {
-                  goto errout_with_lock;
+                  return ret;
                 }
 
               /* Now mark the clean cache buffer as the current sector. */
@@ -1155,7 +1385,7 @@ fat_write_restart:
               ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
               if (ret < 0)
                 {
-                  goto errout_with_lock;
+                  return ret;
                 }
             }
 
@@ -1205,11 +1435,145 @@ fat_write_restart:
         }
     }
 
-  nxmutex_unlock(&fs->fs_lock);
   return byteswritten;
+}
+
+/****************************************************************************
+ * Name: fat_write
+ ****************************************************************************/
+
+static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  FAR struct inode *inode;
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  ssize_t ret;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  ff = filep->f_priv;
+
+  /* Check for the forced mount condition */
+
+  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  inode = filep->f_inode;
+  fs    = inode->i_private;
+
+  DEBUGASSERT(fs != NULL);
+
+  /* Make sure that the mount is still healthy */
+
+  ret = fat_lock(fs, ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Check if the file was opened for write access */
+
+  if ((ff->ff_oflags & O_WROK) == 0)
+    {
+      ret = -EACCES;
+      goto errout_with_lock;
+    }
+
+  ret = fat_write_locked(filep, (FAR uint8_t *)buffer, buflen);
 
 errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_writev
+ *
+ * Description:
+ *   Gather write.  As with fat_readv(), the whole vector is written under a
+ *   single fat_lock().  A small header followed by a payload therefore
+ *   shares one sector cache fill and the payload's aligned middle goes out
+ *   as one multi-sector transfer, instead of each element re-validating
+ *   the mount and re-walking the cluster chain.
+ *
+ ****************************************************************************/
+
+static ssize_t fat_writev(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  ssize_t ntotal = 0;
+  ssize_t nwritten;
+  int ret;
+  int i;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  ff = filep->f_priv;
+  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  fs = filep->f_inode->i_private;
+  DEBUGASSERT(fs != NULL);
+
+  ret = fat_lock(fs, ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  if ((ff->ff_oflags & O_WROK) == 0)
+    {
+      ret = -EACCES;
+      goto errout_with_lock;
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nwritten = fat_write_locked(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nwritten < 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = nwritten;
+            }
+
+          break;
+        }
+
+      ntotal += nwritten;
+    }
+
+  fat_unlock(fs, ff);
+  return ntotal;
+
+errout_with_lock:
+  fat_unlock(fs, ff);
   return ret;
 }
 
@@ -1293,7 +1657,7 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Make sure that the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, ff);
   if (ret < 0)
     {
       return ret;
@@ -1315,11 +1679,11 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
   filep->f_pos = position;
 
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
   return position;
 
 errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
   return ret;
 }
 
@@ -1749,7 +2113,7 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Make sure that the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, ff);
   if (ret < 0)
     {
       return ret;
@@ -1758,7 +2122,7 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   ret = fat_checkmount(fs);
   if (ret != OK)
     {
-      nxmutex_unlock(&fs->fs_lock);
+      fat_unlock(fs, ff);
       return ret;
     }
 
@@ -1773,7 +2137,7 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = fat_getfilepath(fs, ff, path, PATH_MAX);
             }
 
-          nxmutex_unlock(&fs->fs_lock);
+          fat_unlock(fs, ff);
           return ret;
         }
 
@@ -1783,7 +2147,7 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* ioctl calls are just passed through to the contained block driver */
 
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
   return -ENOTTY;
 }
 
@@ -1825,7 +2189,7 @@ static int fat_sync(FAR struct file *filep)
 
   /* Make sure that the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, ff);
   if (ret < 0)
     {
       return ret;
@@ -1906,7 +2270,7 @@ static int fat_sync(FAR struct file *filep)
     }
 
 errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
   return ret;
 }
 
@@ -1951,7 +2315,7 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   /* Check if the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, oldff);
   if (ret < 0)
     {
       return ret;
@@ -2012,6 +2376,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#if CONFIG_FAT_CLUSTER_CACHE > 0
+  newff->ff_nextents         = oldff->ff_nextents;         /* Cluster chain cache */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -2023,10 +2391,14 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
    * (but a simple reference count could have done that).
    */
 
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  nxrmutex_init(&newff->ff_lock);
+#endif
+
   newff->ff_next = fs->fs_head;
   fs->fs_head = newff;
 
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, oldff);
   return OK;
 
   /* Error exits -- goto's are nasty things, but they sure can make error
@@ -2037,7 +2409,7 @@ errout_with_struct:
   fs_heap_free(newff);
 
 errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, oldff);
   return ret;
 }
 
@@ -2192,9 +2564,13 @@ static int fat_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   DEBUGASSERT(fs != NULL);
 
+  /* Recover our private data from the struct file instance */
+
+  ff = filep->f_priv;
+
   /* Check if the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, ff);
   if (ret < 0)
     {
       return ret;
@@ -2206,10 +2582,6 @@ static int fat_fstat(FAR const struct file *filep, FAR struct stat *buf)
       goto errout_with_lock;
     }
 
-  /* Recover our private data from the struct file instance */
-
-  ff = filep->f_priv;
-
   /* Update the directory entry.  First read the directory
    * entry into the fs_buffer (preserving the ff_buffer)
    */
@@ -2234,7 +2606,7 @@ static int fat_fstat(FAR const struct file *filep, FAR struct stat *buf)
   ret = fat_stat_file(fs, direntry, buf);
 
 errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
   return ret;
 }
 
@@ -2275,7 +2647,7 @@ static int fat_truncate(FAR struct file *filep, off_t length)
 
   /* Make sure that the mount is still healthy */
 
-  ret = nxmutex_lock(&fs->fs_lock);
+  ret = fat_lock(fs, ff);
   if (ret < 0)
     {
       return ret;
@@ -2309,6 +2681,10 @@ static int fat_truncate(FAR struct file *filep, off_t length)
       FAR uint8_t *direntry;
       int ndx;
 
+      /* The tail of the cluster chain is about to be released */
+
+      fat_chaincache_reset(ff);
+
       /* We are shrinking the file.
        *
        * Read the directory entry into the fs_buffer.
@@ -2374,7 +2750,7 @@ static int fat_truncate(FAR struct file *filep, off_t length)
     }
 
 errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
+  fat_unlock(fs, ff);
   return ret;
 }
 
@@ -2713,6 +3089,16 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
        * the 'lazy' unmount, could be implemented to fix this.
        */
 
+#ifdef CONFIG_FAT_PERFILE_LOCK
+      if (fs->fs_nbusy > 0)
+        {
+          /* File data is being transferred without the volume lock */
+
+          nxmutex_unlock(&fs->fs_lock);
+          return -EBUSY;
+        }
+#endif
+
       if ((flags & MNT_FORCE) != 0)
         {
           FAR struct fat_file_s *ff;
@@ -2766,6 +3152,7 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Release the mountpoint private data */
 
+  fat_freemap_release(fs);
   if (fs->fs_buffer)
     {
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
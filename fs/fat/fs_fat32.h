@@ -862,6 +862,17 @@
  * is mounted with a fat32 filesystem.
  */
 
+#if CONFIG_FAT_CLUSTER_CACHE > 0
+/* A run of physically contiguous clusters in a file's cluster chain */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* First cluster number on the media */
+  uint32_t fe_count;               /* Number of contiguous clusters */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -891,6 +902,15 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEBITMAP
+  FAR uint32_t *fs_freemap;        /* Bitmap of free clusters (bit set = free),
+                                    * bit 0 is cluster 2.  NULL if not built */
+  bool     fs_nofreemap;           /* true: The bitmap could not be allocated,
+                                    * search the FAT linearly */
+#endif
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  unsigned int fs_nbusy;           /* Data transfers running without fs_lock */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -913,6 +933,13 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_CLUSTER_CACHE > 0
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+  struct fat_extent_s ff_extents[CONFIG_FAT_CLUSTER_CACHE]; /* Sorted by index */
+#endif
+#ifdef CONFIG_FAT_PERFILE_LOCK
+  rmutex_t ff_lock;                /* Serializes access to this open file */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1055,6 +1082,29 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Per-file cluster chain extent cache */
+
+#if CONFIG_FAT_CLUSTER_CACHE > 0
+EXTERN uint32_t fat_chaincache_lookup(FAR struct fat_file_s *ff,
+                                      uint32_t index,
+                                      FAR uint32_t *cluster);
+EXTERN void   fat_chaincache_add(FAR struct fat_file_s *ff, uint32_t index,
+                                 uint32_t cluster);
+#  define fat_chaincache_reset(ff) ((ff)->ff_nextents = 0)
+#else
+#  define fat_chaincache_lookup(ff, i, c) (0)
+#  define fat_chaincache_add(ff, i, c)
+#  define fat_chaincache_reset(ff)
+#endif
+
+/* Free-cluster bitmap */
+
+#ifdef CONFIG_FAT_FREEBITMAP
+EXTERN void   fat_freemap_release(FAR struct fat_mountpt_s *fs);
+#else
+#  define fat_freemap_release(fs)
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
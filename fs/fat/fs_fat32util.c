@@ -32,6 +32,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -43,6 +44,7 @@
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
+#include "fs_heap.h"
 
 /****************************************************************************
  * Private Functions
@@ -270,6 +272,177 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemap_update
+ *
+ * Description:
+ *   Track a FAT entry update in the free-cluster bitmap (if present).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEBITMAP
+static void fat_freemap_update(FAR struct fat_mountpt_s *fs,
+                               uint32_t clusterno, off_t nextcluster)
+{
+  uint32_t bit;
+
+  if (fs->fs_freemap != NULL && clusterno >= 2)
+    {
+      bit = clusterno - 2;
+      if (nextcluster == 0)
+        {
+          fs->fs_freemap[bit >> 5] |= (uint32_t)1 << (bit & 31);
+        }
+      else
+        {
+          fs->fs_freemap[bit >> 5] &= ~((uint32_t)1 << (bit & 31));
+        }
+    }
+}
+#else
+#  define fat_freemap_update(fs, c, n)
+#endif
+
+/****************************************************************************
+ * Name: fat_freemap_search
+ *
+ * Description:
+ *   Return the index of the first set bit of the free-cluster bitmap in
+ *   the range [first, last), or UINT32_MAX if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEBITMAP
+static uint32_t fat_freemap_search(FAR struct fat_mountpt_s *fs,
+                                   uint32_t first, uint32_t last)
+{
+  uint32_t word;
+  uint32_t bit;
+
+  while (first < last)
+    {
+      word = fs->fs_freemap[first >> 5] & (UINT32_MAX << (first & 31));
+      if (word != 0)
+        {
+          bit = (first & ~31) + ffs(word) - 1;
+          return bit < last ? bit : UINT32_MAX;
+        }
+
+      first = (first & ~31) + 32;
+    }
+
+  return UINT32_MAX;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfreecluster
+ *
+ * Description:
+ *   Find a free cluster, searching forward from the cluster following
+ *   'startcluster' and wrapping around at the end of the volume.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: a free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfreecluster(FAR struct fat_mountpt_s *fs,
+                                   uint32_t startcluster)
+{
+  uint32_t newcluster;
+  off_t    startsector;
+
+#ifdef CONFIG_FAT_FREEBITMAP
+  if (fs->fs_freemap == NULL && !fs->fs_nofreemap)
+    {
+      /* Build the bitmap now.  If it cannot be allocated, fall back to
+       * the linear search below, and keep doing so rather than rescanning
+       * the whole FAT on every allocation.
+       */
+
+      int ret = fat_computefreeclusters(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (fs->fs_freemap != NULL)
+    {
+      uint32_t bit;
+
+      /* Search after the start cluster first, then wrap to the beginning */
+
+      bit = fat_freemap_search(fs, startcluster - 1, fs->fs_nclusters);
+      if (bit == UINT32_MAX)
+        {
+          bit = fat_freemap_search(fs, 0, startcluster - 1);
+        }
+
+      return bit == UINT32_MAX ? 0 : (int32_t)(bit + 2);
+    }
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -658,6 +831,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+  fat_freemap_release(fs);
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -1103,6 +1277,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+      fat_freemap_update(fs, clusterno, nextcluster);
       return OK;
     }
 
@@ -1226,66 +1401,20 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+  /* Find a free cluster, starting the search after 'startcluster' */
 
-  newcluster = startcluster;
-  for (; ; )
+  ret = fat_findfreecluster(fs, startcluster);
+  if (ret <= 0)
     {
-      /* Examine the next cluster in the FAT */
+      /* An error occurred or there are no free clusters */
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return ret;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  newcluster = ret;
+
+  /* We have an available cluster number in 'newcluster'.  Now mark that
+   * cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -1323,6 +1452,119 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_chaincache_lookup
+ *
+ * Description:
+ *   Find the cluster with file index 'index' in the extent cache of 'ff',
+ *   or else the known cluster nearest before it.
+ *
+ * Returned Value:
+ *   Zero if no cluster at or before 'index' is cached.  Otherwise, the
+ *   file index of the returned cluster plus one (i.e. the number of
+ *   clusters of the chain that need not be walked); the cluster number
+ *   itself is returned in 'cluster'.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_CLUSTER_CACHE > 0
+uint32_t fat_chaincache_lookup(FAR struct fat_file_s *ff, uint32_t index,
+                               FAR uint32_t *cluster)
+{
+  FAR struct fat_extent_s *fe = NULL;
+  uint32_t offset;
+  int i;
+
+  /* Find the last extent starting at or before 'index' */
+
+  for (i = 0; i < ff->ff_nextents && ff->ff_extents[i].fe_index <= index;
+       i++)
+    {
+      fe = &ff->ff_extents[i];
+    }
+
+  if (fe == NULL)
+    {
+      return 0;
+    }
+
+  offset = index - fe->fe_index;
+  if (offset >= fe->fe_count)
+    {
+      offset = fe->fe_count - 1;
+    }
+
+  *cluster = fe->fe_cluster + offset;
+  return fe->fe_index + offset + 1;
+}
+
+/****************************************************************************
+ * Name: fat_chaincache_add
+ *
+ * Description:
+ *   Record that the cluster with file index 'index' is 'cluster'.  The
+ *   entry is merged into an adjacent extent when contiguous on the media.
+ *   When the cache is full, the extent with the highest file index is
+ *   replaced so that the beginning of the chain stays cached.
+ *
+ ****************************************************************************/
+
+void fat_chaincache_add(FAR struct fat_file_s *ff, uint32_t index,
+                        uint32_t cluster)
+{
+  FAR struct fat_extent_s *fe;
+  int i;
+
+  /* Find the insertion point: the first extent starting after 'index' */
+
+  for (i = 0; i < ff->ff_nextents && ff->ff_extents[i].fe_index <= index;
+       i++)
+    {
+    }
+
+  if (i > 0)
+    {
+      fe = &ff->ff_extents[i - 1];
+
+      /* Already known? */
+
+      if (index < fe->fe_index + fe->fe_count)
+        {
+          return;
+        }
+
+      /* Does it extend the previous extent? */
+
+      if (index == fe->fe_index + fe->fe_count &&
+          cluster == fe->fe_cluster + fe->fe_count &&
+          (i == ff->ff_nextents || ff->ff_extents[i].fe_index > index))
+        {
+          fe->fe_count++;
+          return;
+        }
+    }
+
+  if (ff->ff_nextents == CONFIG_FAT_CLUSTER_CACHE)
+    {
+      if (i == ff->ff_nextents)
+        {
+          i--;
+        }
+
+      ff->ff_nextents--;
+    }
+
+  memmove(&ff->ff_extents[i + 1], &ff->ff_extents[i],
+          (ff->ff_nextents - i) * sizeof(struct fat_extent_s));
+
+  fe             = &ff->ff_extents[i];
+  fe->fe_index   = index;
+  fe->fe_cluster = cluster;
+  fe->fe_count   = 1;
+  ff->ff_nextents++;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -2038,37 +2280,56 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   /* We have to count the number of free clusters */
 
   uint32_t nfreeclusters = 0;
-  if (fs->fs_type == FSTYPE_FAT12)
+  uint32_t cluster;
+
+#ifdef CONFIG_FAT_FREEBITMAP
+  /* Build the free-cluster bitmap while we are scanning the FAT anyway */
+
+  size_t mapsize = ((fs->fs_nclusters + 31) >> 5) * sizeof(uint32_t);
+
+  if (fs->fs_freemap == NULL)
     {
-      off_t sector;
+      fs->fs_freemap = fs_heap_malloc(mapsize);
+    }
 
+  fs->fs_nofreemap = fs->fs_freemap == NULL;
+
+  if (fs->fs_freemap != NULL)
+    {
+      memset(fs->fs_freemap, 0, mapsize);
+    }
+#endif
+
+  if (fs->fs_type == FSTYPE_FAT12)
+    {
       /* Examine every cluster in the fat */
 
-      for (sector = 2; sector < fs->fs_nclusters + 2; sector++)
+      for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
         {
           /* If the cluster is unassigned, then increment the count of free
            * clusters
            */
 
-          if ((uint16_t)fat_getcluster(fs, sector) == 0)
+          if ((uint16_t)fat_getcluster(fs, cluster) == 0)
             {
+              fat_freemap_update(fs, cluster, 0);
               nfreeclusters++;
             }
         }
     }
   else
     {
-      unsigned int cluster;
       off_t        fatsector;
       unsigned int offset;
+      uint32_t     next;
       int          ret;
 
       fatsector    = fs->fs_fatbase;
       offset       = fs->fs_hwsectorsize;
 
-      /* Examine each cluster in the fat */
+      /* Examine each entry in the fat.  Entries 0 and 1 are reserved. */
 
-      for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
+      for (cluster = 0; cluster < fs->fs_nclusters + 2; cluster++)
         {
           /* If we are starting a new sector, then read the new sector in
            * fs_buffer
@@ -2079,6 +2340,9 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
               ret = fat_fscacheread(fs, fatsector);
               if (ret < 0)
                 {
+                  /* Do not keep a partly built bitmap */
+
+                  fat_freemap_release(fs);
                   return ret;
                 }
 
@@ -2096,22 +2360,20 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
 
           if (fs->fs_type == FSTYPE_FAT16)
             {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              next    = FAT_GETFAT16(fs->fs_buffer, offset);
               offset += 2;
             }
           else
             {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              next    = FAT_GETFAT32(fs->fs_buffer, offset) & 0x0fffffff;
               offset += 4;
             }
+
+          if (cluster >= 2 && next == 0)
+            {
+              fat_freemap_update(fs, cluster, 0);
+              nfreeclusters++;
+            }
         }
     }
 
@@ -2124,6 +2386,25 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemap_release
+ *
+ * Description:
+ *   Free the free-cluster bitmap.  It is rebuilt on demand.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEBITMAP
+void fat_freemap_release(FAR struct fat_mountpt_s *fs)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      fs_heap_free(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nfreeclusters
  *
@@ -39,6 +39,7 @@
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/uio.h>
 
 #include "inode/inode.h"
 #include "littlefs/lfs.h"
@@ -114,6 +115,8 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen);
 static ssize_t littlefs_write(FAR struct file *filep, FAR const char *buffer,
                               size_t buflen);
+static ssize_t littlefs_readv(FAR struct file *filep, FAR struct uio *uio);
+static ssize_t littlefs_writev(FAR struct file *filep, FAR struct uio *uio);
 static off_t   littlefs_seek(FAR struct file *filep, off_t offset,
                              int whence);
 static int     littlefs_ioctl(FAR struct file *filep, int cmd,
@@ -184,8 +187,8 @@ const struct mountpt_operations g_littlefs_operations =
   NULL,                   /* mmap */
   littlefs_truncate,      /* truncate */
   NULL,                   /* poll */
-  NULL,                   /* readv */
-  NULL,                   /* writev */
+  littlefs_readv,         /* readv */
+  littlefs_writev,        /* writev */
 
   littlefs_sync,          /* sync */
   littlefs_dup,           /* dup */
@@ -608,6 +611,152 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_readv
+ *
+ * Description:
+ *   Read into every element of the vector under a single hold of the mount
+ *   lock, so the transfer is atomic and LFS can keep serving the elements
+ *   from its file cache without re-seeking between them.
+ *
+ ****************************************************************************/
+
+static ssize_t littlefs_readv(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct littlefs_mountpt_s *fs;
+  FAR struct littlefs_file_s *priv;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  priv = filep->f_priv;
+  fs   = filep->f_inode->i_private;
+
+  ret = nxmutex_lock(&fs->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_pos != priv->file.pos)
+    {
+      ret = littlefs_convert_result(lfs_file_seek(&fs->lfs, &priv->file,
+                                                  filep->f_pos,
+                                                  LFS_SEEK_SET));
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = littlefs_convert_result(lfs_file_read(&fs->lfs, &priv->file,
+                                                  iov[i].iov_base,
+                                                  iov[i].iov_len));
+      if (ret < 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      if (ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  if (ntotal > 0 || ret >= 0)
+    {
+      ret = ntotal;
+    }
+
+out:
+  nxmutex_unlock(&fs->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_writev
+ *
+ * Description:
+ *   Gather write.  All elements are handed to LFS under a single hold of
+ *   the mount lock, so a small header and its payload are merged in the
+ *   LFS program cache rather than being committed as separate writes.
+ *
+ ****************************************************************************/
+
+static ssize_t littlefs_writev(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct littlefs_mountpt_s *fs;
+  FAR struct littlefs_file_s *priv;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  priv = filep->f_priv;
+  fs   = filep->f_inode->i_private;
+
+  ret = nxmutex_lock(&fs->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_pos != priv->file.pos)
+    {
+      ret = littlefs_convert_result(lfs_file_seek(&fs->lfs, &priv->file,
+                                                  filep->f_pos,
+                                                  LFS_SEEK_SET));
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = littlefs_convert_result(lfs_file_write(&fs->lfs, &priv->file,
+                                                   iov[i].iov_base,
+                                                   iov[i].iov_len));
+      if (ret < 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      if (ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  if (ntotal > 0 || ret >= 0)
+    {
+      ret = ntotal;
+    }
+
+out:
+  nxmutex_unlock(&fs->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_seek
  ****************************************************************************/
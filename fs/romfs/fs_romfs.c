@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sys/statfs.h>
+#include <sys/uio.h>
 #include <sys/stat.h>
 
 #include <stdlib.h>
@@ -73,6 +74,7 @@ static int     romfs_open(FAR struct file *filep, FAR const char *relpath,
 static int     romfs_close(FAR struct file *filep);
 static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen);
+static ssize_t romfs_readv(FAR struct file *filep, FAR struct uio *uio);
 static off_t   romfs_seek(FAR struct file *filep, off_t offset, int whence);
 static int     romfs_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
@@ -127,7 +129,7 @@ const struct mountpt_operations g_romfs_operations =
   romfs_mmap,      /* mmap */
   NULL,            /* truncate */
   NULL,            /* poll */
-  NULL,            /* readv */
+  romfs_readv,     /* readv */
   NULL,            /* writev */
 
   NULL,            /* sync */
@@ -499,6 +501,63 @@ errout_with_lock:
   return readsize ? readsize : ret;
 }
 
+/****************************************************************************
+ * Name: romfs_readv
+ *
+ * Description:
+ *   Scatter read.  rm_lock is recursive, so hold it across the whole
+ *   vector and let romfs_read() fill each element; consecutive small
+ *   elements are then served from the same cached sectors.
+ *
+ ****************************************************************************/
+
+static ssize_t romfs_readv(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  FAR struct romfs_mountpt_s *rm;
+  ssize_t ntotal = 0;
+  ssize_t nread;
+  int ret;
+  int i;
+
+  rm = filep->f_inode->i_private;
+  DEBUGASSERT(rm != NULL);
+
+  ret = nxrmutex_lock(&rm->rm_lock);
+  if (ret < 0)
+    {
+      return (ssize_t)ret;
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = romfs_read(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = nread;
+            }
+
+          break;
+        }
+
+      ntotal += nread;
+      if (nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxrmutex_unlock(&rm->rm_lock);
+  return ntotal;
+}
+
 /****************************************************************************
  * Name: romfs_seek
  ****************************************************************************/
@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/tls.h>
 
 #include "inode/inode.h"
@@ -54,8 +55,9 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         ready;    /* Link in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     notified; /* Notified since the last setup */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -90,6 +92,15 @@ struct epoll_head_s
                                    * first node, used to free the malloced
                                    * memory in epoll_do_close().
                                    */
+  struct list_node      ready;    /* The ready list, the poll callback adds
+                                   * the notified nodes of the setup list
+                                   * here once, so epoll_wait() only looks at
+                                   * those instead of every setup node.
+                                   */
+  spinlock_t            readylock; /* Protect the ready list, the poll
+                                    * callback may run in interrupt
+                                    * context.
+                                    */
 };
 
 typedef struct epoll_head_s epoll_head_t;
@@ -260,6 +271,8 @@ static int epoll_do_create(int size, int flags)
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
+  list_initialize(&eph->ready);
+  spin_lock_init(&eph->readylock);
   for (i = 0; i < size; i++)
     {
       list_add_tail(&eph->free, &epn[i].node);
@@ -331,12 +344,35 @@ static int epoll_setup(FAR epoll_head_t *eph)
   return ret;
 }
 
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a node from the ready list.  The poll of the node must have been
+ *   torn down.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->readylock);
+  if (list_in_list(&epn->ready))
+    {
+      list_delete(&epn->ready);
+    }
+
+  epn->notified = false;
+  spin_unlock_irqrestore(&eph->readylock, flags);
+}
+
 /****************************************************************************
  * Name: epoll_teardown
  *
  * Description:
  *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   expected event.  Only the nodes of the ready list are visited.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -352,23 +388,28 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
+  FAR struct list_node *ready;
   FAR epoll_node_t *epn;
+  irqstate_t flags;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  for (; ; )
     {
-      /* Only check the notified fd */
+      flags = spin_lock_irqsave(&eph->readylock);
+      ready = list_remove_head(&eph->ready);
+      spin_unlock_irqrestore(&eph->readylock, flags);
 
-      if (!epn->notified)
+      if (ready == NULL)
         {
-          continue;
+          break;
         }
 
       /* Teradown all the notified fd */
 
+      epn = container_of(ready, epoll_node_t, ready);
+
       file_poll(epn->filep, &epn->pfd, false);
       list_delete(&epn->node);
 
@@ -426,9 +467,21 @@ static void epoll_cleanup(FAR void *arg)
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
+  /* Queue the node to the ready list, only once until it is set up again */
+
+  flags = spin_lock_irqsave(&eph->readylock);
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->ready);
+    }
+
+  spin_unlock_irqrestore(&eph->readylock, flags);
+
   if (fds->revents != 0)
     {
       nxsem_get_value(&epn->eph->sem, &semcount);
@@ -529,6 +582,15 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
       case EPOLL_CTL_ADD:
         finfo("%p CTL ADD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
 
+        /* An exclusive wake up can't be combined with EPOLLONESHOT */
+
+        if ((ev->events & (EPOLLEXCLUSIVE | EPOLLONESHOT)) ==
+            (EPOLLEXCLUSIVE | EPOLLONESHOT))
+          {
+            ret = -EINVAL;
+            goto err;
+          }
+
         /* Check repetition */
 
         list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
@@ -602,6 +664,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         ret = file_poll(epn->filep, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             file_put(epn->filep);
             list_add_tail(&eph->free, &epn->node);
             goto err;
@@ -617,6 +680,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 file_poll(epn->filep, &epn->pfd, false);
+                epoll_unready(eph, epn);
                 file_put(epn->filep);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
@@ -650,15 +714,30 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
+
+        /* EPOLLEXCLUSIVE can only be set by EPOLL_CTL_ADD */
+
+        if ((ev->events & EPOLLEXCLUSIVE) != 0)
+          {
+            ret = -EINVAL;
+            goto err;
+          }
+
         list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
               {
+                if ((epn->pfd.events & EPOLLEXCLUSIVE) != 0)
+                  {
+                    ret = -EINVAL;
+                    goto err;
+                  }
+
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     file_poll(epn->filep, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
-                    epn->notified    = false;
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
                     epn->pfd.revents = 0;
@@ -678,6 +757,12 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
+                if ((epn->pfd.events & EPOLLEXCLUSIVE) != 0)
+                  {
+                    ret = -EINVAL;
+                    goto err;
+                  }
+
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     epn->notified    = false;
@@ -40,41 +40,27 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: fstatfs
+ * Name: file_fstatfs
  *
- * Returned Value:
- *   Zero on success; -1 on failure with errno set:
+ * Description:
+ *   file_fstatfs() is an internal OS interface.  It is functionally similar
+ *   to the standard fstatfs() interface except that it does not modify the
+ *   errno variable and it accepts a file structure instance instead of a
+ *   file descriptor.
  *
- *   EACCES  Search permission is denied for one of the directories in the
- *           path prefix of path.
- *   EFAULT  Bad address.
- *   ENOENT  A component of the path path does not exist, or the path is an
- *           empty string.
- *   ENOMEM  Out of memory
- *   ENOTDIR A component of the path is not a directory.
- *   ENOSYS  The file system does not support this call.
+ * Returned Value:
+ *   Zero is returned on success; a negated value is returned on any failure.
  *
  ****************************************************************************/
 
-int fstatfs(int fd, FAR struct statfs *buf)
+int file_fstatfs(FAR struct file *filep, FAR struct statfs *buf)
 {
-  FAR struct file *filep;
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   FAR struct inode *inode;
 #endif
   int ret;
 
-  DEBUGASSERT(buf != NULL);
-
-  /* First, get the file structure.  Note that on failure,
-   * file_get() will return the errno.
-   */
-
-  ret = file_get(fd, &filep);
-  if (ret < 0)
-    {
-      goto errout;
-    }
+  DEBUGASSERT(filep != NULL && buf != NULL);
 
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   /* Get the inode from the file structure */
@@ -111,6 +97,45 @@ int fstatfs(int fd, FAR struct statfs *buf)
       ret            = OK;
     }
 
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: fstatfs
+ *
+ * Returned Value:
+ *   Zero on success; -1 on failure with errno set:
+ *
+ *   EACCES  Search permission is denied for one of the directories in the
+ *           path prefix of path.
+ *   EFAULT  Bad address.
+ *   ENOENT  A component of the path path does not exist, or the path is an
+ *           empty string.
+ *   ENOMEM  Out of memory
+ *   ENOTDIR A component of the path is not a directory.
+ *   ENOSYS  The file system does not support this call.
+ *
+ ****************************************************************************/
+
+int fstatfs(int fd, FAR struct statfs *buf)
+{
+  FAR struct file *filep;
+  int ret;
+
+  DEBUGASSERT(buf != NULL);
+
+  /* First, get the file structure.  Note that on failure,
+   * file_get() will return the errno.
+   */
+
+  ret = file_get(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_fstatfs(filep, buf);
+
   /* Check if the fstat operation was successful */
 
   file_put(filep);
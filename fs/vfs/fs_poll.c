@@ -255,7 +255,8 @@ void poll_default_cb(FAR struct pollfd *fds)
  *
  * Description:
  *   Notify the poll, this function should be called by drivers to notify
- *   the caller the poll is ready.
+ *   the caller the poll is ready.  Of the fds with POLLEXCLUSIVE in the
+ *   array, only the first one that gets an event is notified.
  *
  * Input Parameters:
  *   afds     - The fds array
@@ -270,6 +271,7 @@ void poll_default_cb(FAR struct pollfd *fds)
 noinstrument_function
 void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
 {
+  bool exclusive = false;
   int i;
   FAR struct pollfd *fds;
 
@@ -280,6 +282,13 @@ void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
       fds = afds[i];
       if (fds != NULL)
         {
+          /* Only one of the exclusive waiters is woken up */
+
+          if (exclusive && (fds->events & POLLEXCLUSIVE) != 0)
+            {
+              continue;
+            }
+
           /* The error event must be set in fds->revents */
 
           fds->revents |= eventset & (fds->events | POLLERR | POLLHUP);
@@ -296,6 +305,11 @@ void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
               finfo("Report events: %08" PRIx32 "\n", fds->revents);
               fds->cb(fds);
             }
+
+          if ((fds->events & POLLEXCLUSIVE) != 0 && fds->revents != 0)
+            {
+              exclusive = true;
+            }
         }
     }
 }
@@ -27,11 +27,15 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <fcntl.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 #include "fs_heap.h"
@@ -40,40 +44,131 @@
  * Private Functions
  ****************************************************************************/
 
-static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
-                        FAR off_t *offset, size_t count)
+/****************************************************************************
+ * Name: copyxip
+ *
+ * Description:
+ *   Transfer data from a file of a read-only, memory-resident file system
+ *   (XIP romfs) straight out of the file's memory image, bypassing the
+ *   intermediate I/O buffer.  The memory image of a writable file system
+ *   (tmpfs) may be reallocated by a concurrent writer while file_write()
+ *   still reads from it, so such files are not handled here.  The file
+ *   position of infile is advanced by the number of bytes transferred.
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success.  -ENOTTY if the input file
+ *   has no usable memory image, in which case the caller should fall back
+ *   to copybuffer().
+ *
+ ****************************************************************************/
+
+static ssize_t copyxip(FAR struct file *outfile, FAR struct file *infile,
+                       size_t count)
 {
-  FAR uint8_t *iobuffer;
-  FAR uint8_t *wrbuffer;
-  off_t startpos = 0;
-  ssize_t nbytesread;
+  FAR const uint8_t *xipbase;
+  struct statfs fsbuf;
+  struct stat buf;
+  uintptr_t addr;
   ssize_t nbyteswritten;
-  size_t  ntransferred;
-  bool endxfr;
+  ssize_t ntransferred = 0;
+  off_t pos;
+  int ret;
 
-  /* Get the current file position. */
+  /* The memory image bypasses file_read(), check the access mode here */
 
-  if (offset)
+  if ((infile->f_oflags & O_RDOK) == 0)
     {
-      off_t newpos;
+      return -EBADF;
+    }
 
-      /* Use file_seek to get the current file position */
+  ret = file_fstatfs(infile, &fsbuf);
+  if (ret < 0 || fsbuf.f_type != ROMFS_MAGIC)
+    {
+      return -ENOTTY;
+    }
 
-      startpos = file_seek(infile, 0, SEEK_CUR);
-      if (startpos < 0)
+  ret = file_ioctl(infile, FIOC_XIPBASE, (unsigned long)((uintptr_t)&addr));
+  if (ret >= 0)
+    {
+      ret = file_fstat(infile, &buf);
+    }
+
+  if (ret < 0)
+    {
+      return -ENOTTY;
+    }
+
+  pos = file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return pos;
+    }
+
+  xipbase = (FAR const uint8_t *)addr;
+
+  while ((size_t)ntransferred < count && pos < buf.st_size)
+    {
+      size_t nbytes;
+
+      nbytes = count - ntransferred;
+      if (nbytes > (size_t)(buf.st_size - pos))
         {
-          return startpos;
+          nbytes = buf.st_size - pos;
         }
 
-      /* Use file_seek again to set the new file position */
+      if (nbytes > CONFIG_SENDFILE_BUFSIZE)
+        {
+          nbytes = CONFIG_SENDFILE_BUFSIZE;
+        }
 
-      newpos = file_seek(infile, *offset, SEEK_SET);
-      if (newpos < 0)
+      nbyteswritten = file_write(outfile, xipbase + pos, nbytes);
+      if (nbyteswritten < 0)
         {
-          return newpos;
+          /* EINTR is not an error (but will still stop the copy) */
+
+          if (nbyteswritten != -EINTR || ntransferred == 0)
+            {
+              ntransferred = nbyteswritten;
+            }
+
+          break;
+        }
+
+      pos          += nbyteswritten;
+      ntransferred += nbyteswritten;
+    }
+
+  if (ntransferred > 0)
+    {
+      ret = file_seek(infile, pos, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
         }
     }
 
+  return ntransferred;
+}
+
+/****************************************************************************
+ * Name: copybuffer
+ *
+ * Description:
+ *   Transfer data from infile to outfile through an intermediate I/O
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t copybuffer(FAR struct file *outfile,
+                          FAR struct file *infile, size_t count)
+{
+  FAR uint8_t *iobuffer;
+  FAR uint8_t *wrbuffer;
+  ssize_t nbytesread;
+  ssize_t nbyteswritten;
+  size_t  ntransferred;
+  bool endxfr;
+
   /* Allocate an I/O buffer */
 
   iobuffer = fs_heap_malloc(CONFIG_SENDFILE_BUFSIZE);
@@ -200,6 +295,52 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
   /* Release the I/O buffer */
 
   fs_heap_free(iobuffer);
+  return ntransferred;
+}
+
+/****************************************************************************
+ * Name: copyfile
+ ****************************************************************************/
+
+static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
+                        FAR off_t *offset, size_t count)
+{
+  off_t startpos = 0;
+  ssize_t ntransferred;
+
+  /* Get the current file position. */
+
+  if (offset)
+    {
+      off_t newpos;
+
+      /* Use file_seek to get the current file position */
+
+      startpos = file_seek(infile, 0, SEEK_CUR);
+      if (startpos < 0)
+        {
+          return startpos;
+        }
+
+      /* Use file_seek again to set the new file position */
+
+      newpos = file_seek(infile, *offset, SEEK_SET);
+      if (newpos < 0)
+        {
+          return newpos;
+        }
+    }
+
+  /* Files of read-only, memory-resident file systems are sent straight
+   * from their memory image.  Everything else is bounced through an
+   * intermediate buffer.
+   */
+
+  ntransferred = copyxip(outfile, infile, count);
+  if (ntransferred == -ENOTTY)
+    {
+      ntransferred = copybuffer(outfile, infile, count);
+    }
 
   /* Return the current file position */
 
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -58,5 +59,33 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 #define TCP_CORK      (__SO_PROTOCOL + 5) /* Coalescing of small segments */
+#define TCP_CONGESTION (__SO_PROTOCOL + 6) /* Congestion control algorithm
+                                            * Argument: char[] name */
+
+/* The maximum length of a congestion control algorithm name */
+
+#define TCP_CA_NAME_MAX 16
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Argument of the SIOCZCRECV ioctl (CONFIG_NET_TCP_ZEROCOPY_RECV).  The
+ * received data is not copied but loaned to the caller in the network
+ * buffers that hold it.  zc_iov is filled with the segments of the loaned
+ * data and zc_handle must be passed to the SIOCZCRELEASE ioctl once the
+ * data has been consumed; the buffers are not available to the network
+ * until then.
+ */
+
+struct tcp_zcrecv_s
+{
+  FAR struct iovec *zc_iov; /* IN:  Segments to fill */
+  int zc_iovcnt;            /* IN:  Number of segments in zc_iov
+                             * OUT: Number of segments filled */
+  size_t zc_len;            /* OUT: Number of bytes loaned, 0 at end of
+                             *      stream */
+  FAR void *zc_handle;      /* OUT: Handle of the loaned data */
+};
 
 #endif /* __INCLUDE_NETINET_TCP_H */
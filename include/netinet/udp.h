@@ -33,6 +33,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT   (__SO_PROTOCOL + 0) /* Send large buffers as a train of
+                                           * datagrams of this size (GSO).
+                                           * Argument: int, 0 disables */
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
@@ -51,6 +51,34 @@
 
 #define PACKET_MR_MULTICAST    0 /* Multicast address */
 
+#define PACKET_RX_RING         5 /* Map a receive ring, struct tpacket_req3 */
+#define PACKET_STATISTICS      6 /* Get (and reset) struct tpacket_stats_v3 */
+#define PACKET_VERSION        10 /* Ring version, only TPACKET_V3 */
+
+/* Ring versions */
+
+#define TPACKET_V1             0
+#define TPACKET_V2             1
+#define TPACKET_V3             2
+
+/* Status of the ring blocks (block_status) and frames (tp_status) */
+
+#define TP_STATUS_KERNEL       0        /* Owned by the kernel */
+#define TP_STATUS_USER         (1 << 0) /* Owned by the application */
+#define TP_STATUS_LOSING       (1 << 2) /* Frames were dropped before */
+#define TP_STATUS_BLK_TMO      (1 << 5) /* Block retired by the timeout */
+
+/* Layout of the ring: every block starts with a struct tpacket_block_desc
+ * and holds a list of frames, each one a struct tpacket3_hdr and a struct
+ * sockaddr_ll followed by the frame data at tp_mac.
+ */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x)       (((x) + TPACKET_ALIGNMENT - 1) & \
+                                ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET3_HDRLEN        (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                                sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -74,4 +102,77 @@ struct packet_mreq
   unsigned char  mr_address[8];
 };
 
+/* Receive ring request (PACKET_RX_RING).  tp_block_nr = 0 unmaps the
+ * ring.
+ */
+
+struct tpacket_req3
+{
+  unsigned int tp_block_size;      /* Size of a block */
+  unsigned int tp_block_nr;        /* Number of blocks */
+  unsigned int tp_frame_size;      /* Maximum size of a frame */
+  unsigned int tp_frame_nr;        /* Total number of frames */
+  unsigned int tp_retire_blk_tov;  /* Block retire timeout in ms */
+  unsigned int tp_sizeof_priv;     /* Private area at each block start */
+  unsigned int tp_feature_req_word;
+};
+
+struct tpacket_stats_v3
+{
+  unsigned int tp_packets;         /* Frames received */
+  unsigned int tp_drops;           /* Frames dropped, the ring was full */
+  unsigned int tp_freeze_q_cnt;
+};
+
+struct tpacket_bd_ts
+{
+  unsigned int ts_sec;
+  unsigned int ts_nsec;
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t block_status;           /* TP_STATUS_* */
+  uint32_t num_pkts;               /* Number of frames in the block */
+  uint32_t offset_to_first_pkt;    /* Offset of the first frame */
+  uint32_t blk_len;                /* Bytes used in the block */
+  uint64_t seq_num;                /* Sequence number of the block */
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t version;
+  uint32_t offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
+struct tpacket_hdr_variant1
+{
+  uint32_t tp_rxhash;
+  uint32_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint16_t tp_padding;
+};
+
+struct tpacket3_hdr
+{
+  uint32_t tp_next_offset;         /* Offset of the next frame, 0 = last */
+  uint32_t tp_sec;
+  uint32_t tp_nsec;
+  uint32_t tp_snaplen;             /* Bytes of the frame in the ring */
+  uint32_t tp_len;                 /* Length of the frame */
+  uint32_t tp_status;
+  uint16_t tp_mac;                 /* Offset of the link layer header */
+  uint16_t tp_net;                 /* Offset of the network header */
+  struct tpacket_hdr_variant1 hv1;
+  uint8_t  tp_padding[8];
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -31,6 +31,24 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* BCH cache statistics returned by the DIOC_GETSTATS ioctl */
+
+struct bchlib_stats_s
+{
+  uint32_t hits;          /* Sector lookups served from the cache */
+  uint32_t misses;        /* Sector lookups that required a device read */
+  uint32_t fillsectors;   /* Sectors read into the cache */
+  uint32_t flushes;       /* Write-back transfers issued by the cache */
+  uint32_t flushsectors;  /* Sectors written by those transfers */
+  uint32_t directread;    /* Sectors read bypassing the cache */
+  uint32_t directwrite;   /* Sectors written bypassing the cache */
+};
 
 /****************************************************************************
  * Public Function Prototypes
@@ -1810,6 +1810,28 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
 int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 
+/****************************************************************************
+ * Name: file_fstatfs
+ *
+ * Description:
+ *   file_fstatfs() is an internal OS interface.  It is functionally similar
+ *   to the standard fstatfs() interface except:
+ *
+ *    - It does not modify the errno variable, and
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   buf    - The caller provide location in which to return information
+ *            about the file system of the open file.
+ *
+ * Returned Value:
+ *   Zero is returned on success; a negated value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int file_fstatfs(FAR struct file *filep, FAR struct statfs *buf);
+
 /****************************************************************************
  * Name: nx_fstat
  *
@@ -267,6 +267,19 @@
 #define DIOC_SETKEY     _DIOC(0X0004)     /* IN:  Encryption key
                                            * OUT: None
                                            */
+#define DIOC_SETREADAHEAD _DIOC(0x0005)   /* IN:  Number of sectors to read
+                                           *      ahead on a cache miss
+                                           *      (unsigned long)
+                                           * OUT: None
+                                           */
+#define DIOC_GETREADAHEAD _DIOC(0x0006)   /* IN:  Pointer to unsigned int
+                                           * OUT: Current read-ahead, in
+                                           *      sectors
+                                           */
+#define DIOC_GETSTATS   _DIOC(0x0007)     /* IN:  Pointer to writable
+                                           *      struct bchlib_stats_s
+                                           * OUT: Cache statistics
+                                           */
 
 /* NuttX block driver ioctl definitions *************************************/
 
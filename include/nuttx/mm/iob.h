@@ -80,7 +80,7 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -95,6 +95,18 @@
 #  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
 #endif
 
+/* Values of io_flags.  The payload of a read-only I/O buffer is external
+ * memory that must not be written, e.g. the memory image of a file.
+ */
+
+#define IOB_FLAG_RDONLY  (1 << 0)
+
+#ifdef CONFIG_IOB_ALLOC
+#  define IOB_RDONLY(p)  (((p)->io_flags & IOB_FLAG_RDONLY) != 0)
+#else
+#  define IOB_RDONLY(p)  false
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -122,6 +134,7 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #  ifdef CONFIG_IOB_ALLOC
   uint16_t io_bufsize;  /* Total length of the data buffer */
+  uint8_t  io_flags;    /* See IOB_FLAG_* definitions */
 #  endif
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
@@ -220,6 +233,32 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for about size bytes of data.  With
+ *   CONFIG_IOB_CLASSES, a single buffer of the smallest size class that
+ *   fits is returned if one is free; otherwise, this is iob_alloc().
+ *
+ * Input Parameters:
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *   size      - The expected length of the data
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(bool throttled, unsigned int size);
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size() but without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
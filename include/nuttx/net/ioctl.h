@@ -159,6 +159,12 @@
 #define SIOCGIFVLAN        _SIOC(0x0043)  /* Get VLAN interface */
 #define SIOCSIFVLAN        _SIOC(0x0044)  /* Set VLAN interface */
 
+/* TCP zero-copy receive ****************************************************/
+
+#define SIOCZCRECV         _SIOC(0x0045)  /* Loan received data, see
+                                           * struct tcp_zcrecv_s */
+#define SIOCZCRELEASE      _SIOC(0x0046)  /* Return loaned data */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -141,6 +141,8 @@ struct file;    /* Forward reference */
 struct stat;    /* Forward reference */
 struct socket;  /* Forward reference */
 struct pollfd;  /* Forward reference */
+struct timespec; /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +183,11 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -192,6 +199,7 @@ struct sock_intf_s
  */
 
 struct devif_callback_s;  /* Forward reference */
+struct net_driver_s;      /* Forward reference */
 
 struct socket_conn_s
 {
@@ -213,6 +221,16 @@ struct socket_conn_s
 
   rmutex_t      s_lock;      /* Protect the connection structure */
 
+#ifdef CONFIG_NETDEV_READYLIST
+  /* Entry on the ready list of the device this connection has TX work
+   * pending on, see netdev_txnotify_conn().  Protected by that device's
+   * d_lock.
+   */
+
+  dq_entry_t    s_ready;     /* Links the device ready list */
+  FAR struct net_driver_s *s_readydev; /* Device queued on or NULL */
+#endif
+
   /* Socket options */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -914,6 +932,58 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages with a single call.  It is
+ *   the internal OS interface equivalent of sendmmsg(), see psock_sendmsg()
+ *   for the differences.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of messages to send
+ *   vlen      Number of entries in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent; the msg_len member of
+ *   each of them holds the number of bytes sent.  An error is returned only
+ *   if the first message could not be sent; then a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages with a single call.  It
+ *   is the internal OS interface equivalent of recvmmsg(), see
+ *   psock_recvmsg() for the differences.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of buffers to receive the messages
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags
+ *   timeout   Time limit for the whole operation (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received; the msg_len member
+ *   of each of them holds the number of bytes received.  An error is
+ *   returned only if no message was received; then a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -220,6 +220,19 @@
 #define NET_LL_HDRLEN(d)       ((d)->d_llhdrlen)
 #define NETDEV_PKTSIZE(d)      ((d)->d_pktsize)
 
+/* Segment size of an outgoing TCP packet larger than the MSS, zero if the
+ * packet is to be sent as is.  It must be reset whenever the packet in the
+ * device buffer is replaced or dropped.
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define NETDEV_GSO_SIZE(d)   ((d)->d_gso_size)
+#  define NETDEV_GSO_RESET(d)  ((d)->d_gso_size = 0)
+#else
+#  define NETDEV_GSO_SIZE(d)   0
+#  define NETDEV_GSO_RESET(d)
+#endif
+
 #ifdef CONFIG_NET_ETHERNET
 #  define _MIN_ETH_PKTSIZE     CONFIG_NET_ETH_PKTSIZE
 #  define _MAX_ETH_PKTSIZE     CONFIG_NET_ETH_PKTSIZE
@@ -84,6 +84,8 @@
 
 #define NETDEV_TX_CSUM  (1 << 1) /* Netdev support hardware tx checksum */
 #define NETDEV_RX_CSUM  (1 << 2) /* Netdev support hardware rx checksum */
+#define NETDEV_TSO      (1 << 3) /* Netdev support TCP segmentation offload */
+#define NETDEV_GSO      (1 << 4) /* Netdev accepts TCP segments above MTU */
 
 /* Determine the largest possible address */
 
@@ -180,6 +182,14 @@
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  ifdef CONFIG_NETDEV_MULTIQUEUE
+#    define NETDEV_RXQPACKETS(dev,q) ((dev)->d_statistics.rxq_packets[q]++)
+#    define NETDEV_TXQPACKETS(dev,q) ((dev)->d_statistics.txq_packets[q]++)
+#  else
+#    define NETDEV_RXQPACKETS(dev,q)
+#    define NETDEV_TXQPACKETS(dev,q)
+#  endif
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -196,6 +206,9 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+
+#  define NETDEV_RXQPACKETS(dev,q)
+#  define NETDEV_TXQPACKETS(dev,q)
 #endif
 
 /* There are some helper pointers for accessing the contents of the IP
@@ -274,6 +287,13 @@ struct netdev_statistics_s
 
   uint32_t errors;         /* Total number of errors */
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Per queue status */
+
+  uint32_t rxq_packets[CONFIG_NETDEV_MAX_QUEUES]; /* Received per RX queue */
+  uint32_t txq_packets[CONFIG_NETDEV_MAX_QUEUES]; /* Queued per TX queue */
+#endif
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
   struct work_s logwork;   /* For periodic log work */
 #endif
@@ -424,6 +444,19 @@ struct net_driver_s
                                  * be processed in devif_poll
                                  */
 
+#ifdef CONFIG_NETDEV_READYLIST
+  /* Connections that have TX work pending on this device, in the order in
+   * which they notified it.  devif_poll() visits only these.
+   */
+
+#  ifdef CONFIG_NET_TCP
+  dq_queue_t d_tcpready;        /* TCP connections ready to be polled */
+#  endif
+#  ifdef CONFIG_NET_UDP
+  dq_queue_t d_udpready;        /* UDP connections ready to be polled */
+#  endif
+#endif
+
   /* This is a new design that uses d_iob as packets input and output
    * buffer which used by some NICs such as celluler net driver. Case for
    * data input, note that d_iob maybe a linked chain only when using
@@ -449,6 +482,13 @@ struct net_driver_s
   struct iob_queue_s d_arpout;
 #endif
 
+  /* Forwarded packets of cached flows, their L2 header is already built */
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  struct iob_queue_s d_fwdout;
+  uint16_t d_nfwdout;
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The
    * device driver should place incoming data into this buffer.  When sending
    * data, the device driver should read the link level headers and the
@@ -505,6 +545,15 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* When the outgoing TCP segment is larger than the MSS, d_gso_size is
+   * the size of the segments it must be split into before transmission.
+   * The TCP checksum of such a segment is left for the split segments.
+   */
+
+  uint16_t d_gso_size;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -861,6 +910,29 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset);
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy data and calculate its raw checksum in the same pass.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call.  This
+ *          should be zero on the first call.
+ *   dest - Where to copy the data to.
+ *   src  - The data to copy and to include in the checksum.
+ *   len  - Length of the data.
+ *   odd  - True if the previous data ended with an odd byte; updated for
+ *          the next call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len, FAR bool *odd);
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -1345,4 +1417,24 @@ int netdev_checksum_offset(FAR struct net_driver_s *dev);
 
 uint16_t netdev_upperlayer_header_checksum(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_toeplitz_hash
+ *
+ * Description:
+ *   Toeplitz hash of the first len bytes (at most 36) of packet with the
+ *   default RSS key, as used to pick the receive queue of a flow.
+ *
+ * Input Parameters:
+ *   packet - The data to hash, usually the addresses and ports of a flow
+ *   len    - The data length in bytes
+ *
+ * Returned Value:
+ *   The hash value
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
+uint32_t netdev_toeplitz_hash(FAR const uint8_t *packet, uint32_t len);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
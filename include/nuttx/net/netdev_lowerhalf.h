@@ -127,6 +127,15 @@ struct netdev_lowerhalf_s
   uint8_t rxtype;
   uint8_t priority;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of hardware queues, 0 or 1 for a single-queue device.  Devices
+   * with more than one queue provide receive_queue/transmit_queue.
+   */
+
+  uint8_t rxqueues;
+  uint8_t txqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -180,6 +189,23 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* receive_queue - Try to receive a packet from RX queue qid,
+   *                 non-blocking.  Called without the device locked, but
+   *                 never concurrently for the same queue.
+   *   Returned Value:
+   *     A netpkt contains the packet, or NULL if no more packets.
+   */
+
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int qid);
+
+  /* transmit_queue - Same as transmit, on TX queue qid. */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, int qid);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -303,6 +329,24 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer that RX queue qid of a multi-queue
+ *   device has packets ready to read.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The RX queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int qid);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -555,6 +599,30 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_flowhash
+ *
+ * Description:
+ *   Compute the Toeplitz hash of the packet's flow with the default RSS
+ *   key: addresses and TCP/UDP ports for IPv4 and IPv6, addresses only
+ *   for other protocols.  The result matches the hash of NICs programmed
+ *   with the same key, so drivers may use it to steer packets the same way
+ *   the hardware does.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet
+ *
+ * Returned Value:
+ *   The flow hash, 0 for packets that are not IP.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+uint32_t netpkt_flowhash(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt);
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
@@ -80,6 +80,18 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* Lookup cost of the ARP table and of the IPv6 Neighbor table */
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+struct nbcache_stats_s
+{
+  net_stats_t lookup;       /* Number of lookups */
+  net_stats_t probe;        /* Number of entries compared by the lookups */
+  net_stats_t miss;         /* Number of lookups without a valid entry */
+  net_stats_t evict;        /* Number of entries evicted to make room */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -121,6 +133,14 @@ struct net_stats_s
 #ifdef CONFIG_NET_CAN
   struct can_stats_s  can;      /* CAN statistics */
 #endif
+
+#ifdef CONFIG_NET_ARP
+  struct nbcache_stats_s arp;   /* ARP table statistics */
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  struct nbcache_stats_s nd;    /* Neighbor table statistics */
+#endif
 };
 
 /****************************************************************************
@@ -68,6 +68,10 @@
  *     Indicate that should ALWAYS call the poll callback whether the
  *     driver notified the user expected event or not, and this value is
  *     used inside kernel only (events only).
+ *   POLLEXCLUSIVE
+ *     When an event is reported to several waiters at once, only the first
+ *     one of those with this flag is woken up.  Same as EPOLLEXCLUSIVE
+ *     (events only).
  */
 
 #define POLLIN       (0x01)  /* NuttX does not make priority distinctions */
@@ -86,6 +90,7 @@
 #define POLLNVAL     (0x20)
 
 #define POLLALWAYS   (0x10000) /* For not conflict with Linux */
+#define POLLEXCLUSIVE (0x10000000) /* Same value as EPOLLEXCLUSIVE */
 
 /****************************************************************************
  * Public Type Definitions
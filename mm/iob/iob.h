@@ -98,6 +98,30 @@ extern int16_t g_qentry_wait;
 
 extern volatile spinlock_t g_iob_lock;
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_haswaiters
+ *
+ * Description:
+ *   Return true if some task is blocked waiting for an I/O buffer.  Freed
+ *   buffers must then go to the committed list and may not be cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+static inline bool iob_haswaiters(void)
+{
+#if CONFIG_IOB_THROTTLE > 0
+  return g_iob_count < 0 || g_throttle_wait > 0;
+#else
+  return g_iob_count < 0;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -137,6 +161,87 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release_list
+ *
+ * Description:
+ *   Return a list of I/O buffers linked through io_flink to the free list,
+ *   or to the committed list if there are tasks waiting for them.  The
+ *   buffers must come from the pre-allocated pool.
+ *
+ ****************************************************************************/
+
+void iob_release_list(FAR struct iob_s *iob);
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty.  NULL is returned if the
+ *   allocation must be decided by the free list.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a free I/O buffer into the cache of the current CPU.  Returns false
+ *   if the buffer must be returned to the free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers of all per-CPU caches to the free list.  Returns
+ *   true if any buffer was returned.
+ *
+ ****************************************************************************/
+
+bool iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held in the per-CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+#endif
+
+#ifdef CONFIG_IOB_CLASSES
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the pools of the additional I/O buffer size classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void);
+
+/****************************************************************************
+ * Name: iob_class_tryalloc
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the smallest size class that can
+ *   hold size bytes, or from the largest class if none can.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_class_tryalloc(bool throttled, unsigned int size);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
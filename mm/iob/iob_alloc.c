@@ -167,6 +167,18 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Try the per-CPU cache first; this also brings back the buffers of all
+   * caches if the free list alone cannot serve the allocation.
+   */
+
+  iob = iob_tryalloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -193,6 +205,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+      /* A buffer may have been cached after the caches were drained above.
+       * Now that the wait is visible, drain them again; anything found
+       * will be committed to us.
+       */
+
+      iob_cache_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -305,12 +326,89 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
    * to protect the free list:  We disable interrupts very briefly.
    */
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  iob = iob_cache_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
   iob = iob_tryalloc_internal(throttled);
   spin_unlock_irqrestore(&g_iob_lock, flags);
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* The buffers held in the per-CPU caches are free as well.  Return them
+   * to the free list and try again before giving up.
+   */
+
+  if (iob == NULL && iob_cache_drain())
+    {
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob = iob_tryalloc_internal(throttled);
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+    }
+#endif
+
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for about size bytes of data.  If a size class
+ *   larger than the default buffer size fits and has a free buffer, a
+ *   single buffer of that class is returned; otherwise this behaves like
+ *   iob_alloc().
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(bool throttled, unsigned int size)
+{
+#ifdef CONFIG_IOB_CLASSES
+  FAR struct iob_s *iob;
+
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_class_tryalloc(throttled, size);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  return iob_alloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size() but never waits for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size)
+{
+#ifdef CONFIG_IOB_CLASSES
+  FAR struct iob_s *iob;
+
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_class_tryalloc(throttled, size);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  return iob_tryalloc(throttled);
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -344,6 +442,7 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_len     = 0;                /* Length of the data in the entry */
       iob->io_offset  = 0;                /* Offset to the beginning of data */
       iob->io_bufsize = size;             /* Total length of the iob buffer */
+      iob->io_flags   = 0;                /* Writable */
       iob->io_pktlen  = 0;                /* Total length of the packet */
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
@@ -390,6 +489,7 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_len     = 0;       /* Length of the data in the entry */
       iob->io_offset  = 0;       /* Offset to the beginning of data */
       iob->io_bufsize = size;    /* Total length of the iob buffer */
+      iob->io_flags   = 0;       /* Writable */
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
@@ -430,6 +530,7 @@ FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
   iob->io_len     = 0;       /* Length of the data in the entry */
   iob->io_offset  = 0;       /* Offset to the beginning of data */
   iob->io_pktlen  = 0;       /* Total length of the packet */
+  iob->io_flags   = 0;       /* Writable */
   iob->io_free    = free_cb; /* Customer free callback */
   iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                             IOB_ALIGNMENT);
@@ -0,0 +1,292 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE_BATCH < 1 || \
+    CONFIG_IOB_PERCPU_CACHE_BATCH > CONFIG_IOB_PERCPU_CACHE_SIZE
+#  error Invalid CONFIG_IOB_PERCPU_CACHE_BATCH
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The free I/O buffers cached by one CPU.  The lock is normally taken only
+ * by the owning CPU; other CPUs take it when they drain the caches.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t        ic_lock;   /* Protects the cache */
+  FAR struct iob_s *ic_head;   /* List of cached I/O buffers */
+  int16_t           ic_count;  /* Number of cached I/O buffers */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_refill
+ *
+ * Description:
+ *   Move a batch of I/O buffers from the free list into a cache.  Only the
+ *   buffers above the throttle value are taken, so the free list can still
+ *   serve the non-throttled allocations on its own.
+ *
+ * Assumptions:
+ *   The cache is locked and empty.
+ *
+ ****************************************************************************/
+
+static void iob_cache_refill(FAR struct iob_cache_s *cache)
+{
+  FAR struct iob_s *iob;
+  int n;
+
+  spin_lock(&g_iob_lock);
+
+  n = MIN(g_iob_count - CONFIG_IOB_THROTTLE, CONFIG_IOB_PERCPU_CACHE_BATCH);
+  while (n-- > 0 && (iob = g_iob_freelist) != NULL)
+    {
+      g_iob_freelist  = iob->io_flink;
+      g_iob_count--;
+
+      iob->io_flink   = cache->ic_head;
+      cache->ic_head  = iob;
+      cache->ic_count++;
+    }
+
+  spin_unlock(&g_iob_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty.  NULL is returned if the
+ *   allocation must be decided by the free list.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->ic_lock);
+
+  /* The cached buffers are not counted in g_iob_count, so a throttled
+   * allocation may only use them while the free list still holds the
+   * whole throttle reserve.
+   */
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (!throttled || g_iob_count >= CONFIG_IOB_THROTTLE)
+#endif
+    {
+      if (cache->ic_head == NULL)
+        {
+          iob_cache_refill(cache);
+        }
+
+      iob = cache->ic_head;
+      if (iob != NULL)
+        {
+          cache->ic_head = iob->io_flink;
+          cache->ic_count--;
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+        }
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a free I/O buffer into the cache of the current CPU.  Returns false
+ *   if the buffer must be returned to the free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *drain = NULL;
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  int n;
+
+  if (iob_haswaiters())
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->ic_lock);
+
+  iob->io_flink  = cache->ic_head;
+  cache->ic_head = iob;
+  cache->ic_count++;
+
+  if (iob_haswaiters())
+    {
+      /* A task started to wait after the check above.  It drains the
+       * caches only once before it sleeps, and that may have happened
+       * before this buffer was added, so hand back the whole cache.
+       */
+
+      drain           = cache->ic_head;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+    }
+  else if (cache->ic_count > CONFIG_IOB_PERCPU_CACHE_SIZE)
+    {
+      /* The cache overflows, return a batch to the free list */
+
+      drain = cache->ic_head;
+      for (tail = drain, n = 1; n < CONFIG_IOB_PERCPU_CACHE_BATCH; n++)
+        {
+          tail = tail->io_flink;
+        }
+
+      cache->ic_head   = tail->io_flink;
+      cache->ic_count -= CONFIG_IOB_PERCPU_CACHE_BATCH;
+      tail->io_flink   = NULL;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      iob_release_list(drain);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers of all per-CPU caches to the free list.  Returns
+ *   true if any buffer was returned.
+ *
+ ****************************************************************************/
+
+bool iob_cache_drain(void)
+{
+  FAR struct iob_s *drain;
+  irqstate_t flags;
+  bool ret = false;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct iob_cache_s *cache = &g_iob_cache[cpu];
+
+      flags = spin_lock_irqsave(&cache->ic_lock);
+      drain           = cache->ic_head;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+      spin_unlock_irqrestore(&cache->ic_lock, flags);
+
+      if (drain != NULL)
+        {
+          iob_release_list(drain);
+          ret = true;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held in the per-CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cache[cpu].ic_count;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE */
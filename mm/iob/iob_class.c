@@ -0,0 +1,240 @@
+/****************************************************************************
+ * mm/iob/iob_class.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_CLASSES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_IOB_CLASS1_BUFSIZE <= CONFIG_IOB_BUFSIZE || \
+    CONFIG_IOB_CLASS2_BUFSIZE <= CONFIG_IOB_CLASS1_BUFSIZE
+#  error The I/O buffer size classes must be in increasing order
+#endif
+
+#define IOB_NCLASSES          2
+
+/* Each buffer is the I/O buffer header followed by the payload, laid out
+ * like iob_alloc_dynamic() does so that iob_free() hands the header to
+ * the io_free callback.
+ */
+
+#define IOB_CLASS_HDRSIZE     ALIGN_UP(sizeof(struct iob_s), IOB_ALIGNMENT)
+#define IOB_CLASS_SIZE(s)     (IOB_CLASS_HDRSIZE + ALIGN_UP(s, IOB_ALIGNMENT))
+
+/* Throttled allocations leave a quarter of each class to the others */
+
+#if CONFIG_IOB_THROTTLE > 0
+#  define IOB_CLASS_RESERVE(n) ((n) / 4)
+#else
+#  define IOB_CLASS_RESERVE(n) 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct iob_class_s
+{
+  FAR struct iob_s *freelist;  /* List of free buffers of this class */
+  uint16_t          bufsize;   /* Payload size of the buffers */
+  int16_t           count;     /* Number of free buffers */
+  int16_t           reserve;   /* Buffers denied to throttled allocations */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_IOB_CLASS1_NBUFFERS > 0
+static uint8_t g_iob_class1_buffer[IOB_CLASS_SIZE(CONFIG_IOB_CLASS1_BUFSIZE) *
+                                   CONFIG_IOB_CLASS1_NBUFFERS +
+                                   IOB_ALIGNMENT - 1];
+#endif
+
+#if CONFIG_IOB_CLASS2_NBUFFERS > 0
+static uint8_t g_iob_class2_buffer[IOB_CLASS_SIZE(CONFIG_IOB_CLASS2_BUFSIZE) *
+                                   CONFIG_IOB_CLASS2_NBUFFERS +
+                                   IOB_ALIGNMENT - 1];
+#endif
+
+static struct iob_class_s g_iob_class[IOB_NCLASSES];
+
+static spinlock_t g_iob_class_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_setup
+ *
+ * Description:
+ *   Carve a raw buffer into I/O buffers of one size class.
+ *
+ ****************************************************************************/
+
+static void iob_class_setup(FAR struct iob_class_s *pool,
+                            FAR uint8_t *buffer, uint16_t bufsize,
+                            int nbuffers, iob_free_cb_t free_cb)
+{
+  uintptr_t buf;
+  int i;
+
+  buf = ALIGN_UP((uintptr_t)buffer, IOB_ALIGNMENT);
+
+  pool->bufsize = bufsize;
+  pool->count   = nbuffers;
+  pool->reserve = IOB_CLASS_RESERVE(nbuffers);
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob =
+        (FAR struct iob_s *)(buf + i * IOB_CLASS_SIZE(bufsize));
+
+      iob->io_bufsize = bufsize;
+      iob->io_flags   = 0;
+      iob->io_free    = free_cb;
+      iob->io_data    = (FAR uint8_t *)iob + IOB_CLASS_HDRSIZE;
+      iob->io_flink   = pool->freelist;
+      pool->freelist  = iob;
+    }
+}
+
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   The io_free callback of the size class buffers: return the buffer to
+ *   the free list of its class.
+ *
+ ****************************************************************************/
+
+static void iob_class_free(FAR void *data)
+{
+  FAR struct iob_s *iob = data;
+  FAR struct iob_class_s *pool;
+  irqstate_t flags;
+
+  pool = &g_iob_class[iob->io_bufsize == CONFIG_IOB_CLASS1_BUFSIZE ? 0 : 1];
+  DEBUGASSERT(iob->io_bufsize == pool->bufsize);
+
+  flags = spin_lock_irqsave(&g_iob_class_lock);
+  iob->io_flink  = pool->freelist;
+  pool->freelist = iob;
+  pool->count++;
+  spin_unlock_irqrestore(&g_iob_class_lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the pools of the additional I/O buffer size classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void)
+{
+#if CONFIG_IOB_CLASS1_NBUFFERS > 0
+  iob_class_setup(&g_iob_class[0], g_iob_class1_buffer,
+                  CONFIG_IOB_CLASS1_BUFSIZE, CONFIG_IOB_CLASS1_NBUFFERS,
+                  iob_class_free);
+#endif
+
+#if CONFIG_IOB_CLASS2_NBUFFERS > 0
+  iob_class_setup(&g_iob_class[1], g_iob_class2_buffer,
+                  CONFIG_IOB_CLASS2_BUFSIZE, CONFIG_IOB_CLASS2_NBUFFERS,
+                  iob_class_free);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_class_tryalloc
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the smallest size class that can
+ *   hold size bytes, or from the largest class if none can.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_class_tryalloc(bool throttled, unsigned int size)
+{
+  FAR struct iob_class_s *pool;
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_iob_class_lock);
+
+  for (i = 0; i < IOB_NCLASSES; i++)
+    {
+      pool = &g_iob_class[i];
+
+      /* Skip the classes that are too small, unless this is the last */
+
+      if (pool->bufsize < size && i < IOB_NCLASSES - 1)
+        {
+          continue;
+        }
+
+      if (pool->count > (throttled ? pool->reserve : 0))
+        {
+          iob            = pool->freelist;
+          pool->freelist = iob->io_flink;
+          pool->count--;
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_class_lock, flags);
+  return iob;
+}
+
+#endif /* CONFIG_IOB_CLASSES */
@@ -128,9 +128,12 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
               unsigned int maxlen;
               unsigned int newlen;
 
-              /* Yes.. We can extend this buffer to the up to the very end. */
+              /* Yes.. We can extend this buffer to the up to the very end,
+               * unless its payload is read-only.
+               */
 
-              maxlen = IOB_BUFSIZE(iob) - iob->io_offset;
+              maxlen = IOB_RDONLY(iob) ? iob->io_len :
+                       IOB_BUFSIZE(iob) - iob->io_offset;
 
               /* This is the new buffer length that we need.  Of course,
                * clipped to the maximum possible size in this buffer.
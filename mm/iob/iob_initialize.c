@@ -154,6 +154,7 @@ void iob_initialize(void)
       iob->io_flink   = g_iob_freelist;
 #ifdef CONFIG_IOB_ALLOC
       iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+      iob->io_flags   = 0;
       iob->io_data    = (FAR uint8_t *)(iob + 1);
 #endif
       g_iob_freelist  = iob;
@@ -174,4 +175,10 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#ifdef CONFIG_IOB_CLASSES
+  /* Set up the pools of the additional size classes */
+
+  iob_class_initialize();
+#endif
 }
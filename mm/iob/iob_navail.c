@@ -51,6 +51,15 @@ int iob_navail(bool throttled)
 #if CONFIG_IOB_NBUFFERS > 0
   ret = g_iob_count;
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* The buffers held in the per-CPU caches are available too */
+
+  if (ret >= 0)
+    {
+      ret += iob_cache_navail();
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Subtract the throttle value is so requested */
 
@@ -42,7 +42,8 @@
  * Description:
  *   Pack all data in the I/O buffer chain so that the data offset is zero
  *   and all but the final buffer in the chain are filled.  Any emptied
- *   buffers at the end of the chain are freed.
+ *   buffers at the end of the chain are freed.  Read-only buffers are only
+ *   copied from, never written.
  *
  ****************************************************************************/
 
@@ -70,6 +71,17 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
     {
       next = iob->io_flink;
 
+      /* The payload of a read-only entry is external memory that must not
+       * be written, leave it as it is.  It may still be copied into the
+       * previous entry.
+       */
+
+      if (IOB_RDONLY(iob))
+        {
+          iob = next;
+          continue;
+        }
+
       /* Eliminate the data offset in this entry */
 
       if (iob->io_offset > 0)
@@ -45,6 +45,7 @@
 #include <netinet/arp.h>
 #include <netinet/in.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/semaphore.h>
 
@@ -161,6 +162,10 @@ struct arp_notify_s
 
 struct arp_entry_s
 {
+#ifdef CONFIG_NET_ARP_HASH
+  hash_node_t              at_node;     /* Node in the IP address hashtable */
+  dq_entry_t               at_lru;      /* Node in the LRU list */
+#endif
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
   clock_t                  at_time;     /* Time of last usage */
@@ -46,6 +46,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -99,6 +100,39 @@ static const uint8_t g_multicast_ethaddr[3] =
 };
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_queue_out
+ *
+ * Description:
+ *   Queue the packet in the device buffer until the ARP request for ipaddr
+ *   is answered.  A TCP segment that the driver still has to split (GSO)
+ *   is not queued: it is sent later without the device state that tells
+ *   the driver to split it, and its checksum is left for the split
+ *   segments.  It is dropped instead and TCP retransmits it.
+ *
+ * Returned Value:
+ *   true if the packet was queued and the device buffer is empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_SEND_QUEUE
+static bool arp_queue_out(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  if (NETDEV_GSO_SIZE(dev) > 0)
+    {
+      return false;
+    }
+
+  arp_queue_iob(dev, ipaddr, dev->d_iob);
+  netdev_iob_clear(dev);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -227,6 +261,7 @@ void arp_out(FAR struct net_driver_s *dev)
 
       if (ipaddr == INADDR_ANY)
         {
+          NETDEV_GSO_RESET(dev);
           dev->d_len = 0;
           return;
         }
@@ -262,6 +297,7 @@ void arp_out(FAR struct net_driver_s *dev)
       if (IFF_IS_NOARP(dev->d_flags) || ret == -ENETUNREACH)
         {
           ninfo("ARP not supported on %s, no send!\n", dev->d_ifname);
+          NETDEV_GSO_RESET(dev);
           dev->d_len = 0;
           return;
         }
@@ -276,11 +312,14 @@ void arp_out(FAR struct net_driver_s *dev)
            */
 
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
-          arp_queue_iob(dev, ipaddr, dev->d_iob);
-          netdev_iob_clear(dev);
-#else
-          dev->d_len = 0;
+          if (arp_queue_out(dev, ipaddr))
+            {
+              return;
+            }
 #endif
+
+          NETDEV_GSO_RESET(dev);
+          dev->d_len = 0;
           return;
         }
 
@@ -290,14 +329,14 @@ void arp_out(FAR struct net_driver_s *dev)
 
       arp_update(dev, ipaddr, NULL, 0);
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
-      arp_queue_iob(dev, ipaddr, dev->d_iob);
-      netdev_iob_clear(dev);
+      arp_queue_out(dev, ipaddr);
 #endif
 
       /* The destination address was not in our ARP table, so we overwrite
        * the IP packet with an ARP request.
        */
 
+      NETDEV_GSO_RESET(dev);
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
       return;
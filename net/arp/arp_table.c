@@ -60,10 +60,13 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
+#include "utils/utils.h"
 #include "arp/arp.h"
+#include "ipforward/ipforward.h"
 
 #ifdef CONFIG_NET_ARP
 
@@ -75,6 +78,28 @@
 #define ARP_MAXAGE_UNREACHABLE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE_UNREACHABLE)
 #define ARP_INPROGRESS_TICK MSEC2TICK(CONFIG_ARP_SEND_MAXTRIES * CONFIG_ARP_SEND_DELAYMSEC)
 
+#ifndef CONFIG_NET_ARP_MAX_ENTRIES
+#  define CONFIG_NET_ARP_MAX_ENTRIES 0
+#endif
+
+/* The hashed table is protected by the lock of its entry pool; the array
+ * relies on the caller as it always did.
+ */
+
+#ifdef CONFIG_NET_ARP_HASH
+#  define arp_table_lock()   NET_BUFPOOL_LOCK(g_arp_pool)
+#  define arp_table_unlock() NET_BUFPOOL_UNLOCK(g_arp_pool)
+#else
+#  define arp_table_lock()
+#  define arp_table_unlock()
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  define ARP_STATS(n)       (g_netstats.arp.n++)
+#else
+#  define ARP_STATS(n)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,7 +116,20 @@ struct arp_table_info_s
 
 /* The table of known address mappings */
 
+#ifdef CONFIG_NET_ARP_HASH
+NET_BUFPOOL_DECLARE(g_arp_pool, sizeof(struct arp_entry_s),
+                    CONFIG_NET_ARPTAB_SIZE, CONFIG_NET_ARP_ALLOC_ENTRIES,
+                    CONFIG_NET_ARP_MAX_ENTRIES);
+
+/* Entries hashed by IPv4 address, and all entries from the least to the
+ * most recently used.
+ */
+
+static DECLARE_HASHTABLE(g_arp_hash, CONFIG_NET_ARP_HASH_BITS);
+static dq_queue_t g_arp_lru;
+#else
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+#endif
 
 static const struct ether_addr g_zero_ethaddr =
 {
@@ -158,6 +196,7 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARP_HASH
 static FAR struct arp_entry_s *
 arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 {
@@ -182,6 +221,132 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
       return e2;
     }
 }
+#endif
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the ARP table entry of this IP address on this device, whatever
+ *   its age.
+ *
+ * Assumptions:
+ *   The ARP table is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_search(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+#ifdef CONFIG_NET_ARP_HASH
+  FAR hash_node_t *node;
+
+  hashtable_for_every_possible(g_arp_hash, node, ipaddr)
+    {
+      tabptr = container_of(node, struct arp_entry_s, at_node);
+#else
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      tabptr = &g_arptable[i];
+#endif
+
+      ARP_STATS(probe);
+      if (tabptr->at_dev == dev && tabptr->at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_alloc_entry
+ *
+ * Description:
+ *   Return an entry for a new mapping with these flags: a free one, or
+ *   else the oldest one (the least recently used one with the hashtable).
+ *   The caller checks at_ipaddr to know whether a mapping is replaced.
+ *
+ * Assumptions:
+ *   The ARP table is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc_entry(uint8_t flags)
+{
+  FAR struct arp_entry_s *tabptr;
+#ifdef CONFIG_NET_ARP_HASH
+  FAR dq_entry_t *node;
+
+  tabptr = NET_BUFPOOL_TRYALLOC(g_arp_pool);
+  if (tabptr != NULL)
+    {
+      memset(tabptr, 0, sizeof(*tabptr));
+      dq_addlast(&tabptr->at_lru, &g_arp_lru);
+      return tabptr;
+    }
+
+  /* The table is full, recycle the least recently used entry that is not
+   * permanent.  It stays in the LRU list but leaves its hash bucket.
+   */
+
+  for (node = g_arp_lru.head; node != NULL; node = node->flink)
+    {
+      tabptr = container_of(node, struct arp_entry_s, at_lru);
+      if ((tabptr->at_flags & ATF_PERM) == 0 ||
+          (flags & ATF_PERM) != 0)
+        {
+          hashtable_delete(g_arp_hash, &tabptr->at_node, tabptr->at_ipaddr);
+          return tabptr;
+        }
+    }
+
+  return NULL;
+#else
+  int i;
+
+  UNUSED(flags);
+
+  for (tabptr = &g_arptable[0], i = 1; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+    }
+
+  return tabptr;
+#endif
+}
+
+/****************************************************************************
+ * Name: arp_free_entry
+ *
+ * Description:
+ *   Release an ARP table entry together with any packets waiting on it.
+ *
+ * Assumptions:
+ *   The ARP table is locked.
+ *
+ ****************************************************************************/
+
+static void arp_free_entry(FAR struct arp_entry_s *tabptr)
+{
+#ifdef CONFIG_NET_ARP_SEND_QUEUE
+  work_cancel_sync(LPWORK, &tabptr->at_work);
+  iob_free_queue(&tabptr->at_queue);
+#endif
+
+#ifdef CONFIG_NET_ARP_HASH
+  hashtable_delete(g_arp_hash, &tabptr->at_node, tabptr->at_ipaddr);
+  dq_rem(&tabptr->at_lru, &g_arp_lru);
+  NET_BUFPOOL_FREE(g_arp_pool, tabptr);
+#else
+  memset(tabptr, 0, sizeof(*tabptr));
+#endif
+}
 
 /****************************************************************************
  * Name: arp_lookup
@@ -194,8 +359,8 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
  *   dev    - Device structure
  *
  * Assumptions:
- *   The network is locked to assure exclusive access to the ARP table.
- *   The return value will become unstable when the network is unlocked.
+ *   The ARP table is locked.  The return value will become unstable when
+ *   it is unlocked.
  *
  ****************************************************************************/
 
@@ -203,28 +368,27 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  ARP_STATS(lookup);
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr != NULL &&
+      ((tabptr->at_flags & ATF_PERM) != 0 ||
+       clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          if ((tabptr->at_flags & ATF_PERM) != 0 ||
-              clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-            {
-              return tabptr;
-            }
+#ifdef CONFIG_NET_ARP_HASH
+      /* Make it the most recently used entry */
 
-          return NULL;  /* Expired */
-        }
+      dq_rem(&tabptr->at_lru, &g_arp_lru);
+      dq_addlast(&tabptr->at_lru, &g_arp_lru);
+#endif
+      return tabptr;
     }
 
-  /* Not found */
+  /* Not found or expired */
 
+  ARP_STATS(miss);
   return NULL;
 }
 
@@ -295,52 +459,42 @@ static void arp_unreach_work(FAR void *param)
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr, uint8_t flags)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
   bool new_entry;
 #endif
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-  bool found = false;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  bool changed;
 #endif
-  int i;
+  bool found = true;
+
+  arp_table_lock();
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table, in place of the oldest
+   * entry if it is full.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-          found = true;
-#endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      found  = false;
+      tabptr = arp_alloc_entry(flags);
     }
 
-  if ((tabptr->at_flags & ATF_PERM) != 0 && (flags & ATF_PERM) == 0)
+  if (tabptr == NULL ||
+      ((tabptr->at_flags & ATF_PERM) != 0 && (flags & ATF_PERM) == 0))
     {
+      arp_table_unlock();
       return -ENOSPC;
     }
 
+  if (!found && tabptr->at_ipaddr != 0)
+    {
+      ARP_STATS(evict);
+    }
+
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
   if (!found && tabptr->at_ipaddr != 0)
     {
@@ -376,6 +530,13 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                                ethaddr, ETHER_ADDR_LEN) != 0;
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Cached flows may still use the old MAC address */
+
+  changed = found && memcmp(tabptr->at_ethaddr.ether_addr_octet,
+                            ethaddr, ETHER_ADDR_LEN) != 0;
+#endif
+
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
@@ -386,6 +547,16 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
   tabptr->at_flags  = flags;
   tabptr->at_dev    = dev;
 
+#ifdef CONFIG_NET_ARP_HASH
+  if (!found)
+    {
+      hashtable_add(g_arp_hash, &tabptr->at_node, ipaddr);
+    }
+
+  dq_rem(&tabptr->at_lru, &g_arp_lru);
+  dq_addlast(&tabptr->at_lru, &g_arp_lru);
+#endif
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -396,6 +567,15 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
     }
 #endif
 
+  arp_table_unlock();
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  if (changed)
+    {
+      ipfwd_flow_flush(NULL);
+    }
+#endif
+
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
   if (!IOB_QEMPTY(&dev->d_arpout))
     {
@@ -477,9 +657,11 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
 {
   FAR struct arp_entry_s *tabptr;
   struct arp_table_info_s info;
+  int ret = OK;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
+  arp_table_lock();
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
@@ -494,15 +676,15 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
           elapsed = clock_systime_ticks() - tabptr->at_time;
           if (elapsed <= ARP_INPROGRESS_TICK)
             {
-              return -EINPROGRESS;
+              ret = -EINPROGRESS;
             }
           else if (elapsed <= ARP_MAXAGE_UNREACHABLE_TICK)
             {
-              return -ENETUNREACH;
+              ret = -ENETUNREACH;
             }
           else
             {
-              return -ENOENT;
+              ret = -ENOENT;
             }
         }
 
@@ -510,7 +692,7 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
        * non-NULL address in 'ethaddr'.
        */
 
-      if (ethaddr != NULL)
+      else if (ethaddr != NULL)
         {
           memcpy(ethaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
         }
@@ -519,9 +701,12 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
        * is available for the IP address.
        */
 
-      return OK;
+      arp_table_unlock();
+      return ret;
     }
 
+  arp_table_unlock();
+
   /* No.. check if the IPv4 address is the address assigned to a local
    * Ethernet network device.  If so, return a mapping of that IP address
    * to the Ethernet MAC address assigned to the network device.
@@ -563,6 +748,7 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 #endif
   /* Check if the IPv4 address is in the ARP table. */
 
+  arp_table_lock();
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
@@ -573,12 +759,15 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. release the entry */
 
-      tabptr->at_ipaddr = 0;
+      arp_free_entry(tabptr);
+      arp_table_unlock();
+      ipfwd_flow_flush(NULL);
       return OK;
     }
 
+  arp_table_unlock();
   return -ENOENT;
 }
 
@@ -598,20 +787,32 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
+  FAR struct arp_entry_s *tabptr;
+#ifdef CONFIG_NET_ARP_HASH
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+
+  arp_table_lock();
+  for (node = g_arp_lru.head; node != NULL; node = next)
+    {
+      next   = node->flink;
+      tabptr = container_of(node, struct arp_entry_s, at_lru);
+#else
   int i;
 
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      if (dev == g_arptable[i].at_dev)
-        {
-#ifdef CONFIG_NET_ARP_SEND_QUEUE
-          work_cancel_sync(LPWORK, &g_arptable[i].at_work);
-          iob_free_queue(&g_arptable[i].at_queue);
+      tabptr = &g_arptable[i];
 #endif
 
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+      if (dev == tabptr->at_dev)
+        {
+          arp_free_entry(tabptr);
         }
     }
+
+  arp_table_unlock();
+  ipfwd_flow_flush(NULL);
 }
 
 /****************************************************************************
@@ -639,17 +840,27 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
                           unsigned int nentries)
 {
   FAR struct arp_entry_s *tabptr;
-  clock_t now;
-  unsigned int ncopied;
+  clock_t now = clock_systime_ticks();
+  unsigned int ncopied = 0;
+#ifdef CONFIG_NET_ARP_HASH
+  FAR dq_entry_t *node;
+#else
   int i;
+#endif
 
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
-  for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  arp_table_lock();
+#ifdef CONFIG_NET_ARP_HASH
+  for (node = g_arp_lru.head; nentries > ncopied && node != NULL;
+       node = node->flink)
+    {
+      tabptr = container_of(node, struct arp_entry_s, at_lru);
+#else
+  for (i = 0; nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE; i++)
     {
       tabptr = &g_arptable[i];
+#endif
       if (tabptr->at_ipaddr != 0 && ((tabptr->at_flags & ATF_PERM) != 0 ||
           now - tabptr->at_time <= ARP_MAXAGE_TICK))
         {
@@ -658,6 +869,8 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
         }
     }
 
+  arp_table_unlock();
+
   /* Return the number of entries copied into the user buffer */
 
   return ncopied;
@@ -690,13 +903,16 @@ int arp_queue_iob(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                   FAR struct iob_s *iob)
 {
   FAR struct arp_entry_s *tabptr;
+  int ret = -ENOENT;
 
   /* the IPv4 address should in the ARP table and arp in progress. */
 
+  arp_table_lock();
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr && memcmp(&tabptr->at_ethaddr, &g_zero_ethaddr,
                        sizeof(tabptr->at_ethaddr)) == 0)
     {
+      ret = -ENOMEM;
       if (iob_tryadd_queue(iob, &tabptr->at_queue) == 0)
         {
           if (work_available(&tabptr->at_work))
@@ -705,13 +921,12 @@ int arp_queue_iob(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                          tabptr, ARP_INPROGRESS_TICK);
             }
 
-          return OK;
+          ret = OK;
         }
-
-      return -ENOMEM;
     }
 
-  return -ENOENT;
+  arp_table_unlock();
+  return ret;
 }
 #endif
 #endif /* CONFIG_NET_ARP */
@@ -26,17 +26,170 @@
 
 #include <nuttx/config.h>
 
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <stdint.h>
+#include <fcntl.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/****************************************************************************
+ * Name: devif_file_release
+ *
+ * Description:
+ *   Free callback of the external-buffer IOBs.  The payload is the memory
+ *   image of a romfs file, which never changes or goes away while the
+ *   file system is mounted, so there is nothing to do here; iob_free()
+ *   releases the IOB header itself.
+ *
+ ****************************************************************************/
+
+static void devif_file_release(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Name: devif_file_attach
+ *
+ * Description:
+ *   Try to append the file data to the device buffer without copying it.
+ *   This works only for files of a read-only file system that exposes its
+ *   contents in memory (XIP romfs); the data is then referenced from
+ *   read-only external-buffer IOBs chained after the protocol headers.
+ *   The memory image of a writable file system (tmpfs) may be reallocated
+ *   while the IOBs are still queued, so such files are copied.
+ *
+ * Returned Value:
+ *   The number of bytes attached on success.  -EBADF if the file is not
+ *   open for reading.  Another negated errno value if the file has no
+ *   memory image or the IOB headers could not be allocated; the caller
+ *   should then fall back to copying.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int devif_file_attach(FAR struct net_driver_s *dev,
+                             FAR struct file *file, unsigned int len,
+                             unsigned int offset,
+                             unsigned int target_offset)
+{
+  FAR struct iob_s *tail;
+  FAR struct iob_s *iob;
+  FAR uint8_t *data;
+  struct statfs fsbuf;
+  struct stat buf;
+  uintptr_t addr;
+  unsigned int remain;
+  unsigned int chunk;
+  int ret;
+
+  /* The memory image bypasses file_read(), check the access mode here */
+
+  if ((file->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = file_fstatfs(file, &fsbuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (fsbuf.f_type != ROMFS_MAGIC)
+    {
+      return -ENOTTY;
+    }
+
+  ret = file_ioctl(file, FIOC_XIPBASE, (unsigned long)((uintptr_t)&addr));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_fstat(file, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((off_t)offset + len > buf.st_size)
+    {
+      return -ERANGE;
+    }
+
+  /* Leave the file position where the copying path would have left it */
+
+  ret = file_seek(file, offset + len, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (netdev_iob_prepare(dev, false, 0) != OK)
+    {
+      return -ENOMEM;
+    }
+
+  /* Leave room for the protocol headers in the first IOB(s) */
+
+  ret = iob_update_pktlen(dev->d_iob, target_offset, false);
+  if (ret < 0)
+    {
+      netdev_iob_release(dev);
+      return ret;
+    }
+
+  tail = dev->d_iob;
+  while (tail->io_flink != NULL)
+    {
+      tail = tail->io_flink;
+    }
+
+  data   = (FAR uint8_t *)addr + offset;
+  remain = len;
+
+  while (remain > 0)
+    {
+      chunk = remain > UINT16_MAX ? UINT16_MAX : remain;
+
+      iob = iob_alloc_with_data(data, chunk, devif_file_release);
+      if (iob == NULL)
+        {
+          netdev_iob_release(dev);
+          return -ENOMEM;
+        }
+
+      iob->io_len    = chunk;
+      iob->io_flags  = IOB_FLAG_RDONLY;
+      tail->io_flink = iob;
+      tail           = iob;
+
+      data   += chunk;
+      remain -= chunk;
+    }
+
+  dev->d_iob->io_pktlen = target_offset + len;
+  dev->d_sndlen         = len;
+  return len;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,6 +238,20 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
     }
 #endif
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Reference the file data directly if it is memory-resident */
+
+  ret = devif_file_attach(dev, file, len, offset, target_offset);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+  else if (ret == -EBADF)
+    {
+      goto errout;
+    }
+#endif
+
   /* Append the send buffer after device buffer */
 
   if (len > iob_navail(false) * CONFIG_IOB_BUFSIZE ||
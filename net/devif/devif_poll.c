@@ -30,6 +30,7 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/net.h>
@@ -498,6 +499,69 @@ static inline_function int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 }
 #endif /* CONFIG_NET_ICMPv6_SOCKET || CONFIG_NET_ICMPv6_NEIGHBOR*/
 
+/****************************************************************************
+ * Name: devif_poll_fwdout
+ *
+ * Description:
+ *   Send the forwarded packets of cached flows.  Their L2 header was built
+ *   when they were queued, so they are passed to the driver as they are.
+ *
+ * Input Parameters:
+ *   dev - NIC Device instance.
+ *   callback - the actual sending API provided by each NIC driver.
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+static int devif_poll_fwdout(FAR struct net_driver_s *dev,
+                             devif_poll_callback_t callback)
+{
+  FAR struct iob_s *iob;
+  bool reused = false;
+  int bstop = false;
+
+  while (!bstop)
+    {
+      iob = ipfwd_flow_dequeue(dev);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      reused = true;
+
+      /* Replace original iob and account for the L2 header */
+
+      netdev_iob_replace(dev, iob);
+      dev->d_len += NET_LL_HDRLEN(dev);
+#ifdef CONFIG_NET_IPv6
+      IFF_SET_IPv4(dev->d_flags);
+#endif
+
+      /* Call back into the driver */
+
+      bstop = callback(dev);
+    }
+
+  /* Reuse iob buffer */
+
+  if (!bstop && reused)
+    {
+      iob_update_pktlen(dev->d_iob, 0, false);
+      netdev_iob_prepare(dev, true, 0);
+    }
+
+  return bstop;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_poll_forward
  *
@@ -510,6 +574,16 @@ static inline_function int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 static inline_function int devif_poll_forward(FAR struct net_driver_s *dev,
                                               devif_poll_callback_t callback)
 {
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* First send the packets of cached flows */
+
+  int bstop = devif_poll_fwdout(dev, callback);
+  if (bstop)
+    {
+      return bstop;
+    }
+#endif
+
   /* Perform the forwarding poll */
 
   ipfwd_poll(dev);
@@ -585,6 +659,111 @@ static inline_function int devif_poll_mld(FAR struct net_driver_s *dev,
 }
 #endif /* CONFIG_NET_MLD */
 
+/****************************************************************************
+ * Name: devif_ready_next
+ *
+ * Description:
+ *   Return the next connection to poll from the private copy of a device
+ *   ready list.  The caller moves the device list to readyq before the
+ *   first call so that each connection that was ready when the poll began
+ *   is visited once, even if it queues itself again while being polled.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_READYLIST
+static FAR void *devif_ready_next(FAR dq_queue_t *readyq)
+{
+  FAR struct socket_conn_s *conn;
+  FAR dq_entry_t *entry;
+
+  entry = dq_remfirst(readyq);
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  /* The TCP and UDP connection structures begin with struct socket_conn_s */
+
+  conn = container_of(entry, struct socket_conn_s, s_ready);
+  conn->s_readydev = NULL;
+  return conn;
+}
+
+/****************************************************************************
+ * Name: devif_ready_done
+ *
+ * Description:
+ *   Called after a connection taken from the ready list has been polled.
+ *   If it produced a packet it may well have more to send, and if no
+ *   device buffer was available it could not send at all; in both cases
+ *   put it back on the device list for the next poll.  Otherwise it stays
+ *   off the list until it notifies the device again.
+ *
+ ****************************************************************************/
+
+static void devif_ready_done(FAR struct net_driver_s *dev,
+                             FAR dq_queue_t *devq,
+                             FAR struct socket_conn_s *conn)
+{
+  if ((dev->d_len > 0 || dev->d_iob == NULL) && conn->s_readydev == NULL)
+    {
+      dq_addlast(&conn->s_ready, devq);
+      conn->s_readydev = dev;
+    }
+}
+
+/****************************************************************************
+ * Name: devif_ready_restore
+ *
+ * Description:
+ *   Give the connections not reached because the driver stopped the poll
+ *   back to the device, ahead of any that queued themselves meanwhile.
+ *   They are still marked as queued on this device.
+ *
+ ****************************************************************************/
+
+static void devif_ready_restore(FAR dq_queue_t *devq,
+                                FAR dq_queue_t *readyq)
+{
+  dq_cat(devq, readyq);
+  dq_move(readyq, devq);
+}
+
+/****************************************************************************
+ * Name: devif_ready_pending
+ *
+ * Description:
+ *   Return the poll types that still have connections on a ready list, so
+ *   that they are not dropped from d_polltype after a complete pass.
+ *
+ ****************************************************************************/
+
+static uint32_t devif_ready_pending(FAR struct net_driver_s *dev)
+{
+  uint32_t polltype = 0;
+
+#ifdef NET_TCP_HAVE_STACK
+  if (!dq_empty(&dev->d_tcpready))
+    {
+      polltype |= TCP_POLL;
+    }
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+  if (!dq_empty(&dev->d_udpready))
+    {
+      polltype |= UDP_POLL;
+    }
+#endif
+
+  return polltype;
+}
+#endif /* CONFIG_NETDEV_READYLIST */
+
 /****************************************************************************
  * Name: devif_poll_udp_connections
  *
@@ -603,6 +782,9 @@ devif_poll_udp_connections(FAR struct net_driver_s *dev,
                            devif_poll_callback_t callback)
 {
   FAR struct udp_conn_s *conn = NULL;
+#ifdef CONFIG_NETDEV_READYLIST
+  dq_queue_t readyq;
+#endif
   int bstop = 0;
 
   /* Traverse all of the allocated UDP connections and perform the poll
@@ -610,7 +792,12 @@ devif_poll_udp_connections(FAR struct net_driver_s *dev,
    */
 
   udp_conn_list_lock();
+#ifdef CONFIG_NETDEV_READYLIST
+  dq_move(&dev->d_udpready, &readyq);
+  while (!bstop && (conn = devif_ready_next(&readyq)) != NULL)
+#else
   while (!bstop && (conn = udp_nextconn(conn)))
+#endif
     {
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Skip UDP connections that are bound to other polling devices */
@@ -626,12 +813,20 @@ devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
           devif_packet_conversion(dev, DEVIF_UDP);
 
+#ifdef CONFIG_NETDEV_READYLIST
+          devif_ready_done(dev, &dev->d_udpready, &conn->sconn);
+#endif
+
           /* Call back into the driver */
 
           bstop = devif_poll_local_out(dev, callback);
         }
     }
 
+#ifdef CONFIG_NETDEV_READYLIST
+  devif_ready_restore(&dev->d_udpready, &readyq);
+#endif
+
   udp_conn_list_unlock();
   return bstop;
 }
@@ -655,12 +850,20 @@ devif_poll_tcp_connections(FAR struct net_driver_s *dev,
                            devif_poll_callback_t callback)
 {
   FAR struct tcp_conn_s *conn  = NULL;
+#ifdef CONFIG_NETDEV_READYLIST
+  dq_queue_t readyq;
+#endif
   int bstop = 0;
 
   /* Traverse all of the active TCP connections and perform the poll action */
 
   tcp_conn_list_lock();
+#ifdef CONFIG_NETDEV_READYLIST
+  dq_move(&dev->d_tcpready, &readyq);
+  while (!bstop && (conn = devif_ready_next(&readyq)) != NULL)
+#else
   while (!bstop && (conn = tcp_nextconn(conn)))
+#endif
     {
       /* Skip TCP connections that are bound to other polling devices */
 
@@ -674,12 +877,20 @@ devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 
           devif_packet_conversion(dev, DEVIF_TCP);
 
+#ifdef CONFIG_NETDEV_READYLIST
+          devif_ready_done(dev, &dev->d_tcpready, &conn->sconn);
+#endif
+
           /* Call back into the driver */
 
           bstop = devif_poll_local_out(dev, callback);
         }
     }
 
+#ifdef CONFIG_NETDEV_READYLIST
+  devif_ready_restore(&dev->d_tcpready, &readyq);
+#endif
+
   tcp_conn_list_unlock();
   return bstop;
 }
@@ -1002,6 +1213,12 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
         }
     }
 
+#ifdef CONFIG_NETDEV_READYLIST
+  /* Connections that sent on this pass may have more to send */
+
+  dev->d_polltype |= devif_ready_pending(dev);
+#endif
+
   return bstop;
 }
 
@@ -1268,6 +1485,9 @@ int devif_poll_out(FAR struct net_driver_s *dev,
 
   if (dev->d_len == 0)
     {
+      /* The packet was dropped, do not apply its GSO size to the next */
+
+      NETDEV_GSO_RESET(dev);
       return 0;
     }
 
@@ -116,7 +116,7 @@
  *   +-------------------+
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked.
  *
  ****************************************************************************/
 
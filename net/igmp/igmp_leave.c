@@ -122,7 +122,7 @@
  *   +-------------------+
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked.
  *
  ****************************************************************************/
 
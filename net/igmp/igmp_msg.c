@@ -47,6 +47,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <limits.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -54,6 +55,7 @@
 
 #include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "utils/utils.h"
 #include "igmp/igmp.h"
 
 #ifdef CONFIG_NET_IGMP
@@ -69,7 +71,7 @@
  *   Schedule a message to be send at the next driver polling interval.
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked.
  *
  ****************************************************************************/
 
@@ -119,7 +121,7 @@ int igmp_schedmsg(FAR struct igmp_group_s *group, uint8_t msgid)
  *   block, waiting for the message to be sent.
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked.
  *
  ****************************************************************************/
 
@@ -143,9 +145,12 @@ int igmp_waitmsg(FAR struct igmp_group_s *group, uint8_t msgid)
 
   while (IS_SCHEDMSG(group->flags))
     {
-      /* Wait for the semaphore to be posted */
+      /* Wait for the semaphore to be posted.  The device lock (if held)
+       * must be released so that the device can be polled to send it.
+       */
 
-      ret = nxsem_wait_uninterruptible(&group->sem);
+      ret = conn_dev_sem_timedwait(&group->sem, false, UINT_MAX, NULL,
+                                   netdev_findbyindex(group->ifindex));
       if (ret < 0)
         {
           break;
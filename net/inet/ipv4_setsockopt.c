@@ -147,6 +147,8 @@ int ipv4_setsockopt(FAR struct socket *psock, int option,
           else
             {
               FAR struct udp_conn_s *conn = psock->s_conn;
+              unsigned int count;
+              int blresult;
 
               /* Use the default network device is imr_interface is
                * INADDRY_ANY.
@@ -170,30 +172,64 @@ int ipv4_setsockopt(FAR struct socket *psock, int option,
                   nwarn("WARNING: Could not find device\n");
                   ret = -ENODEV;
                 }
-              else if (option == IP_ADD_MEMBERSHIP)
+              else if (option == IP_ADD_MEMBERSHIP &&
+                       conn->mreq.imr_multiaddr.s_addr != 0)
                 {
-                  if (conn->mreq.imr_multiaddr.s_addr != 0)
+                  ret = -EADDRINUSE;
+                }
+              else
+                {
+                  /* Claim the membership while the connection is still
+                   * locked, so that the EADDRINUSE check above and the
+                   * update are atomic against a concurrent join on the
+                   * same socket.
+                   */
+
+                  if (option == IP_ADD_MEMBERSHIP)
                     {
-                      ret = -EADDRINUSE;
+                      conn->mreq.imr_multiaddr = mrec->imr_multiaddr;
                     }
-                  else
+
+                  /* The device lock must be taken before the connection
+                   * lock, as is done on the input path.  The connection
+                   * stays unlocked while IGMP waits for the report to be
+                   * sent, so that input to this socket is not blocked.
+                   */
+
+                  blresult = nxrmutex_breaklock(&conn->sconn.s_lock, &count);
+                  netdev_lock(dev);
+                  if (option == IP_ADD_MEMBERSHIP)
                     {
                       ret = igmp_joingroup(dev, &mrec->imr_multiaddr);
+                    }
+                  else
+                    {
+                      ret = igmp_leavegroup(dev, &mrec->imr_multiaddr);
+                    }
+
+                  if (blresult >= 0)
+                    {
+                      nxrmutex_restorelock(&conn->sconn.s_lock, count);
+                    }
+
+                  if (option == IP_ADD_MEMBERSHIP)
+                    {
                       if (ret == OK)
                         {
-                          conn->mreq.imr_multiaddr = mrec->imr_multiaddr;
-                          conn->mreq.imr_ifindex   = dev->d_ifindex;
+                          conn->mreq.imr_ifindex = dev->d_ifindex;
+                        }
+                      else
+                        {
+                          conn->mreq.imr_multiaddr.s_addr = 0;
                         }
                     }
-                }
-              else
-                {
-                  ret = igmp_leavegroup(dev, &mrec->imr_multiaddr);
-                  if (ret == OK)
+                  else if (ret == OK)
                     {
                       conn->mreq.imr_multiaddr.s_addr = 0;
                       conn->mreq.imr_ifindex          = 0;
                     }
+
+                  netdev_unlock(dev);
                 }
             }
         }
@@ -37,6 +37,7 @@
 #include "icmp/icmp.h"
 #include "icmpv6/icmpv6.h"
 #include "ipfilter/ipfilter.h"
+#include "ipforward/ipforward.h"
 #include "utils/utils.h"
 
 #ifdef CONFIG_NET_IPFILTER
@@ -65,6 +66,12 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+#  define IPFILTER_COMPILED(comp) (comp)
+#else
+#  define IPFILTER_COMPILED(comp) NULL
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -76,6 +83,19 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+/* The chains compiled by ipfilter_cfg_commit(), NULL while a chain is being
+ * changed.
+ */
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+#  ifdef CONFIG_NET_IPv4
+static FAR struct ipfilter_compiled_s *g_ipv4_compiled[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static FAR struct ipfilter_compiled_s *g_ipv6_compiled[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -189,161 +209,297 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
 }
 
 /****************************************************************************
- * Name: ipv4_filter_match / ipv6_filter_match
+ * Name: ipfilter_compiled_slot
  *
  * Description:
- *   Match the input packet with the filter entries in the specified chain.
+ *   Return the location of the compiled chain of a family.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+static FAR struct ipfilter_compiled_s **
+ipfilter_compiled_slot(sa_family_t family, enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      return &g_ipv4_compiled[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      return &g_ipv6_compiled[chain];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipfilter_compiled_drop
+ *
+ * Description:
+ *   Free the compiled chain, the chain is matched entry by entry until it
+ *   is compiled again.
+ *
+ ****************************************************************************/
+
+static void ipfilter_compiled_drop(sa_family_t family,
+                                   enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_compiled_s **slot =
+    ipfilter_compiled_slot(family, chain);
+
+  if (slot != NULL && *slot != NULL)
+    {
+      ipfilter_compiled_free(*slot);
+      *slot = NULL;
+    }
+}
+#else
+#  define ipfilter_compiled_drop(family, chain)
+#endif
+
+/****************************************************************************
+ * Name: ipv4_filter_entry_match / ipv6_filter_entry_match
+ *
+ * Description:
+ *   Match a packet with one filter entry.
  *
  * Input Parameters:
- *   indev     - The network device that the packet comes from
- *   outdev    - The network device that the packet goes to
- *   ipv4/ipv6 - The IPv4/IPv6 header
- *   chain     - The chain to match the filter entries
+ *   entry - The filter entry to match
+ *   pkt   - The packet
  *
  * Returned Value:
- *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
- *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
- *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *   true  - The packet is matched
+ *   false - The packet is not matched
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int ipv4_filter_match(FAR const struct net_driver_s *indev,
-                             FAR const struct net_driver_s *outdev,
-                             FAR const struct ipv4_hdr_s *ipv4,
-                             enum ipfilter_chain_e chain)
+static bool ipv4_filter_entry_match(FAR const struct ipfilter_entry_s *entry,
+                                    FAR const struct ipfilter_packet_s *pkt)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
+  FAR const struct ipv4_filter_entry_s *filter =
+    (FAR const struct ipv4_filter_entry_s *)entry;
+  FAR const struct ipv4_hdr_s *ipv4 = pkt->iphdr;
   in_addr_t ipaddr;
   bool matched;
 
-  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+  /* Match device */
 
-  if ((indev == NULL && outdev == NULL) || ipv4 == NULL)
+  if (!ipfilter_match_device(entry, pkt->indev, pkt->outdev))
     {
-      return IPFILTER_TARGET_ACCEPT;
+      return false;
     }
 
-  l4hdr = IPv4_L4HDR(ipv4);
+  /* Match addresses */
 
-  sq_for_every(queue, entry)
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ entry->inv_srcip;
+  if (!matched)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
+      return false;
+    }
 
-      /* Match device */
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ entry->inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
+  /* Match protocol */
 
-      /* Match addresses */
+  return ipfilter_match_proto(entry, pkt->l4hdr, pkt->proto);
+}
+#endif
 
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+#ifdef CONFIG_NET_IPv6
+static bool ipv6_filter_entry_match(FAR const struct ipfilter_entry_s *entry,
+                                    FAR const struct ipfilter_packet_s *pkt)
+{
+  FAR const struct ipv6_filter_entry_s *filter =
+    (FAR const struct ipv6_filter_entry_s *)entry;
+  FAR const struct ipv6_hdr_s *ipv6 = pkt->iphdr;
+  bool matched;
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+  /* Match device */
 
-      /* Match protocol */
+  if (!ipfilter_match_device(entry, pkt->indev, pkt->outdev))
+    {
+      return false;
+    }
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
-        {
-          continue;
-        }
+  /* Match addresses */
 
-      /* Return the target action if matched. */
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ entry->inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
 
-      return filter->common.target;
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ entry->inv_dstip;
+  if (!matched)
+    {
+      return false;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  /* Match protocol */
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  return ipfilter_match_proto(entry, pkt->l4hdr, pkt->proto);
 }
 #endif
 
-#ifdef CONFIG_NET_IPv6
-static int ipv6_filter_match(FAR const struct net_driver_s *indev,
-                             FAR const struct net_driver_s *outdev,
-                             FAR const struct ipv6_hdr_s *ipv6,
-                             enum ipfilter_chain_e chain)
+/****************************************************************************
+ * Name: ipfilter_match_chain
+ *
+ * Description:
+ *   Find the first entry of a chain that matches the packet and update its
+ *   counters.
+ *
+ * Input Parameters:
+ *   queue - The entries of the chain
+ *   comp  - The compiled chain, if any
+ *   pkt   - The packet
+ *   src   - IPv4 source address of the packet, used by the compiled chain
+ *   dst   - IPv4 destination address of the packet
+ *   len   - The length of the packet
+ *   match - The function that matches one entry
+ *
+ * Returned Value:
+ *   The target of the matching entry.
+ *
+ ****************************************************************************/
+
+static int ipfilter_match_chain(FAR const sq_queue_t *queue,
+                                FAR const struct ipfilter_compiled_s *comp,
+                                FAR const struct ipfilter_packet_s *pkt,
+                                in_addr_t src, in_addr_t dst, uint16_t len,
+                                ipfilter_match_t match)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
-  uint8_t proto;
-  bool matched;
+  FAR struct ipfilter_entry_s *entry = NULL;
+  FAR sq_entry_t *node;
 
-  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  if (comp != NULL)
+    {
+      entry = ipfilter_compiled_match(comp, pkt, src, dst, match);
+    }
+  else
+#endif
+    {
+      sq_for_every(queue, node)
+        {
+          if (match((FAR struct ipfilter_entry_s *)node, pkt))
+            {
+              entry = (FAR struct ipfilter_entry_s *)node;
+              break;
+            }
+        }
+    }
 
-  if ((indev == NULL && outdev == NULL) || ipv6 == NULL)
+  if (entry == NULL)
     {
+      /* Normally there should be a default rule in chain, won't reach
+       * here.
+       */
+
+      ninfo("No filter matched, maybe uninitialized.\n");
       return IPFILTER_TARGET_ACCEPT;
     }
 
-  l4hdr = IPv6_L4HDR(ipv6, proto);
+  entry->pcnt++;
+  entry->bcnt += len;
 
-  sq_for_every(queue, entry)
-    {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
+  /* Return the target action if matched. */
 
-      /* Match device */
+  return entry->target;
+}
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
+/****************************************************************************
+ * Name: ipv4_filter_match / ipv6_filter_match
+ *
+ * Description:
+ *   Match the input packet with the filter entries in the specified chain.
+ *
+ * Input Parameters:
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   chain     - The chain to match the filter entries
+ *
+ * Returned Value:
+ *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
+ *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
+ *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *
+ ****************************************************************************/
 
-      /* Match addresses */
+#ifdef CONFIG_NET_IPv4
+static int ipv4_filter_match(FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv4_hdr_s *ipv4,
+                             enum ipfilter_chain_e chain)
+{
+  struct ipfilter_packet_s pkt;
 
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+  if ((indev == NULL && outdev == NULL) || ipv4 == NULL)
+    {
+      return IPFILTER_TARGET_ACCEPT;
+    }
 
-      /* Match protocol */
+  pkt.indev  = indev;
+  pkt.outdev = outdev;
+  pkt.iphdr  = ipv4;
+  pkt.l4hdr  = IPv4_L4HDR(ipv4);
+  pkt.proto  = ipv4->proto;
+
+  return ipfilter_match_chain(&g_ipv4_filters[chain],
+                              IPFILTER_COMPILED(g_ipv4_compiled[chain]),
+                              &pkt, net_ip4addr_conv32(ipv4->srcipaddr),
+                              net_ip4addr_conv32(ipv4->destipaddr),
+                              (ipv4->len[0] << 8) + ipv4->len[1],
+                              ipv4_filter_entry_match);
+}
+#endif
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
-        {
-          continue;
-        }
+#ifdef CONFIG_NET_IPv6
+static int ipv6_filter_match(FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv6_hdr_s *ipv6,
+                             enum ipfilter_chain_e chain)
+{
+  struct ipfilter_packet_s pkt;
 
-      /* Return the target action if matched. */
+  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
-      return filter->common.target;
+  if ((indev == NULL && outdev == NULL) || ipv6 == NULL)
+    {
+      return IPFILTER_TARGET_ACCEPT;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
-
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  pkt.indev  = indev;
+  pkt.outdev = outdev;
+  pkt.iphdr  = ipv6;
+  pkt.l4hdr  = IPv6_L4HDR(ipv6, pkt.proto);
+
+  return ipfilter_match_chain(&g_ipv6_filters[chain],
+                              IPFILTER_COMPILED(g_ipv6_compiled[chain]),
+                              &pkt, INADDR_ANY, INADDR_ANY,
+                              IPv6_HDRLEN + ((ipv6->len[0] << 8) +
+                                             ipv6->len[1]),
+                              ipv6_filter_entry_match);
 }
 #endif
 
@@ -407,10 +563,13 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain)
 {
+  ipfilter_compiled_drop(family, chain);
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+      ipfwd_flow_flush(NULL);
     }
 #endif
 
@@ -440,6 +599,8 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 {
+  ipfilter_compiled_drop(family, chain);
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
@@ -448,6 +609,8 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         {
           kmm_free(sq_remfirst(queue));
         }
+
+      ipfwd_flow_flush(NULL);
     }
 #endif
 
@@ -463,6 +626,108 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 #endif
 }
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Called after the entries of a chain have been changed.  With
+ *   CONFIG_NET_IPFILTER_COMPILE the chain is compiled into lookup tables
+ *   here; until then the chain is matched entry by entry.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain that was changed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+void ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_compiled_s **slot;
+  FAR sq_queue_t *queue = NULL;
+
+  ipfilter_compiled_drop(family, chain);
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      queue = &g_ipv4_filters[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      queue = &g_ipv6_filters[chain];
+    }
+#endif
+
+  slot = ipfilter_compiled_slot(family, chain);
+  if (queue == NULL || slot == NULL)
+    {
+      return;
+    }
+
+  /* If the chain can not be compiled it is still matched linearly */
+
+  *slot = ipfilter_compile(family, queue);
+  if (*slot == NULL)
+    {
+      nwarn("WARNING: Failed to compile filter chain %d\n", chain);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_cfg_foreach
+ *
+ * Description:
+ *   Call a handler for each filter configuration entry in a chain, in
+ *   order.
+ *
+ * Input Parameters:
+ *   family  - The address family of the chain
+ *   chain   - The chain to traverse
+ *   handler - The function to call
+ *   arg     - An argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipfilter_cfg_foreach(sa_family_t family, enum ipfilter_chain_e chain,
+                          ipfilter_handler_t handler, FAR void *arg)
+{
+  FAR sq_queue_t *queue = NULL;
+  FAR sq_entry_t *node;
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      queue = &g_ipv4_filters[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      queue = &g_ipv6_filters[chain];
+    }
+#endif
+
+  if (queue != NULL)
+    {
+      sq_for_every(queue, node)
+        {
+          handler((FAR struct ipfilter_entry_s *)node, arg);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
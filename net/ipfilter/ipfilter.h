@@ -29,9 +29,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/ip.h>
 
 #ifdef CONFIG_NET_IPFILTER
@@ -97,6 +99,12 @@ struct ipfilter_entry_s
   uint8_t inv_sport  : 1; /* Inverse source port */
   uint8_t inv_dport  : 1; /* Inverse destination port */
   uint8_t inv_icmp   : 1; /* Inverse ICMP type */
+
+  /* Statistics, reported as the counters of the iptables entry */
+
+  uint32_t offset;        /* Offset of the iptables entry in its table */
+  uint64_t pcnt;          /* Number of packets matched */
+  uint64_t bcnt;          /* Number of bytes matched */
 };
 
 struct ipv4_filter_entry_s
@@ -123,6 +131,26 @@ struct ipv6_filter_entry_s
   net_ipv6addr_t dmsk;
 };
 
+/* A packet being matched against the filter entries */
+
+struct ipfilter_packet_s
+{
+  FAR const struct net_driver_s *indev;  /* Device the packet comes from */
+  FAR const struct net_driver_s *outdev; /* Device the packet goes to */
+  FAR const void *iphdr;                 /* IPv4 or IPv6 header */
+  FAR const void *l4hdr;                 /* Transport layer header */
+  uint8_t proto;                         /* Transport layer protocol */
+};
+
+typedef bool (*ipfilter_match_t)(FAR const struct ipfilter_entry_s *entry,
+                                 FAR const struct ipfilter_packet_s *pkt);
+typedef void (*ipfilter_handler_t)(FAR struct ipfilter_entry_s *entry,
+                                   FAR void *arg);
+
+/* A filter chain compiled into lookup tables (opaque) */
+
+struct ipfilter_compiled_s;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -182,6 +210,114 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Called after the entries of a chain have been changed.  With
+ *   CONFIG_NET_IPFILTER_COMPILE the chain is compiled into lookup tables
+ *   here; until then the chain is matched entry by entry.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain that was changed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+void ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain);
+#else
+#  define ipfilter_cfg_commit(family, chain)
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_cfg_foreach
+ *
+ * Description:
+ *   Call a handler for each filter configuration entry in a chain, in
+ *   order.
+ *
+ * Input Parameters:
+ *   family  - The address family of the chain
+ *   chain   - The chain to traverse
+ *   handler - The function to call
+ *   arg     - An argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipfilter_cfg_foreach(sa_family_t family, enum ipfilter_chain_e chain,
+                          ipfilter_handler_t handler, FAR void *arg);
+
+/****************************************************************************
+ * Name: ipfilter_compile
+ *
+ * Description:
+ *   Compile a filter chain into lookup tables: TCP/UDP entries for a few
+ *   destination ports are hashed by protocol and port, IPv4 entries for an
+ *   address prefix are put into tables of address ranges and the remaining
+ *   entries are listed per protocol.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   queue  - The entries of the chain
+ *
+ * Returned Value:
+ *   The compiled chain, NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+FAR struct ipfilter_compiled_s *ipfilter_compile(sa_family_t family,
+                                                 FAR sq_queue_t *queue);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_compiled_free
+ *
+ * Description:
+ *   Free a compiled filter chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+void ipfilter_compiled_free(FAR struct ipfilter_compiled_s *comp);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_compiled_match
+ *
+ * Description:
+ *   Find the first entry of a compiled chain that matches a packet.  Only
+ *   the entries that may match the protocol, the destination port and the
+ *   addresses of the packet are passed to the match function, in chain
+ *   order.
+ *
+ * Input Parameters:
+ *   comp    - The compiled chain
+ *   pkt     - The packet
+ *   srcaddr - IPv4 source address of the packet (network order)
+ *   dstaddr - IPv4 destination address of the packet (network order)
+ *   match   - The function that matches one entry
+ *
+ * Returned Value:
+ *   The first matching entry, NULL if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+FAR struct ipfilter_entry_s *
+ipfilter_compiled_match(FAR const struct ipfilter_compiled_s *comp,
+                        FAR const struct ipfilter_packet_s *pkt,
+                        in_addr_t srcaddr, in_addr_t dstaddr,
+                        ipfilter_match_t match);
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
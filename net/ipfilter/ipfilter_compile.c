@@ -0,0 +1,774 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_compile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each entry of a compiled chain is put into exactly one of the lookup
+ * tables below, tried in this order:
+ *
+ *   - TCP/UDP entries for a few destination ports are hashed by protocol
+ *     and port.
+ *   - IPv4 entries for a destination (then source) address prefix are put
+ *     into a table of non-overlapping address ranges, each range listing
+ *     the entries that cover it.
+ *   - All other entries are listed per class of protocol.
+ *
+ * A packet looks up one list in each table, the lists are merged in chain
+ * order and only the entries on them are matched.
+ */
+
+#define IPFILTER_RANGE_DST   0
+#define IPFILTER_RANGE_SRC   1
+#define IPFILTER_RANGE_MAX   2
+
+#define IPFILTER_CLASS_TCP   0
+#define IPFILTER_CLASS_UDP   1
+#define IPFILTER_CLASS_ICMP  2
+#define IPFILTER_CLASS_OTHER 3
+#define IPFILTER_CLASS_MAX   4
+
+#define IPFILTER_PORT_KEY(proto, port) (((uint32_t)(proto) << 16) | (port))
+#define IPFILTER_PORT_HASH(key)        (((key) * 0x9e3779b1u) >> 16)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A list of entry indexes in the pool, in chain order */
+
+struct ipfilter_list_s
+{
+  uint32_t first;
+  uint16_t count;
+};
+
+/* A bucket of the destination port hash */
+
+struct ipfilter_bucket_s
+{
+  uint32_t key;                  /* IPFILTER_PORT_KEY(), 0 = unused */
+  struct ipfilter_list_s list;
+};
+
+/* An address range, ending where the next one starts */
+
+struct ipfilter_segment_s
+{
+  uint32_t start;                /* First address, host byte order */
+  struct ipfilter_list_s list;
+};
+
+struct ipfilter_ranges_s
+{
+  FAR struct ipfilter_segment_s *segs;
+  uint32_t nsegs;
+};
+
+struct ipfilter_compiled_s
+{
+  FAR struct ipfilter_entry_s **entries; /* The entries in chain order */
+  FAR uint16_t *pool;                    /* Storage of all lists */
+  uint32_t npool;
+  uint16_t nentries;
+
+  FAR struct ipfilter_bucket_s *buckets;
+  uint32_t nbuckets;                     /* Power of two */
+
+  struct ipfilter_ranges_s ranges[IPFILTER_RANGE_MAX];
+  struct ipfilter_list_s any[IPFILTER_CLASS_MAX];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_class
+ *
+ * Description:
+ *   Return the class of a protocol.
+ *
+ ****************************************************************************/
+
+static int ipfilter_class(uint8_t proto)
+{
+  switch (proto)
+    {
+      case IP_PROTO_TCP:
+        return IPFILTER_CLASS_TCP;
+
+      case IP_PROTO_UDP:
+        return IPFILTER_CLASS_UDP;
+
+      case IP_PROTO_ICMP:
+      case IP_PROTO_ICMP6:
+        return IPFILTER_CLASS_ICMP;
+
+      default:
+        return IPFILTER_CLASS_OTHER;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_nports
+ *
+ * Description:
+ *   Return the number of destination ports an entry is hashed for, 0 if
+ *   the entry does not go into the port hash.
+ *
+ ****************************************************************************/
+
+static uint32_t ipfilter_nports(FAR const struct ipfilter_entry_s *entry)
+{
+  uint32_t nports;
+
+  if (!entry->match_tcpudp || entry->inv_proto || entry->inv_dport ||
+      (entry->proto != IP_PROTO_TCP && entry->proto != IP_PROTO_UDP) ||
+      entry->match.tcpudp.dports[0] > entry->match.tcpudp.dports[1])
+    {
+      return 0;
+    }
+
+  nports = entry->match.tcpudp.dports[1] -
+           entry->match.tcpudp.dports[0] + 1;
+  return nports <= CONFIG_NET_IPFILTER_COMPILE_MAXPORTS ? nports : 0;
+}
+
+/****************************************************************************
+ * Name: ipfilter_range
+ *
+ * Description:
+ *   Get the address range an IPv4 entry matches for the destination or the
+ *   source address.
+ *
+ * Returned Value:
+ *   true if the entry goes into the range table, false otherwise.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_range(sa_family_t family,
+                           FAR const struct ipfilter_entry_s *entry,
+                           int range, FAR uint32_t *lo, FAR uint32_t *hi)
+{
+  FAR const struct ipv4_filter_entry_s *filter;
+  uint32_t mask;
+  uint32_t addr;
+
+  if (family != PF_INET)
+    {
+      return false;
+    }
+
+  filter = (FAR const struct ipv4_filter_entry_s *)entry;
+  if (range == IPFILTER_RANGE_DST)
+    {
+      if (entry->inv_dstip)
+        {
+          return false;
+        }
+
+      mask = NTOHL(filter->dmsk);
+      addr = NTOHL(filter->dip);
+    }
+  else
+    {
+      if (entry->inv_srcip)
+        {
+          return false;
+        }
+
+      mask = NTOHL(filter->smsk);
+      addr = NTOHL(filter->sip);
+    }
+
+  /* Only prefixes are ranges, "any address" is left to the other tables */
+
+  if (mask == 0 || (~mask & (~mask + 1)) != 0)
+    {
+      return false;
+    }
+
+  *lo = addr & mask;
+  *hi = *lo | ~mask;
+  return true;
+}
+
+/****************************************************************************
+ * Name: ipfilter_list_add
+ *
+ * Description:
+ *   Count an entry on a list, or store it once the pool is allocated.
+ *
+ ****************************************************************************/
+
+static void ipfilter_list_add(FAR struct ipfilter_compiled_s *comp,
+                              FAR struct ipfilter_list_s *list,
+                              uint16_t index)
+{
+  if (comp->pool != NULL)
+    {
+      comp->pool[list->first + list->count] = index;
+    }
+
+  list->count++;
+}
+
+/****************************************************************************
+ * Name: ipfilter_bucket
+ *
+ * Description:
+ *   Find the bucket of a port key, or the free bucket to put it into.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_bucket_s *
+ipfilter_bucket(FAR const struct ipfilter_compiled_s *comp, uint32_t key)
+{
+  uint32_t mask = comp->nbuckets - 1;
+  uint32_t i = IPFILTER_PORT_HASH(key) & mask;
+
+  while (comp->buckets[i].key != 0 && comp->buckets[i].key != key)
+    {
+      i = (i + 1) & mask;
+    }
+
+  return &comp->buckets[i];
+}
+
+/****************************************************************************
+ * Name: ipfilter_segment
+ *
+ * Description:
+ *   Find the address range an address falls into.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_segment_s *
+ipfilter_segment(FAR const struct ipfilter_ranges_s *ranges, uint32_t addr)
+{
+  uint32_t low = 0;
+  uint32_t high = ranges->nsegs;
+
+  /* The first range always starts at 0 */
+
+  while (high - low > 1)
+    {
+      uint32_t mid = (low + high) / 2;
+
+      if (ranges->segs[mid].start <= addr)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return &ranges->segs[low];
+}
+
+/****************************************************************************
+ * Name: ipfilter_compare
+ *
+ * Description:
+ *   qsort() comparison of range boundaries.
+ *
+ ****************************************************************************/
+
+static int ipfilter_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: ipfilter_build_ranges
+ *
+ * Description:
+ *   Split the address space at the boundaries of the ranges of the entries
+ *   that go into a range table.
+ *
+ ****************************************************************************/
+
+static int ipfilter_build_ranges(FAR struct ipfilter_compiled_s *comp,
+                                 sa_family_t family, int range,
+                                 FAR const uint8_t *placed)
+{
+  FAR struct ipfilter_ranges_s *ranges = &comp->ranges[range];
+  FAR uint32_t *bounds;
+  uint32_t nbounds = 1;
+  uint32_t lo;
+  uint32_t hi;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0; i < comp->nentries; i++)
+    {
+      if (placed[i] == range)
+        {
+          nbounds += 2;
+        }
+    }
+
+  if (nbounds == 1)
+    {
+      return OK;
+    }
+
+  bounds = kmm_malloc(nbounds * sizeof(uint32_t));
+  if (bounds == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  bounds[0] = 0;
+  nbounds = 1;
+  for (i = 0; i < comp->nentries; i++)
+    {
+      if (placed[i] == range)
+        {
+          ipfilter_range(family, comp->entries[i], range, &lo, &hi);
+          bounds[nbounds++] = lo;
+          if (hi != UINT32_MAX)
+            {
+              bounds[nbounds++] = hi + 1;
+            }
+        }
+    }
+
+  qsort(bounds, nbounds, sizeof(uint32_t), ipfilter_compare);
+
+  ranges->segs = kmm_zalloc(nbounds * sizeof(struct ipfilter_segment_s));
+  if (ranges->segs == NULL)
+    {
+      kmm_free(bounds);
+      return -ENOMEM;
+    }
+
+  for (i = 0, j = 0; i < nbounds; i++)
+    {
+      if (j == 0 || bounds[i] != ranges->segs[j - 1].start)
+        {
+          ranges->segs[j++].start = bounds[i];
+        }
+    }
+
+  ranges->nsegs = j;
+  kmm_free(bounds);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfilter_place
+ *
+ * Description:
+ *   Put an entry on the lists of the table chosen for it.
+ *
+ ****************************************************************************/
+
+static void ipfilter_place(FAR struct ipfilter_compiled_s *comp,
+                           sa_family_t family, uint16_t index,
+                           uint8_t placed)
+{
+  FAR struct ipfilter_entry_s *entry = comp->entries[index];
+  FAR struct ipfilter_ranges_s *ranges;
+  FAR struct ipfilter_bucket_s *bucket;
+  uint32_t port;
+  uint32_t key;
+  uint32_t lo;
+  uint32_t hi;
+  uint32_t i;
+  int class;
+
+  if (placed < IPFILTER_RANGE_MAX)
+    {
+      /* The ranges are the smallest pieces of the address space, so each
+       * of them is either inside of the range of the entry or outside.
+       */
+
+      ranges = &comp->ranges[placed];
+      ipfilter_range(family, entry, placed, &lo, &hi);
+      for (i = 0; i < ranges->nsegs && ranges->segs[i].start <= hi; i++)
+        {
+          if (ranges->segs[i].start >= lo)
+            {
+              ipfilter_list_add(comp, &ranges->segs[i].list, index);
+            }
+        }
+    }
+  else if (ipfilter_nports(entry) > 0)
+    {
+      for (port = entry->match.tcpudp.dports[0];
+           port <= entry->match.tcpudp.dports[1]; port++)
+        {
+          key = IPFILTER_PORT_KEY(entry->proto, port);
+          bucket = ipfilter_bucket(comp, key);
+          bucket->key = key;
+          ipfilter_list_add(comp, &bucket->list, index);
+        }
+    }
+  else
+    {
+      for (class = 0; class < IPFILTER_CLASS_MAX; class++)
+        {
+          if (entry->proto == 0 || entry->inv_proto ||
+              ipfilter_class(entry->proto) == class)
+            {
+              ipfilter_list_add(comp, &comp->any[class], index);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_alloc_pool
+ *
+ * Description:
+ *   Allocate the pool for the counted lists and let each list start at its
+ *   place in the pool.
+ *
+ ****************************************************************************/
+
+static int ipfilter_alloc_pool(FAR struct ipfilter_compiled_s *comp)
+{
+  FAR struct ipfilter_list_s *list;
+  uint32_t total = 0;
+  uint32_t i;
+  int r;
+
+  for (i = 0; i < comp->nbuckets; i++)
+    {
+      list = &comp->buckets[i].list;
+      list->first = total;
+      total += list->count;
+      list->count = 0;
+    }
+
+  for (r = 0; r < IPFILTER_RANGE_MAX; r++)
+    {
+      for (i = 0; i < comp->ranges[r].nsegs; i++)
+        {
+          list = &comp->ranges[r].segs[i].list;
+          list->first = total;
+          total += list->count;
+          list->count = 0;
+        }
+    }
+
+  for (i = 0; i < IPFILTER_CLASS_MAX; i++)
+    {
+      list = &comp->any[i];
+      list->first = total;
+      total += list->count;
+      list->count = 0;
+    }
+
+  comp->pool = kmm_malloc((total > 0 ? total : 1) * sizeof(uint16_t));
+  if (comp->pool == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  comp->npool = total;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_compile
+ *
+ * Description:
+ *   Compile a filter chain into lookup tables: TCP/UDP entries for a few
+ *   destination ports are hashed by protocol and port, IPv4 entries for an
+ *   address prefix are put into tables of address ranges and the remaining
+ *   entries are listed per protocol.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   queue  - The entries of the chain
+ *
+ * Returned Value:
+ *   The compiled chain, NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_compiled_s *ipfilter_compile(sa_family_t family,
+                                                 FAR sq_queue_t *queue)
+{
+  FAR struct ipfilter_compiled_s *comp;
+  FAR sq_entry_t *node;
+  FAR uint8_t *placed = NULL;
+  uint32_t nentries = 0;
+  uint32_t nports = 0;
+  uint32_t lo;
+  uint32_t hi;
+  uint32_t i;
+  int r;
+
+  sq_for_every(queue, node)
+    {
+      nentries++;
+    }
+
+  if (nentries == 0 || nentries > UINT16_MAX)
+    {
+      return NULL;
+    }
+
+  comp = kmm_zalloc(sizeof(*comp));
+  if (comp == NULL)
+    {
+      return NULL;
+    }
+
+  comp->nentries = nentries;
+  comp->entries  = kmm_malloc(nentries * sizeof(*comp->entries));
+  placed         = kmm_malloc(nentries);
+  if (comp->entries == NULL || placed == NULL)
+    {
+      goto errout;
+    }
+
+  /* Choose the table of each entry */
+
+  i = 0;
+  sq_for_every(queue, node)
+    {
+      FAR struct ipfilter_entry_s *entry = (FAR struct ipfilter_entry_s *)
+                                           node;
+
+      comp->entries[i] = entry;
+      placed[i] = IPFILTER_RANGE_MAX;
+      nports += ipfilter_nports(entry);
+
+      for (r = 0; r < IPFILTER_RANGE_MAX; r++)
+        {
+          if (ipfilter_nports(entry) == 0 &&
+              ipfilter_range(family, entry, r, &lo, &hi))
+            {
+              placed[i] = r;
+              break;
+            }
+        }
+
+      i++;
+    }
+
+  for (r = 0; r < IPFILTER_RANGE_MAX; r++)
+    {
+      if (ipfilter_build_ranges(comp, family, r, placed) < 0)
+        {
+          goto errout;
+        }
+    }
+
+  if (nports > 0)
+    {
+      comp->nbuckets = 8;
+      while (comp->nbuckets < 2 * nports)
+        {
+          comp->nbuckets <<= 1;
+        }
+
+      comp->buckets = kmm_zalloc(comp->nbuckets *
+                                 sizeof(struct ipfilter_bucket_s));
+      if (comp->buckets == NULL)
+        {
+          goto errout;
+        }
+    }
+
+  /* Count the entries on each list, then fill the lists in chain order so
+   * that they stay sorted.
+   */
+
+  for (i = 0; i < nentries; i++)
+    {
+      ipfilter_place(comp, family, i, placed[i]);
+    }
+
+  if (ipfilter_alloc_pool(comp) < 0)
+    {
+      goto errout;
+    }
+
+  for (i = 0; i < nentries; i++)
+    {
+      ipfilter_place(comp, family, i, placed[i]);
+    }
+
+  kmm_free(placed);
+  return comp;
+
+errout:
+  kmm_free(placed);
+  ipfilter_compiled_free(comp);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipfilter_compiled_free
+ *
+ * Description:
+ *   Free a compiled filter chain.
+ *
+ ****************************************************************************/
+
+void ipfilter_compiled_free(FAR struct ipfilter_compiled_s *comp)
+{
+  int r;
+
+  for (r = 0; r < IPFILTER_RANGE_MAX; r++)
+    {
+      kmm_free(comp->ranges[r].segs);
+    }
+
+  kmm_free(comp->buckets);
+  kmm_free(comp->pool);
+  kmm_free(comp->entries);
+  kmm_free(comp);
+}
+
+/****************************************************************************
+ * Name: ipfilter_compiled_match
+ *
+ * Description:
+ *   Find the first entry of a compiled chain that matches a packet.  Only
+ *   the entries that may match the protocol, the destination port and the
+ *   addresses of the packet are passed to the match function, in chain
+ *   order.
+ *
+ * Input Parameters:
+ *   comp    - The compiled chain
+ *   pkt     - The packet
+ *   srcaddr - IPv4 source address of the packet (network order)
+ *   dstaddr - IPv4 destination address of the packet (network order)
+ *   match   - The function that matches one entry
+ *
+ * Returned Value:
+ *   The first matching entry, NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *
+ipfilter_compiled_match(FAR const struct ipfilter_compiled_s *comp,
+                        FAR const struct ipfilter_packet_s *pkt,
+                        in_addr_t srcaddr, in_addr_t dstaddr,
+                        ipfilter_match_t match)
+{
+  FAR const struct ipfilter_list_s *lists[IPFILTER_RANGE_MAX + 2];
+  FAR const struct ipfilter_bucket_s *bucket;
+  uint16_t pos[IPFILTER_RANGE_MAX + 2];
+  uint32_t best;
+  int nlists = 0;
+  int chosen;
+  int i;
+
+  lists[nlists++] = &comp->any[ipfilter_class(pkt->proto)];
+
+  if (comp->buckets != NULL &&
+      (pkt->proto == IP_PROTO_TCP || pkt->proto == IP_PROTO_UDP))
+    {
+      /* Ports in TCP & UDP headers have same offset. */
+
+      FAR const struct udp_hdr_s *udp = pkt->l4hdr;
+
+      bucket = ipfilter_bucket(comp,
+                               IPFILTER_PORT_KEY(pkt->proto,
+                                                 NTOHS(udp->destport)));
+      if (bucket->key != 0)
+        {
+          lists[nlists++] = &bucket->list;
+        }
+    }
+
+  if (comp->ranges[IPFILTER_RANGE_DST].nsegs > 0)
+    {
+      lists[nlists++] = &ipfilter_segment(&comp->ranges[IPFILTER_RANGE_DST],
+                                          NTOHL(dstaddr))->list;
+    }
+
+  if (comp->ranges[IPFILTER_RANGE_SRC].nsegs > 0)
+    {
+      lists[nlists++] = &ipfilter_segment(&comp->ranges[IPFILTER_RANGE_SRC],
+                                          NTOHL(srcaddr))->list;
+    }
+
+  memset(pos, 0, sizeof(pos));
+
+  /* An entry is on one list at most, merge the lists by chain order */
+
+  for (; ; )
+    {
+      best   = UINT32_MAX;
+      chosen = -1;
+
+      for (i = 0; i < nlists; i++)
+        {
+          if (pos[i] < lists[i]->count &&
+              comp->pool[lists[i]->first + pos[i]] < best)
+            {
+              best   = comp->pool[lists[i]->first + pos[i]];
+              chosen = i;
+            }
+        }
+
+      if (chosen < 0)
+        {
+          return NULL;
+        }
+
+      pos[chosen]++;
+      if (match(comp->entries[best], pkt))
+        {
+          return comp->entries[best];
+        }
+    }
+}
+
+#endif /* CONFIG_NET_IPFILTER_COMPILE */
@@ -29,9 +29,14 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+#include <net/ethernet.h>
+#include <netinet/in.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -76,6 +81,30 @@ struct forward_s
 #endif
 };
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+/* The key of a forwarded flow, taken from the packet as it was received */
+
+struct ipfwd_flowkey_s
+{
+  FAR struct net_driver_s *fk_dev;        /* Receiving device */
+  in_addr_t                fk_srcaddr;    /* Source address */
+  in_addr_t                fk_dstaddr;    /* Destination address */
+  uint16_t                 fk_srcport;    /* Source port */
+  uint16_t                 fk_dstport;    /* Destination port */
+  uint8_t                  fk_proto;      /* IP_PROTO_TCP or IP_PROTO_UDP */
+};
+
+/* A flow cache entry */
+
+struct ipfwd_flow_s
+{
+  struct ipfwd_flowkey_s   fl_key;        /* The flow */
+  FAR struct net_driver_s *fl_dev;        /* Forwarding device, NULL: free */
+  clock_t                  fl_time;       /* Time the entry was created */
+  uint8_t                  fl_ethaddr[ETHER_ADDR_LEN]; /* Next hop MAC */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -355,5 +384,133 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flow_key
+ *
+ * Description:
+ *   Get the flow cache key of a received IPv4 packet.  Only unfragmented
+ *   TCP and UDP packets are handled by the flow cache.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received
+ *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet
+ *   key   - Location to return the key
+ *
+ * Returned Value:
+ *   True if the packet may be handled by the flow cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+bool ipv4_flow_key(FAR struct net_driver_s *dev,
+                   FAR struct ipv4_hdr_s *ipv4,
+                   FAR struct ipfwd_flowkey_s *key);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_lookup
+ *
+ * Description:
+ *   Look up a flow in the flow cache.
+ *
+ * Input Parameters:
+ *   key   - The flow to look up
+ *   flow  - Location to return a copy of the flow cache entry
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the flow was found; -ENOENT otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipv4_flow_lookup(FAR const struct ipfwd_flowkey_s *key,
+                     FAR struct ipfwd_flow_s *flow);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_add
+ *
+ * Description:
+ *   Remember the forwarding device of a flow after its packet was accepted
+ *   by the normal forwarding path.  Nothing is remembered if the next hop
+ *   can not be resolved without sending a packet.
+ *
+ * Input Parameters:
+ *   key     - The flow
+ *   fwddev  - The device on which the flow is forwarded
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipv4_flow_add(FAR const struct ipfwd_flowkey_s *key,
+                   FAR struct net_driver_s *fwddev);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_send
+ *
+ * Description:
+ *   Build the L2 header of a packet of a cached flow and queue it for
+ *   transmission on the forwarding device.
+ *
+ * Input Parameters:
+ *   flow  - The flow cache entry of the packet
+ *   iob   - The IOB chain containing the packet, starting with the L3
+ *           header
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the packet was queued and the IOB chain now
+ *   belongs to the forwarding device.  A negated errno value is returned
+ *   on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipfwd_flow_send(FAR const struct ipfwd_flow_s *flow,
+                    FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_dequeue
+ *
+ * Description:
+ *   Remove the next packet queued by ipfwd_flow_send() from a device.
+ *
+ * Returned Value:
+ *   The IOB chain of the packet, or NULL if the queue is empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct iob_s *ipfwd_flow_dequeue(FAR struct net_driver_s *dev);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Invalidate flow cache entries after a change that may alter the
+ *   forwarding decisions.
+ *
+ * Input Parameters:
+ *   dev - Invalidate only the flows that are received or forwarded on this
+ *         device and drop the packets queued on it.  NULL invalidates all
+ *         flows.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flow_flush(FAR struct net_driver_s *dev);
+#else
+#  define ipfwd_flow_flush(dev)
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -0,0 +1,482 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "arp/arp.h"
+#include "route/route.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPFWD_FLOW_TIMEOUT \
+  SEC2TICK(CONFIG_NET_IPFORWARD_FLOWCACHE_TIMEOUT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow cache and the d_fwdout queues of all devices are protected by
+ * one lock.  The queues are filled while holding the lock of the receiving
+ * device, so the lock of the forwarding device can not be used here.
+ */
+
+static mutex_t g_ipfwd_flowlock = NXMUTEX_INITIALIZER;
+
+static struct ipfwd_flow_s
+g_ipfwd_flows[CONFIG_NET_IPFORWARD_FLOWCACHE_ENTRIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_hash
+ *
+ * Description:
+ *   Return the flow cache entry used by a flow.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfwd_flow_s *
+ipfwd_flow_hash(FAR const struct ipfwd_flowkey_s *key)
+{
+  uint32_t hash;
+
+  hash  = key->fk_srcaddr ^ key->fk_dstaddr ^ key->fk_proto ^
+          (uint32_t)(uintptr_t)key->fk_dev;
+  hash ^= ((uint32_t)key->fk_srcport << 16) | key->fk_dstport;
+
+  /* Mix the upper bits into the lower ones used for the index */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return &g_ipfwd_flows[hash % CONFIG_NET_IPFORWARD_FLOWCACHE_ENTRIES];
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_match
+ *
+ * Description:
+ *   Check if a flow cache entry holds the flow described by key.
+ *
+ ****************************************************************************/
+
+static bool ipfwd_flow_match(FAR const struct ipfwd_flow_s *flow,
+                             FAR const struct ipfwd_flowkey_s *key)
+{
+  return flow->fl_dev != NULL &&
+         flow->fl_key.fk_dev == key->fk_dev &&
+         flow->fl_key.fk_srcaddr == key->fk_srcaddr &&
+         flow->fl_key.fk_dstaddr == key->fk_dstaddr &&
+         flow->fl_key.fk_srcport == key->fk_srcport &&
+         flow->fl_key.fk_dstport == key->fk_dstport &&
+         flow->fl_key.fk_proto == key->fk_proto;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_nexthop
+ *
+ * Description:
+ *   Find the MAC address of the next hop towards dstaddr on an Ethernet
+ *   device, the same way arp_out() does.
+ *
+ * Returned Value:
+ *   Zero (OK) if the MAC address is known; a negated errno value if it is
+ *   not or if the destination is a broadcast address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP
+static int ipv4_flow_nexthop(FAR struct net_driver_s *dev,
+                             in_addr_t dstaddr, FAR uint8_t *ethaddr)
+{
+  in_addr_t ipaddr;
+
+  if (!net_ipv4addr_maskcmp(dstaddr, dev->d_ipaddr, dev->d_netmask))
+    {
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv4_router(dev, dstaddr, &ipaddr);
+#else
+      net_ipv4addr_copy(ipaddr, dev->d_draddr);
+#endif
+      if (ipaddr == INADDR_ANY)
+        {
+          return -ENETUNREACH;
+        }
+    }
+  else if (net_ipv4addr_broadcast(dstaddr, dev->d_netmask))
+    {
+      return -EINVAL;
+    }
+  else
+    {
+      net_ipv4addr_copy(ipaddr, dstaddr);
+    }
+
+  return arp_find(ipaddr, ethaddr, dev);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_key
+ *
+ * Description:
+ *   Get the flow cache key of a received IPv4 packet.  Only unfragmented
+ *   TCP and UDP packets are handled by the flow cache.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received
+ *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet
+ *   key   - Location to return the key
+ *
+ * Returned Value:
+ *   True if the packet may be handled by the flow cache.
+ *
+ ****************************************************************************/
+
+bool ipv4_flow_key(FAR struct net_driver_s *dev,
+                   FAR struct ipv4_hdr_s *ipv4,
+                   FAR struct ipfwd_flowkey_s *key)
+{
+  FAR const uint16_t *ports;
+  uint16_t iphdrlen;
+
+  if (ipv4->proto != IP_PROTO_TCP && ipv4->proto != IP_PROTO_UDP)
+    {
+      return false;
+    }
+
+  /* Fragments have no ports (or all of them have the same ports) */
+
+  if ((ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+    {
+      return false;
+    }
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  if (dev->d_len < iphdrlen + 2 * sizeof(uint16_t))
+    {
+      return false;
+    }
+
+  /* The source and destination ports are the first two fields of both the
+   * TCP and the UDP header.
+   */
+
+  ports           = (FAR const uint16_t *)((FAR uint8_t *)ipv4 + iphdrlen);
+
+  key->fk_dev     = dev;
+  key->fk_srcaddr = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->fk_dstaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->fk_srcport = ports[0];
+  key->fk_dstport = ports[1];
+  key->fk_proto   = ipv4->proto;
+  return true;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_lookup
+ *
+ * Description:
+ *   Look up a flow in the flow cache.
+ *
+ * Input Parameters:
+ *   key   - The flow to look up
+ *   flow  - Location to return a copy of the flow cache entry
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the flow was found; -ENOENT otherwise.
+ *
+ ****************************************************************************/
+
+int ipv4_flow_lookup(FAR const struct ipfwd_flowkey_s *key,
+                     FAR struct ipfwd_flow_s *flow)
+{
+  FAR struct ipfwd_flow_s *entry;
+  int ret = -ENOENT;
+
+  nxmutex_lock(&g_ipfwd_flowlock);
+
+  entry = ipfwd_flow_hash(key);
+  if (ipfwd_flow_match(entry, key))
+    {
+      if (clock_systime_ticks() - entry->fl_time < IPFWD_FLOW_TIMEOUT)
+        {
+          memcpy(flow, entry, sizeof(struct ipfwd_flow_s));
+          ret = OK;
+        }
+      else
+        {
+          /* Expired, let the normal path verify the flow again */
+
+          entry->fl_dev = NULL;
+        }
+    }
+
+  nxmutex_unlock(&g_ipfwd_flowlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_add
+ *
+ * Description:
+ *   Remember the forwarding device of a flow after its packet was accepted
+ *   by the normal forwarding path.  Nothing is remembered if the next hop
+ *   can not be resolved without sending a packet.
+ *
+ * Input Parameters:
+ *   key     - The flow
+ *   fwddev  - The device on which the flow is forwarded
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipv4_flow_add(FAR const struct ipfwd_flowkey_s *key,
+                   FAR struct net_driver_s *fwddev)
+{
+  FAR struct ipfwd_flow_s *entry;
+  uint8_t ethaddr[ETHER_ADDR_LEN];
+
+  /* Only link layers without any per-packet processing in the poll path
+   * can be served from the flow cache.
+   */
+
+  switch (fwddev->d_lltype)
+    {
+#ifdef CONFIG_NET_ARP
+      case NET_LL_ETHERNET:
+      case NET_LL_IEEE80211:
+
+        /* The ARP lookup is done outside of the flow cache lock */
+
+        if (ipv4_flow_nexthop(fwddev, key->fk_dstaddr, ethaddr) < 0)
+          {
+            return;
+          }
+
+        break;
+#endif
+
+      case NET_LL_TUN:
+        memset(ethaddr, 0, ETHER_ADDR_LEN);
+        break;
+
+      default:
+        return;
+    }
+
+  nxmutex_lock(&g_ipfwd_flowlock);
+
+  entry          = ipfwd_flow_hash(key);
+  entry->fl_key  = *key;
+  entry->fl_dev  = fwddev;
+  entry->fl_time = clock_systime_ticks();
+  memcpy(entry->fl_ethaddr, ethaddr, ETHER_ADDR_LEN);
+
+  nxmutex_unlock(&g_ipfwd_flowlock);
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_send
+ *
+ * Description:
+ *   Build the L2 header of a packet of a cached flow and queue it for
+ *   transmission on the forwarding device.
+ *
+ * Input Parameters:
+ *   flow  - The flow cache entry of the packet
+ *   iob   - The IOB chain containing the packet, starting with the L3
+ *           header
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the packet was queued and the IOB chain now
+ *   belongs to the forwarding device.  A negated errno value is returned
+ *   on any failure.
+ *
+ ****************************************************************************/
+
+int ipfwd_flow_send(FAR const struct ipfwd_flow_s *flow,
+                    FAR struct iob_s *iob)
+{
+  FAR struct net_driver_s *fwddev = flow->fl_dev;
+  int ret;
+
+  if (fwddev->d_lltype == NET_LL_ETHERNET ||
+      fwddev->d_lltype == NET_LL_IEEE80211)
+    {
+      FAR struct eth_hdr_s *peth;
+
+      /* The IOB keeps CONFIG_NET_LL_GUARDSIZE bytes in front of the L3
+       * header for the L2 header.
+       */
+
+      DEBUGASSERT(iob->io_offset >= NET_LL_HDRLEN(fwddev));
+
+      peth = (FAR struct eth_hdr_s *)
+             (IOB_DATA(iob) - NET_LL_HDRLEN(fwddev));
+      memcpy(peth->dest, flow->fl_ethaddr, ETHER_ADDR_LEN);
+      memcpy(peth->src, fwddev->d_mac.ether.ether_addr_octet,
+             ETHER_ADDR_LEN);
+      peth->type = HTONS(ETHTYPE_IP);
+    }
+
+  nxmutex_lock(&g_ipfwd_flowlock);
+
+  if (fwddev->d_nfwdout >= CONFIG_NET_IPFORWARD_NSTRUCT)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      ret = iob_tryadd_queue(iob, &fwddev->d_fwdout);
+      if (ret >= 0)
+        {
+          fwddev->d_nfwdout++;
+        }
+    }
+
+  nxmutex_unlock(&g_ipfwd_flowlock);
+
+  if (ret < 0)
+    {
+      nwarn("WARNING: Failed to queue forwarded packet on %s: %d\n",
+            fwddev->d_ifname, ret);
+      return ret;
+    }
+
+  /* Notify the device driver of the availability of TX data */
+
+  netdev_txnotify_dev(fwddev, IPFWD_POLL);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_dequeue
+ *
+ * Description:
+ *   Remove the next packet queued by ipfwd_flow_send() from a device.
+ *
+ * Returned Value:
+ *   The IOB chain of the packet, or NULL if the queue is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *ipfwd_flow_dequeue(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = NULL;
+
+  /* Unlocked peek, the queue is checked on every forwarding poll */
+
+  if (IOB_QEMPTY(&dev->d_fwdout))
+    {
+      return NULL;
+    }
+
+  nxmutex_lock(&g_ipfwd_flowlock);
+
+  iob = iob_remove_queue(&dev->d_fwdout);
+  if (iob != NULL)
+    {
+      dev->d_nfwdout--;
+    }
+
+  nxmutex_unlock(&g_ipfwd_flowlock);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Invalidate flow cache entries after a change that may alter the
+ *   forwarding decisions.
+ *
+ * Input Parameters:
+ *   dev - Invalidate only the flows that are received or forwarded on this
+ *         device and drop the packets queued on it.  NULL invalidates all
+ *         flows.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_flush(FAR struct net_driver_s *dev)
+{
+  int i;
+
+  nxmutex_lock(&g_ipfwd_flowlock);
+
+  for (i = 0; i < CONFIG_NET_IPFORWARD_FLOWCACHE_ENTRIES; i++)
+    {
+      FAR struct ipfwd_flow_s *entry = &g_ipfwd_flows[i];
+
+      if (dev == NULL || entry->fl_dev == dev ||
+          entry->fl_key.fk_dev == dev)
+        {
+          entry->fl_dev = NULL;
+        }
+    }
+
+  if (dev != NULL)
+    {
+      iob_free_queue(&dev->d_fwdout);
+      dev->d_nfwdout = 0;
+    }
+
+  nxmutex_unlock(&g_ipfwd_flowlock);
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
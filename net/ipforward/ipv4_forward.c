@@ -348,6 +348,80 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: ipv4_flow_forward
+ *
+ * Description:
+ *   Forward a packet of a flow found in the flow cache: the route lookup,
+ *   the FORWARD filter chain and the ARP lookup are skipped and the packet
+ *   is queued directly on the forwarding device.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which
+ *           contains the IPv4 packet.
+ *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet
+ *   key   - The flow cache key of the packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was successfully forwarded.  -ENOENT is
+ *   returned if the packet must take the normal forwarding path.  Any other
+ *   negated errno value means that the packet must be dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+static int ipv4_flow_forward(FAR struct net_driver_s *dev,
+                             FAR struct ipv4_hdr_s *ipv4,
+                             FAR const struct ipfwd_flowkey_s *key)
+{
+  struct ipfwd_flow_s flow;
+  FAR struct net_driver_s *fwddev;
+  int ret;
+
+  ret = ipv4_flow_lookup(key, &flow);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Leave everything that needs more than rewriting the packet (errors
+   * to report, fragmentation) to the normal forwarding path.
+   */
+
+  fwddev = flow.fl_dev;
+  if (!IFF_IS_RUNNING(fwddev->d_flags) ||
+      IFF_IS_NODST_FORWARD(fwddev->d_flags) || ipv4->ttl <= 1 ||
+      NET_LL_HDRLEN(fwddev) + dev->d_len > NETDEV_PKTSIZE(fwddev))
+    {
+      return -ENOENT;
+    }
+
+  ipv4_decr_ttl(ipv4);
+
+#ifdef CONFIG_NET_NAT44
+  ret = ipv4_nat_outbound(fwddev, ipv4, NAT_MANIP_SRC);
+  if (ret < 0)
+    {
+      /* The packet was already modified, it can not take the normal path
+       * any more.
+       */
+
+      nwarn("WARNING: Performing NAT44 outbound failed, dropping!\n");
+      return -ENOMEM;
+    }
+#endif
+
+  ret = ipfwd_flow_send(&flow, dev->d_iob);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  netdev_iob_clear(dev);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_forward_callback
  *
@@ -468,6 +542,10 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
   int ret;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  struct ipfwd_flowkey_s key;
+  bool cacheable;
+#endif
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
   int icmp_reply_type;
   int icmp_reply_code;
@@ -481,6 +559,26 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
       goto drop;
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Try the flow cache first.  The key must be taken before NAT rewrites
+   * the packet.
+   */
+
+  cacheable = ipv4_flow_key(dev, ipv4, &key);
+  if (cacheable)
+    {
+      ret = ipv4_flow_forward(dev, ipv4, &key);
+      if (ret >= 0)
+        {
+          return OK;
+        }
+      else if (ret != -ENOENT)
+        {
+          goto drop;
+        }
+    }
+#endif
+
   /* Search for a device that can forward this packet. */
 
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
@@ -508,6 +606,15 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* The packet passed all checks, remember the decision */
+
+      if (cacheable)
+        {
+          ipv4_flow_add(&key, fwddev);
+        }
+#endif
     }
   else
     {
@@ -96,6 +96,14 @@ do  \
 
 #define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
 
+/* Number of buckets of the reassembly hash table, a power of 2 */
+
+#define REASSEMBLY_HASHSIZE            16
+
+/* The maximum length of the payload of a reassembled datagram */
+
+#define REASSEMBLY_MAXDATALEN          UINT16_MAX
+
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
 #define LOOPBACK_IPFRAME_NOFRAGMENT    0
@@ -117,13 +125,14 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Hash table of the reassembly nodes of all NICs.  Nodes are hashed by
+ * source address only, all datagrams from one source are in one bucket in
+ * order of creation.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhash[REASSEMBLY_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -135,8 +144,8 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time at a
+ * time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -149,7 +158,21 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
+static uint32_t ip_fragin_freenode(FAR struct ip_fragsnode_s *node);
+static void ip_fragin_getaddr(FAR struct ip_fraglink_s *fraglink,
+                              FAR union ip_addr_u *srcaddr,
+                              FAR union ip_addr_u *destaddr);
+static bool ip_fragin_addrcmp(uint8_t isipv4,
+                              FAR const union ip_addr_u *addr1,
+                              FAR const union ip_addr_u *addr2);
+static FAR sq_queue_t *ip_fragin_bucket(uint8_t isipv4,
+                                        FAR const union ip_addr_u *addr);
+static int ip_fragin_insert(FAR struct ip_fragsnode_s *node,
+                            FAR struct ip_fraglink_s *curfraglink);
+#if CONFIG_NET_IPFRAG_REASS_SRCMAXIOB > 0
+static void ip_fragin_srcmonitor(FAR sq_queue_t *bucket,
+                                 FAR struct ip_fragsnode_s *curnode);
+#endif
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
@@ -270,22 +293,9 @@ static void ip_fragin_timerwork(FAR void *arg)
             }
 #endif
 
-          /* Remove fragments of this node */
-
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
+          /* Remove the fragments and the node */
 
-          /* Remove node from single-list and free node memory */
-
-          ip_frag_remnode(node);
-          kmm_free(node);
+          ip_fragin_freenode(node);
         }
       else
         {
@@ -363,49 +373,369 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 }
 
 /****************************************************************************
- * Name: ip_fragin_check
+ * Name: ip_fragin_freenode
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
+ *   Free all fragments of a node, remove the node from the reassembly cache
+ *   and free it.
  *
  * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
+ *   node - node of the upper-level linked list, it maintains
+ *          information about all fragments belonging to an IP datagram
  *
  * Returned Value:
- *   None
+ *   I/O buffer count of this node
  *
  ****************************************************************************/
 
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
+static uint32_t ip_fragin_freenode(FAR struct ip_fragsnode_s *node)
 {
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
+  FAR struct ip_fraglink_s *fraglink = node->frags;
+  uint32_t bufcnt;
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
+  while (fraglink != NULL)
     {
-      entry = fragsnode->frags;
-      while (entry != NULL)
+      fraglink = ip_fragin_freelink(fraglink);
+    }
+
+  bufcnt = ip_frag_remnode(node);
+  kmm_free(node);
+
+  return bufcnt;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_getaddr
+ *
+ * Description:
+ *   Get the source and destination addresses from the IP header of a
+ *   fragment.
+ *
+ ****************************************************************************/
+
+static void ip_fragin_getaddr(FAR struct ip_fraglink_s *fraglink,
+                              FAR union ip_addr_u *srcaddr,
+                              FAR union ip_addr_u *destaddr)
+{
+  FAR struct iob_s *iob = fraglink->frag;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      net_ipv4addr_copy(srcaddr->ipv4, net_ip4addr_conv32(ipv4->srcipaddr));
+      net_ipv4addr_copy(destaddr->ipv4,
+                        net_ip4addr_conv32(ipv4->destipaddr));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      net_ipv6addr_copy(srcaddr->ipv6, ipv6->srcipaddr);
+      net_ipv6addr_copy(destaddr->ipv6, ipv6->destipaddr);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_addrcmp
+ *
+ * Description:
+ *   Compare two addresses of the same family.
+ *
+ ****************************************************************************/
+
+static bool ip_fragin_addrcmp(uint8_t isipv4,
+                              FAR const union ip_addr_u *addr1,
+                              FAR const union ip_addr_u *addr2)
+{
+#ifdef CONFIG_NET_IPv4
+  if (isipv4)
+    {
+      return net_ipv4addr_cmp(addr1->ipv4, addr2->ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!isipv4)
+    {
+      return net_ipv6addr_cmp(addr1->ipv6, addr2->ipv6);
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_bucket
+ *
+ * Description:
+ *   Return the bucket of the reassembly hash table for a source address.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *ip_fragin_bucket(uint8_t isipv4,
+                                        FAR const union ip_addr_u *addr)
+{
+  uint32_t hash = 0;
+
+#ifdef CONFIG_NET_IPv4
+  if (isipv4)
+    {
+      hash = addr->ipv4;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!isipv4)
+    {
+      int i;
+
+      for (i = 0; i < 8; i++)
         {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
+          hash ^= (uint32_t)addr->ipv6[i] << ((i & 1) << 4);
+        }
+    }
+#endif
 
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+
+  return &g_assemblyhash[hash & (REASSEMBLY_HASHSIZE - 1)];
+}
+
+/****************************************************************************
+ * Name: ip_fragin_insert
+ *
+ * Description:
+ *   Insert a fragment into the offset ordered fragment list of a node and
+ *   update the reception status.  Fragments arriving in order (or in
+ *   reverse order) are added in constant time, and since fragments never
+ *   overlap the completeness check is a comparison of the received and
+ *   the total payload length.
+ *
+ *   A fragment with the same offset and length as one already received
+ *   replaces it, refer to RFC791, Section3.2, Page29.  Any other overlap
+ *   is refused, like RFC5722 requires for IPv6.
+ *
+ * Input Parameters:
+ *   node        - node of the upper-level linked list, it maintains
+ *                 information about all fragments belonging to an IP
+ *                 datagram
+ *   curfraglink - node of the lower-level linked list, it maintains
+ *                 information of one fragment
+ *
+ * Returned Value:
+ *   OK on success, -EINVAL if the fragment overlaps other fragments or is
+ *   beyond the end of the datagram.
+ *
+ ****************************************************************************/
+
+static int ip_fragin_insert(FAR struct ip_fragsnode_s *node,
+                            FAR struct ip_fraglink_s *curfraglink)
+{
+  FAR struct ip_fraglink_s *prev = NULL;
+  FAR struct ip_fraglink_s *next = NULL;
+  uint32_t end = (uint32_t)curfraglink->fragoff + curfraglink->fraglen;
+
+  if (end > REASSEMBLY_MAXDATALEN)
+    {
+      return -EINVAL;
+    }
+
+  /* Find the fragments before and after the new one */
+
+  if (node->fragtail == NULL)
+    {
+      /* The first fragment */
+    }
+  else if (curfraglink->fragoff > node->fragtail->fragoff)
+    {
+      prev = node->fragtail;
+    }
+  else if (curfraglink->fragoff <= node->frags->fragoff)
+    {
+      next = node->frags;
+    }
+  else
+    {
+      prev = node->frags;
+      while (prev->flink->fragoff < curfraglink->fragoff)
+        {
+          prev = prev->flink;
+        }
+
+      next = prev->flink;
+    }
+
+  /* Fragments with same offset value contain the same data, use the more
+   * recently arrived copy.
+   */
+
+  if (next != NULL && next->fragoff == curfraglink->fragoff &&
+      next->fraglen == curfraglink->fraglen &&
+      !next->morefrags == !curfraglink->morefrags)
+    {
+      curfraglink->flink = next->flink;
+      if (prev == NULL)
+        {
+          node->frags = curfraglink;
+        }
+      else
+        {
+          prev->flink = curfraglink;
+        }
+
+      if (node->fragtail == next)
+        {
+          node->fragtail = curfraglink;
+        }
+
+      node->bufcnt -= IOBUF_CNT(next->frag);
+      g_bufoccupy  -= IOBUF_CNT(next->frag);
+      node->bufcnt += IOBUF_CNT(curfraglink->frag);
+      g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+
+      ip_fragin_freelink(next);
+      return OK;
+    }
+
+  /* Refuse overlapping fragments and fragments beyond the tail */
+
+  if ((prev != NULL &&
+       (uint32_t)prev->fragoff + prev->fraglen > curfraglink->fragoff) ||
+      (next != NULL && end > next->fragoff))
+    {
+      return -EINVAL;
+    }
+
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0)
+    {
+      if (!curfraglink->morefrags || end > node->datalen)
+        {
+          return -EINVAL;
+        }
+    }
+  else if (!curfraglink->morefrags)
+    {
+      if (next != NULL)
+        {
+          return -EINVAL;
+        }
+
+      /* Have received the tail fragment */
+
+      node->datalen     = end;
+      node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+    }
+
+  /* Link the fragment */
+
+  curfraglink->flink = next;
+  if (prev == NULL)
+    {
+      node->frags = curfraglink;
+    }
+  else
+    {
+      prev->flink = curfraglink;
+    }
+
+  if (next == NULL)
+    {
+      node->fragtail = curfraglink;
+    }
+
+  if (curfraglink->fragoff == 0)
+    {
+      /* Have received the zero fragment */
+
+      node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
+    }
+
+  /* Remember I/O buffer count */
+
+  node->recvdlen += curfraglink->fraglen;
+  node->bufcnt   += IOBUF_CNT(curfraglink->frag);
+  g_bufoccupy    += IOBUF_CNT(curfraglink->frag);
+
+  /* Check receiving status */
+
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+      node->recvdlen == node->datalen)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_srcmonitor
+ *
+ * Description:
+ *   Check the number of I/O buffers held by the datagrams from the source
+ *   of a node, if it exceeds CONFIG_NET_IPFRAG_REASS_SRCMAXIOB, drop the
+ *   oldest other datagrams from this source.
+ *
+ * Input Parameters:
+ *   bucket  - The hash bucket of the source
+ *   curnode - node of the upper-level linked list, it maintains information
+ *             about all fragments belonging to an IP datagram
+ *
+ * Returned Value:
+ *   none
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFRAG_REASS_SRCMAXIOB > 0
+static void ip_fragin_srcmonitor(FAR sq_queue_t *bucket,
+                                 FAR struct ip_fragsnode_s *curnode)
+{
+  FAR struct ip_fragsnode_s *node;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *entrynext;
+  uint32_t bufcnt = 0;
+
+  /* All datagrams from the source are in this bucket */
 
-          entry = entry->flink;
+  for (entry = sq_peek(bucket); entry != NULL; entry = sq_next(entry))
+    {
+      node = (FAR struct ip_fragsnode_s *)entry;
+      if (node->isipv4 == curnode->isipv4 &&
+          ip_fragin_addrcmp(node->isipv4, &node->srcaddr,
+                            &curnode->srcaddr))
+        {
+          bufcnt += node->bufcnt;
+        }
+    }
+
+  /* The bucket is in order of creation, drop the oldest first */
+
+  entry = sq_peek(bucket);
+  while (entry != NULL && bufcnt > CONFIG_NET_IPFRAG_REASS_SRCMAXIOB)
+    {
+      entrynext = sq_next(entry);
+      node = (FAR struct ip_fragsnode_s *)entry;
+
+      if (node != curnode && node->isipv4 == curnode->isipv4 &&
+          ip_fragin_addrcmp(node->isipv4, &node->srcaddr,
+                            &curnode->srcaddr))
+        {
+          ninfo("Source over its reassembly budget, drop a datagram\n");
+          bufcnt -= ip_fragin_freenode(node);
         }
+
+      entry = entrynext;
     }
 }
+#endif
 
 /****************************************************************************
  * Name: ip_fragin_cachemonitor
@@ -449,23 +779,7 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 
           if (node != curnode)
             {
-              /* Remove fragments of this node */
-
-              if (node->frags != NULL)
-                {
-                  FAR struct ip_fraglink_s *fraglink = node->frags;
-
-                  while (fraglink != NULL)
-                    {
-                      fraglink = ip_fragin_freelink(fraglink);
-                    }
-                }
-
-              /* Remove node from single-list and free node memory */
-
-              bufcnt = ip_frag_remnode(node);
-              kmm_free(node);
-
+              bufcnt   = ip_fragin_freenode(node);
               cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
             }
 
@@ -530,7 +844,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node,
+         ip_fragin_bucket(node->isipv4, &node->srcaddr));
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -542,8 +857,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are kept
+ *   in a hash table keyed by source address.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -551,131 +866,53 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the reassembly cache was empty before the fragment was added,
+ *   0 if not.  A negated errno value if the fragment was not queued, the
+ *   caller still owns curfraglink and the I/O buffer then:
+ *
+ *   ENOMEM - No memory
+ *   EINVAL - The fragment overlaps the fragments already received, the
+ *            whole datagram was dropped
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink)
 {
-  FAR struct ip_fragsnode_s *node;
+  FAR struct ip_fragsnode_s *node = NULL;
+  FAR sq_queue_t            *bucket;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  union ip_addr_u            srcaddr;
+  union ip_addr_u            destaddr;
   bool                       empty;
+  int                        ret;
+
+  empty = sq_empty(&g_assemblyhead_time);
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  /* A datagram is identified by the IP ID, the addresses and the NIC, look
+   * for its node in the bucket of the source address.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  ip_fragin_getaddr(curfraglink, &srcaddr, &destaddr);
+  bucket = ip_fragin_bucket(curfraglink->isipv4, &srcaddr);
 
-  while (entry != NULL)
+  for (entry = sq_peek(bucket); entry != NULL; entry = sq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
+      node = (FAR struct ip_fragsnode_s *)entry;
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (node->ipid == curfraglink->ipid && node->dev == dev &&
+          node->isipv4 == curfraglink->isipv4 &&
+          ip_fragin_addrcmp(node->isipv4, &node->srcaddr, &srcaddr) &&
+          ip_fragin_addrcmp(node->isipv4, &node->destaddr, &destaddr))
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
-    {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
-
-      /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
-       */
-
-      fraglink = node->frags;
-
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
-       */
-
-      while (fraglink != NULL)
-        {
-          /* The fragment list is ordered by fragment offset value */
-
-          if (curfraglink->fragoff <= fraglink->fragoff)
-            {
-              break;
-            }
-
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
-        }
-
-      if (fraglink == NULL)
-        {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
-
-          lastlink->flink      = curfraglink;
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
-        {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
-           */
-
-          curfraglink->flink = fraglink->flink;
-          if (lastlink == NULL)
-            {
-              node->frags = curfraglink;
-            }
-          else
-            {
-              lastlink->flink = curfraglink;
-            }
-
-          iob_free_chain(fraglink->frag);
-          kmm_free(fraglink);
-        }
-      else
-        {
-          /* Insert into the fragment list */
-
-          if (lastlink == NULL)
-            {
-              /* Insert before the first node */
-
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
-            }
-          else
-            {
-              /* Insert this node after lastlink */
-
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
-            }
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-    }
-  else
+  if (entry == NULL)
     {
-      /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+      /* It's a new datagram, malloc a new node and add it to the tail of
+       * its bucket and of the time ordered list.
        */
 
       node = kmm_malloc(sizeof(struct ip_fragsnode_s));
@@ -689,66 +926,51 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->flinkat    = NULL;
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
+      node->isipv4     = curfraglink->isipv4;
+      node->srcaddr    = srcaddr;
+      node->destaddr   = destaddr;
+      node->frags      = NULL;
+      node->fragtail   = NULL;
+      node->recvdlen   = 0;
+      node->datalen    = 0;
       node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
+      node->bufcnt     = 0;
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
-
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
-
-      /* Add this new node to the tail of linked list identified by
-       * g_assemblyhead_time
-       */
-
+      sq_addlast((FAR sq_entry_t *)node, bucket);
       sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
     }
 
-  if (curfraglink->fragoff == 0)
-    {
-      /* Have received the zero fragment */
-
-      node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
-    }
-  else if (!curfraglink->morefrags)
+  ret = ip_fragin_insert(node, curfraglink);
+  if (ret < 0)
     {
-      /* Have received the tail fragment */
-
-      node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      nwarn("WARNING: Bad fragment, drop the datagram\n");
+      ip_fragin_freenode(node);
+      return ret;
     }
 
   /* For indexing convenience */
 
   curfraglink->fragsnode = node;
 
-  /* Check receiving status */
-
-  ip_fragin_check(node);
-
   /* Buffer is take away, clear original pointers in NIC */
 
   netdev_iob_clear(dev);
 
+#if CONFIG_NET_IPFRAG_REASS_SRCMAXIOB > 0
+  /* Keep the datagrams of this source within its budget */
+
+  ip_fragin_srcmonitor(bucket, node);
+#endif
+
   /* Perform cache cleaning when reassembly cache size exceeds the configured
    * threshold
    */
 
   ip_fragin_cachemonitor(node);
 
-  return empty;
+  return empty ? 1 : 0;
 }
 
 /****************************************************************************
@@ -1117,29 +1339,21 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node;
+
+      node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_freenode(node);
         }
 
       entry = entrynext;
@@ -1172,39 +1386,23 @@ void ip_frag_remallfrags(void)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
-
-      if (node->frags != NULL)
-        {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
+      FAR struct ip_fragsnode_s *node;
 
-          while (fraglink != NULL)
-            {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
-
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
+      node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      entrynext = sq_next(entry);
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      ip_fragin_freenode(node);
 
       entry = entrynext;
     }
 
-  sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
-
   nxmutex_unlock(&g_ipfrag_lock);
 
   /* Drop all unsent outgoing fragments */
@@ -1246,7 +1444,9 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return -EINVAL;
     }
 
-  if (dev->d_iob->io_pktlen <= mtu)
+  /* Oversized TCP segments are split by the driver, not fragmented */
+
+  if (dev->d_iob->io_pktlen <= mtu || NETDEV_GSO_SIZE(dev) > 0)
     {
       return OK;
     }
@@ -94,8 +94,9 @@ struct ip_fraglink_s
 
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
+  /* This link is used to maintain the list of ip_fragsnode_s in one bucket
+   * of the reassembly hash table.  Must be the first field in the structure
+   * due to flink type casting.
    */
 
   FAR struct ip_fragsnode_s *flink;
@@ -116,6 +117,14 @@ struct ip_fragsnode_s
 
   uint32_t                   ipid;
 
+  /* The rest of the key of the datagram, the source address also selects
+   * the hash bucket of the node.
+   */
+
+  uint8_t                    isipv4;
+  union ip_addr_u            srcaddr;
+  union ip_addr_u            destaddr;
+
   /* Count ticks, used by ressembly timer */
 
   clock_t                    tick;
@@ -128,9 +137,16 @@ struct ip_fragsnode_s
 
   uint32_t                   bufcnt;
 
-  /* Linked all fragments with the same IP ID. */
+  /* Linked all fragments with the same IP ID, ordered by offset.  The
+   * fragments never overlap, so the payload received so far is simply the
+   * sum of their lengths and the datagram is complete when it equals the
+   * length given by the tail fragment.
+   */
 
   FAR struct ip_fraglink_s  *frags;
+  FAR struct ip_fraglink_s  *fragtail;
+  uint32_t                   recvdlen;
+  uint32_t                   datalen;
 
   /* Points to the reassembled outgoing IP frame */
 
@@ -149,8 +165,8 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time at a
+ * time
  */
 
 extern mutex_t g_ipfrag_lock;
@@ -182,8 +198,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are kept
+ *   in a hash table keyed by source address.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -191,12 +207,18 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the reassembly cache was empty before the fragment was added,
+ *   0 if not.  A negated errno value if the fragment was not queued, the
+ *   caller still owns curfraglink and the I/O buffer then:
+ *
+ *   ENOMEM - No memory
+ *   EINVAL - The fragment overlaps the fragments already received, the
+ *            whole datagram was dropped
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink);
 
 /****************************************************************************
  * Name: ipv4_fragin
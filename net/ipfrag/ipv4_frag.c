@@ -262,6 +262,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
   bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -282,9 +283,17 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
+
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  restartwdog = ret > 0;
 
   node = fraginfo->fragsnode;
 
@@ -469,6 +469,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node = NULL;
   FAR struct ip_fraglink_s *fraginfo = NULL;
   bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -485,13 +486,26 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   /* Populate fragment information from input packet data */
 
-  ipv6_fragin_getinfo(dev->d_iob, fraginfo);
+  ret = ipv6_fragin_getinfo(dev->d_iob, fraginfo);
+  if (ret < 0)
+    {
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   nxmutex_lock(&g_ipfrag_lock);
 
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
+
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  restartwdog = ret > 0;
 
   node = fraginfo->fragsnode;
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
@@ -109,6 +109,7 @@ enum local_state_s
  */
 
 struct devif_callback_s;       /* Forward reference */
+struct local_ring_s;           /* Forward reference */
 
 struct local_conn_s
 {
@@ -148,6 +149,15 @@ struct local_conn_s
 
   sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Connected peers exchange data through a pair of rings instead of
+   * FIFOs.  The receive ring of a peer is the send ring of the other one.
+   */
+
+  FAR struct local_ring_s *lc_rxring;
+  FAR struct local_ring_s *lc_txring;
+#endif
+
   /* The following is a list if poll structures of threads waiting for
    * socket events.
    */
@@ -781,6 +791,97 @@ int local_set_pollthreshold(FAR struct local_conn_s *conn,
 
 int local_set_nonblocking(FAR struct local_conn_s *conn);
 
+#ifdef CONFIG_NET_LOCAL_RING
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Connect two stream connections with a pair of rings, one for each
+ *   direction.
+ *
+ ****************************************************************************/
+
+int local_ring_connect(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1);
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Shut down the receive (SHUT_RD) and/or send (SHUT_WR) direction of a
+ *   connection using rings.
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how);
+
+/****************************************************************************
+ * Name: local_ring_disconnect
+ *
+ * Description:
+ *   Shut down a connection using rings and release the rings.
+ *
+ ****************************************************************************/
+
+void local_ring_disconnect(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Send data to the peer through the send ring.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t len,
+                        bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive data from the receive ring.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags, bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the poll of a connection using rings.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup);
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Handle the ioctl commands of a connection using rings, -ENOTTY if the
+ *   command is not handled.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg);
+
+/****************************************************************************
+ * Name: local_ring_resize
+ *
+ * Description:
+ *   Change the size of a ring.
+ *
+ ****************************************************************************/
+
+int local_ring_resize(FAR struct local_ring_s *ring, size_t size);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -232,6 +232,26 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   strlcpy(conn->lc_path, server->lc_path, sizeof(conn->lc_path));
   conn->lc_instance_id = client->lc_instance_id;
 
+  /* The accepted connection inherits the receive buffer size of the
+   * listener.
+   */
+
+  conn->lc_rcvsize = server->lc_rcvsize;
+
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Connect the peers directly with a pair of rings */
+
+  ret = local_ring_connect(conn, client);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create rings for %s: %d\n",
+           client->lc_path, ret);
+      goto err;
+    }
+
+  *accept = conn;
+  return OK;
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conn, server->lc_rcvsize, client->lc_rcvsize);
@@ -279,6 +299,7 @@ int local_alloc_accept(FAR struct local_conn_s *server,
 
 errout_with_fifos:
   local_release_fifos(conn);
+#endif
 
 err:
   local_free(conn);
@@ -345,6 +366,14 @@ void local_free(FAR struct local_conn_s *conn)
     }
 #endif /* CONFIG_NET_LOCAL_SCM */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Release the rings of the connection, the peer sees the end of the
+   * stream.
+   */
+
+  local_ring_disconnect(conn);
+#endif
+
   /* Destroy all FIFOs associated with the connection */
 
   local_release_fifos(conn);
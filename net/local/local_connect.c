@@ -96,6 +96,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       return ret;
     }
 
+#ifndef CONFIG_NET_LOCAL_RING
   /* Open the client-side write-only FIFO.  This should not block and should
    * prevent the server-side from blocking as well.
    */
@@ -123,6 +124,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif
 
   /* Increment the number of pending server connections */
 
@@ -142,6 +144,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   client->lc_state = LOCAL_STATE_CONNECTED;
   return ret;
 
+#ifndef CONFIG_NET_LOCAL_RING
 errout_with_outfd:
   file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
@@ -154,6 +157,7 @@ errout_with_conn:
   local_unlock();
 
   return ret;
+#endif
 }
 
 /****************************************************************************
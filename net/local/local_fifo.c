@@ -771,6 +771,15 @@ int local_set_nonblocking(FAR struct local_conn_s *conn)
   int nonblock = 1;
   int ret;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Rings take the non-blocking mode from the socket flags */
+
+  if (conn->lc_rxring != NULL)
+    {
+      return OK;
+    }
+#endif
+
   /* Set the conn to nonblocking mode */
 
   ret  = file_ioctl(&conn->lc_infile, FIONBIO, &nonblock);
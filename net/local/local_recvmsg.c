@@ -241,6 +241,24 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      /* Copy the data directly from the receive ring */
+
+      ret = local_ring_recv(conn, buf, len, flags,
+                            _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                            (flags & MSG_DONTWAIT) != 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      readlen = ret;
+      goto out;
+    }
+#endif
+
   /* Check shutdown state */
 
   if (conn->lc_infile.f_inode == NULL)
@@ -275,6 +293,10 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return ret;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+out:
+#endif
+
   /* Return the address family */
 
   if (from)
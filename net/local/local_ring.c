@@ -0,0 +1,735 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <nuttx/circbuf.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCAL_RING_NOREADER (1 << 0) /* Receive side shut down or closed */
+#define LOCAL_RING_NOWRITER (1 << 1) /* Send side shut down or closed */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One direction of a connected stream.  The ring is shared by the sending
+ * connection (lc_txring) and the receiving one (lc_rxring), data is copied
+ * directly from the sender to the ring and from the ring to the receiver.
+ */
+
+struct local_ring_s
+{
+  struct circbuf_s lr_buffer;    /* The data */
+  mutex_t   lr_lock;             /* Protects the ring */
+  sem_t     lr_rdsem;            /* Readers wait for data here */
+  sem_t     lr_wrsem;            /* Writers wait for space here */
+  uint8_t   lr_crefs;            /* The two ends of the connection */
+  uint8_t   lr_flags;            /* See LOCAL_RING_* definitions */
+  uint8_t   lr_nrdwait;          /* Number of readers waiting */
+  uint8_t   lr_nwrwait;          /* Number of writers waiting */
+  size_t    lr_pollinthrd;       /* POLLIN when more bytes are used */
+  size_t    lr_polloutthrd;      /* POLLOUT when more bytes are free */
+  FAR struct pollfd *lr_rdfds[LOCAL_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_alloc(size_t size)
+{
+  FAR struct local_ring_s *ring;
+
+  ring = kmm_zalloc(sizeof(struct local_ring_s));
+  if (ring == NULL)
+    {
+      return NULL;
+    }
+
+  if (circbuf_init(&ring->lr_buffer, NULL, size) < 0)
+    {
+      kmm_free(ring);
+      return NULL;
+    }
+
+  nxmutex_init(&ring->lr_lock);
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  ring->lr_crefs = 2;
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ ****************************************************************************/
+
+static void local_ring_release(FAR struct local_ring_s *ring)
+{
+  bool last;
+
+  nxmutex_lock(&ring->lr_lock);
+  last = --ring->lr_crefs == 0;
+  nxmutex_unlock(&ring->lr_lock);
+
+  if (last)
+    {
+      circbuf_uninit(&ring->lr_buffer);
+      nxsem_destroy(&ring->lr_rdsem);
+      nxsem_destroy(&ring->lr_wrsem);
+      nxmutex_destroy(&ring->lr_lock);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on one side of the ring.  Nothing is posted
+ *   when nobody waits, so a busy stream costs no semaphore operations.
+ *
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem, FAR uint8_t *nwait)
+{
+  while (*nwait > 0)
+    {
+      (*nwait)--;
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait on one side of the ring.  The ring is unlocked while waiting.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR struct local_ring_s *ring, FAR sem_t *sem,
+                           FAR uint8_t *nwait)
+{
+  int ret;
+
+  (*nwait)++;
+  nxmutex_unlock(&ring->lr_lock);
+  ret = nxsem_wait(sem);
+  if (ret >= 0)
+    {
+      ret = nxmutex_lock(&ring->lr_lock);
+    }
+  else
+    {
+      nxmutex_lock(&ring->lr_lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollin
+ *
+ * Description:
+ *   Return the input events of the ring.
+ *
+ ****************************************************************************/
+
+static pollevent_t local_ring_pollin(FAR struct local_ring_s *ring)
+{
+  pollevent_t eventset = 0;
+
+  if (circbuf_used(&ring->lr_buffer) > ring->lr_pollinthrd ||
+      (ring->lr_flags & LOCAL_RING_NOREADER) != 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if ((ring->lr_flags & LOCAL_RING_NOWRITER) != 0)
+    {
+      eventset |= POLLIN | POLLHUP;
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollout
+ *
+ * Description:
+ *   Return the output events of the ring.
+ *
+ ****************************************************************************/
+
+static pollevent_t local_ring_pollout(FAR struct local_ring_s *ring)
+{
+  if ((ring->lr_flags & (LOCAL_RING_NOREADER | LOCAL_RING_NOWRITER)) != 0)
+    {
+      return POLLERR | POLLHUP;
+    }
+
+  return circbuf_space(&ring->lr_buffer) > ring->lr_polloutthrd ?
+         POLLOUT : 0;
+}
+
+/****************************************************************************
+ * Name: local_ring_shutdown_one
+ ****************************************************************************/
+
+static void local_ring_shutdown_one(FAR struct local_ring_s *ring,
+                                    uint8_t flag)
+{
+  nxmutex_lock(&ring->lr_lock);
+  ring->lr_flags |= flag;
+
+  if (flag == LOCAL_RING_NOREADER)
+    {
+      /* Nobody will read the data anymore */
+
+      circbuf_reset(&ring->lr_buffer);
+    }
+
+  local_ring_wakeup(&ring->lr_rdsem, &ring->lr_nrdwait);
+  local_ring_wakeup(&ring->lr_wrsem, &ring->lr_nwrwait);
+  poll_notify(ring->lr_rdfds, LOCAL_NPOLLWAITERS, local_ring_pollin(ring));
+  poll_notify(ring->lr_wrfds, LOCAL_NPOLLWAITERS, local_ring_pollout(ring));
+  nxmutex_unlock(&ring->lr_lock);
+}
+
+/****************************************************************************
+ * Name: local_ring_pollslot
+ ****************************************************************************/
+
+static int local_ring_pollslot(FAR struct local_ring_s *ring,
+                               FAR struct pollfd **slots,
+                               FAR struct pollfd *fds, bool setup)
+{
+  FAR struct pollfd *match = setup ? NULL : fds;
+  int i;
+
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+    {
+      if (slots[i] == match)
+        {
+          slots[i] = setup ? fds : NULL;
+          return OK;
+        }
+    }
+
+  return setup ? -EBUSY : OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Connect two stream connections with a pair of rings, one for each
+ *   direction.  The ring read by a connection is sized by its lc_rcvsize.
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_ring_connect(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1)
+{
+  FAR struct local_ring_s *ring0;
+  FAR struct local_ring_s *ring1;
+
+  ring0 = local_ring_alloc(conn0->lc_rcvsize);
+  if (ring0 == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring1 = local_ring_alloc(conn1->lc_rcvsize);
+  if (ring1 == NULL)
+    {
+      ring0->lr_crefs = 1;
+      local_ring_release(ring0);
+      return -ENOMEM;
+    }
+
+  conn0->lc_rxring = ring0;
+  conn1->lc_txring = ring0;
+  conn1->lc_rxring = ring1;
+  conn0->lc_txring = ring1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Shut down the receive and/or send direction of a connection.  The
+ *   peer sees the end of the stream or gets EPIPE.
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how)
+{
+  if ((how & SHUT_RD) != 0 && conn->lc_rxring != NULL)
+    {
+      local_ring_shutdown_one(conn->lc_rxring, LOCAL_RING_NOREADER);
+    }
+
+  if ((how & SHUT_WR) != 0 && conn->lc_txring != NULL)
+    {
+      local_ring_shutdown_one(conn->lc_txring, LOCAL_RING_NOWRITER);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_disconnect
+ *
+ * Description:
+ *   Shut down both directions and drop the references of the connection
+ *   on its rings.
+ *
+ ****************************************************************************/
+
+void local_ring_disconnect(FAR struct local_conn_s *conn)
+{
+  local_ring_shutdown(conn, SHUT_RDWR);
+
+  if (conn->lc_rxring != NULL)
+    {
+      local_ring_release(conn->lc_rxring);
+      conn->lc_rxring = NULL;
+    }
+
+  if (conn->lc_txring != NULL)
+    {
+      local_ring_release(conn->lc_txring);
+      conn->lc_txring = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy the message to the ring of the peer.  All of the I/O vector is
+ *   written under one lock; readers are woken and pollers notified once
+ *   per call, or when the ring fills up and the sender has to wait.
+ *
+ * Input Parameters:
+ *   conn     - The sending connection
+ *   buf      - The data to send
+ *   len      - The number of I/O vector entries
+ *   nonblock - Don't wait for space
+ *
+ * Returned Value:
+ *   The number of bytes sent on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t len,
+                        bool nonblock)
+{
+  FAR struct local_ring_s *ring = conn->lc_txring;
+  FAR const struct iovec *end = buf + len;
+  FAR const struct iovec *iov = buf;
+  ssize_t nwritten = 0;
+  size_t offset = 0;
+  size_t before;
+  ssize_t ret;
+
+  if (ring == NULL)
+    {
+      return -EPIPE;
+    }
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  before = circbuf_used(&ring->lr_buffer);
+
+  while (iov != end)
+    {
+      if ((ring->lr_flags & (LOCAL_RING_NOREADER | LOCAL_RING_NOWRITER)) !=
+          0)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      if (offset >= iov->iov_len)
+        {
+          iov++;
+          offset = 0;
+          continue;
+        }
+
+      if (circbuf_is_full(&ring->lr_buffer))
+        {
+          /* Let the reader drain what was written so far */
+
+          if (circbuf_used(&ring->lr_buffer) > before)
+            {
+              local_ring_wakeup(&ring->lr_rdsem, &ring->lr_nrdwait);
+              if (before <= ring->lr_pollinthrd)
+                {
+                  poll_notify(ring->lr_rdfds, LOCAL_NPOLLWAITERS, POLLIN);
+                }
+            }
+
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = local_ring_wait(ring, &ring->lr_wrsem, &ring->lr_nwrwait);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          before = circbuf_used(&ring->lr_buffer);
+          continue;
+        }
+
+      ret = circbuf_write(&ring->lr_buffer,
+                          (FAR const uint8_t *)iov->iov_base + offset,
+                          iov->iov_len - offset);
+      offset   += ret;
+      nwritten += ret;
+    }
+
+  /* Wake up the reader once for the whole message.  Pollers are notified
+   * only when the used size crosses the threshold, they check the level
+   * again when the poll is set up.
+   */
+
+  if (circbuf_used(&ring->lr_buffer) > before)
+    {
+      local_ring_wakeup(&ring->lr_rdsem, &ring->lr_nrdwait);
+      if (before <= ring->lr_pollinthrd &&
+          circbuf_used(&ring->lr_buffer) > ring->lr_pollinthrd)
+        {
+          poll_notify(ring->lr_rdfds, LOCAL_NPOLLWAITERS, POLLIN);
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy the available data, up to 'len' bytes, from the receive ring.
+ *
+ * Input Parameters:
+ *   conn     - The receiving connection
+ *   buf      - The buffer to receive the data
+ *   len      - The size of the buffer
+ *   flags    - Receive flags, MSG_PEEK is supported
+ *   nonblock - Don't wait for data
+ *
+ * Returned Value:
+ *   The number of bytes received, 0 at the end of the stream, a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags, bool nonblock)
+{
+  FAR struct local_ring_s *ring = conn->lc_rxring;
+  size_t before;
+  ssize_t ret;
+
+  if (ring == NULL)
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (circbuf_is_empty(&ring->lr_buffer))
+    {
+      /* End of the stream? */
+
+      if ((ring->lr_flags & (LOCAL_RING_NOREADER | LOCAL_RING_NOWRITER)) !=
+          0)
+        {
+          ret = 0;
+          goto out;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      ret = local_ring_wait(ring, &ring->lr_rdsem, &ring->lr_nrdwait);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  if ((flags & MSG_PEEK) != 0)
+    {
+      ret = circbuf_peek(&ring->lr_buffer, buf, len);
+      goto out;
+    }
+
+  before = circbuf_space(&ring->lr_buffer);
+  ret    = circbuf_read(&ring->lr_buffer, buf, len);
+
+  /* Wake up the writers once, notify the pollers when the free space
+   * crosses the threshold.
+   */
+
+  local_ring_wakeup(&ring->lr_wrsem, &ring->lr_nwrwait);
+  if (before <= ring->lr_polloutthrd &&
+      circbuf_space(&ring->lr_buffer) > ring->lr_polloutthrd)
+    {
+      poll_notify(ring->lr_wrfds, LOCAL_NPOLLWAITERS, POLLOUT);
+    }
+
+out:
+  nxmutex_unlock(&ring->lr_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the poll of a connection using rings.  POLLIN is
+ *   watched on the receive ring and POLLOUT on the send ring.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct local_ring_s *rx = conn->lc_rxring;
+  FAR struct local_ring_s *tx = conn->lc_txring;
+  pollevent_t eventset = 0;
+  int ret = OK;
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      nxmutex_lock(&rx->lr_lock);
+      ret = local_ring_pollslot(rx, rx->lr_rdfds, fds, setup);
+      eventset |= local_ring_pollin(rx);
+      nxmutex_unlock(&rx->lr_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if ((fds->events & POLLOUT) != 0)
+    {
+      nxmutex_lock(&tx->lr_lock);
+      ret = local_ring_pollslot(tx, tx->lr_wrfds, fds, setup);
+      eventset |= local_ring_pollout(tx);
+      nxmutex_unlock(&tx->lr_lock);
+      if (ret < 0)
+        {
+          if (setup && (fds->events & POLLIN) != 0)
+            {
+              nxmutex_lock(&rx->lr_lock);
+              local_ring_pollslot(rx, rx->lr_rdfds, fds, false);
+              nxmutex_unlock(&rx->lr_lock);
+            }
+
+          return ret;
+        }
+    }
+
+  if (setup)
+    {
+      /* Report the events that are already in effect */
+
+      poll_notify(&fds, 1, eventset);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   The ioctl commands of a connection using rings.
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure, -ENOTTY if the
+ *   command is not handled here.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg)
+{
+  FAR struct local_ring_s *ring;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      case FIONBIO:
+
+        /* Non-blocking mode is taken from the socket flags */
+
+        break;
+
+      case FIONREAD:
+      case PIPEIOC_POLLINTHRD:
+        ring = conn->lc_rxring;
+        nxmutex_lock(&ring->lr_lock);
+        if (cmd == FIONREAD)
+          {
+            *(FAR int *)((uintptr_t)arg) = circbuf_used(&ring->lr_buffer);
+          }
+        else if (arg >= circbuf_size(&ring->lr_buffer))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ring->lr_pollinthrd = arg;
+          }
+
+        nxmutex_unlock(&ring->lr_lock);
+        break;
+
+      case FIONWRITE:
+      case FIONSPACE:
+      case PIPEIOC_POLLOUTTHRD:
+        ring = conn->lc_txring;
+        nxmutex_lock(&ring->lr_lock);
+        if (cmd == FIONWRITE)
+          {
+            *(FAR int *)((uintptr_t)arg) = circbuf_used(&ring->lr_buffer);
+          }
+        else if (cmd == FIONSPACE)
+          {
+            *(FAR int *)((uintptr_t)arg) = circbuf_space(&ring->lr_buffer);
+          }
+        else if (arg >= circbuf_size(&ring->lr_buffer))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ring->lr_polloutthrd = arg;
+          }
+
+        nxmutex_unlock(&ring->lr_lock);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_resize
+ *
+ * Description:
+ *   Change the size of a ring (SO_RCVBUF/SO_SNDBUF).  The ring must not
+ *   hold more data than the new size.
+ *
+ ****************************************************************************/
+
+int local_ring_resize(FAR struct local_ring_s *ring, size_t size)
+{
+  int ret;
+
+  if (size == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&ring->lr_lock);
+  if (circbuf_used(&ring->lr_buffer) > size)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      ret = circbuf_resize(&ring->lr_buffer, size);
+      if (ret >= 0)
+        {
+          local_ring_wakeup(&ring->lr_wrsem, &ring->lr_nwrwait);
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return ret;
+}
+
+#endif /* CONFIG_NET_LOCAL_RING */
@@ -179,6 +179,25 @@ static ssize_t local_send(FAR struct socket *psock,
               return -ENOTCONN;
             }
 
+#ifdef CONFIG_NET_LOCAL_RING
+          if (conn->lc_txring != NULL)
+            {
+              /* Send the data through the ring of the peer */
+
+              ret = nxmutex_lock(&conn->lc_sendlock);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              ret = local_ring_send(conn, buf, len,
+                                    _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                                    (flags & MSG_DONTWAIT) != 0);
+              nxmutex_unlock(&conn->lc_sendlock);
+              break;
+            }
+#endif
+
           /* Check shutdown state */
 
           if (conn->lc_outfile.f_inode == NULL)
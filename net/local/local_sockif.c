@@ -663,6 +663,13 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
                 {
                   rcvsize = MIN(*(FAR const int *)value,
                                 CONFIG_DEV_PIPE_MAXSIZE);
+#ifdef CONFIG_NET_LOCAL_RING
+                  if (conn->lc_txring != NULL)
+                    {
+                      ret = local_ring_resize(conn->lc_txring, rcvsize);
+                    }
+                  else
+#endif
                   if (conn->lc_peer->lc_infile.f_inode != NULL)
                     {
                       ret = file_ioctl(&conn->lc_peer->lc_infile,
@@ -707,6 +714,13 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
 #endif
 
               rcvsize = MIN(rcvsize, CONFIG_DEV_PIPE_MAXSIZE);
+#ifdef CONFIG_NET_LOCAL_RING
+              if (conn->lc_rxring != NULL)
+                {
+                  ret = local_ring_resize(conn->lc_rxring, rcvsize);
+                }
+              else
+#endif
               if (conn->lc_infile.f_inode != NULL)
                 {
                   ret = file_ioctl(&conn->lc_infile, PIPEIOC_SETSIZE,
@@ -929,6 +943,19 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
   FAR struct local_conn_s *conn = psock->s_conn;
   int ret = OK;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      ret = local_ring_ioctl(conn, cmd, arg);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+
+      ret = OK;
+    }
+#endif
+
   switch (cmd)
     {
       case FIONBIO:
@@ -1034,6 +1061,23 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      /* Connect the pair through rings instead of FIFOs */
+
+      ret = local_ring_connect(conns[0], conns[1]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      conns[0]->lc_state = conns[1]->lc_state
+                         = LOCAL_STATE_CONNECTED;
+      return OK;
+    }
+#endif
+
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
@@ -1132,6 +1176,15 @@ static int local_shutdown(FAR struct socket *psock, int how)
       case SOCK_STREAM:
         {
           FAR struct local_conn_s *conn = psock->s_conn;
+
+#ifdef CONFIG_NET_LOCAL_RING
+          if (conn->lc_rxring != NULL)
+            {
+              local_ring_shutdown(conn, how);
+              return OK;
+            }
+#endif
+
           if (how & SHUT_RD)
             {
               if (conn->lc_infile.f_inode != NULL)
@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <limits.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -35,6 +36,7 @@
 
 #include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "utils/utils.h"
 #include "mld/mld.h"
 
 #ifdef CONFIG_NET_MLD
@@ -118,9 +120,12 @@ int mld_waitmsg(FAR struct mld_group_s *group, uint8_t msgtype)
 
   while (IS_MLD_SCHEDMSG(group->flags))
     {
-      /* Wait for the semaphore to be posted */
+      /* Wait for the semaphore to be posted.  The device lock (if held)
+       * must be released so that the device can be polled to send it.
+       */
 
-      ret = nxsem_wait_uninterruptible(&group->sem);
+      ret = conn_dev_sem_timedwait(&group->sem, false, UINT_MAX, NULL,
+                                   netdev_findbyindex(group->ifindex));
       if (ret < 0)
         {
           break;
@@ -35,18 +35,70 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+#  include <nuttx/hashtable.h>
+#endif
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* Hash on the low bits of the interface identifier, which are the ones
+ * that differ between the neighbors of a link.
+ */
+
+#  define NEIGHBOR_HASHKEY(a) \
+     ((((uint32_t)(a)[6] << 16) | (a)[7]) ^ (a)[5])
+#  define neighbor_node(e)    container_of(e, struct neighbor_node_s, nn_entry)
+#else
+#  define neighbor_lock()
+#  define neighbor_unlock()
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  define ND_STATS(n)         (g_netstats.nd.n++)
+#else
+#  define ND_STATS(n)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* A Neighbor Table entry together with its hash and LRU links */
+
+struct neighbor_node_s
+{
+  hash_node_t              nn_node;   /* Hash bucket link */
+  dq_entry_t               nn_lru;    /* Least recently used list link */
+  struct neighbor_entry_s  nn_entry;  /* The neighbor itself */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* Neighbors hashed by IPv6 address, and all neighbors from the least to the
+ * most recently used.  Both are protected by neighbor_lock().
+ */
+
+extern hash_head_t g_neighbor_hash[1 << CONFIG_NET_IPv6_NCONF_HASH_BITS];
+extern dq_queue_t g_neighbor_lru;
+#else
 /* This is the Neighbor table.  The network should be locked when accessing
  * this table.
  */
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -54,6 +106,37 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_lock and neighbor_unlock
+ *
+ * Description:
+ *   Lock and unlock the hashed Neighbor Table.  The lock is recursive.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+void neighbor_lock(void);
+void neighbor_unlock(void);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get a node for a new neighbor: a free one if there is one, otherwise
+ *   the least recently used one, removed from its hash bucket but still
+ *   holding the old mapping (so that its removal can be notified).  The
+ *   node is the most recently used one on return.
+ *
+ * Assumptions:
+ *   The Neighbor Table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+FAR struct neighbor_node_s *neighbor_alloc(void);
+#endif
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -65,15 +65,51 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor = NULL;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
   bool    found = false;
   bool    new_entry;
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_node_s *node;
+  FAR hash_node_t *hnode;
+#else
+  clock_t oldest_time;
   int     i;
+#endif
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
+  lltype = dev->d_lltype;
+  neighbor_lock();
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  /* Find the matching entry in its hash bucket */
+
+  hashtable_for_every_possible(g_neighbor_hash, hnode,
+                               NEIGHBOR_HASHKEY(ipaddr))
+    {
+      node = container_of(hnode, struct neighbor_node_s, nn_node);
+      ND_STATS(probe);
+
+      if (node->nn_entry.ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(node->nn_entry.ne_ipaddr, ipaddr))
+        {
+          dq_rem(&node->nn_lru, &g_neighbor_lru);
+          dq_addlast(&node->nn_lru, &g_neighbor_lru);
+          found = true;
+          break;
+        }
+    }
+
+  /* Otherwise take a free entry or the least recently used one */
+
+  if (!found)
+    {
+      node = neighbor_alloc();
+    }
+
+  neighbor = &node->nn_entry;
+#else
   /* Find the matching entry, first unused entry, or the oldest used entry.
    * The unused entry will have ne_time == 0 and should generate the oldest
    * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
@@ -81,62 +117,72 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
    */
 
   oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  neighbor    = &g_neighbors[0];
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
+      ND_STATS(probe);
       if (g_neighbors[i].ne_addr.na_lltype == lltype &&
           net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
+          neighbor = &g_neighbors[i];
           found = true;
           break;
         }
 
       if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
         {
-          oldest_ndx = i;
+          neighbor = &g_neighbors[i];
           oldest_time = g_neighbors[i].ne_time;
         }
     }
 
+  if (!found && neighbor->ne_time != 0)
+    {
+      ND_STATS(evict);
+    }
+#endif
+
   /* When overwrite old entry, need to notify RTM_DELNEIGH */
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
+  if (!found && neighbor->ne_time != 0)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_DELNEIGH, AF_INET6);
     }
 
   /* Need to notify when entry is not found or changes in table */
 
-  new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-                             g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
+  new_entry = !found || memcmp(&neighbor->ne_addr.u, addr,
+                               neighbor->ne_addr.na_llsize) != 0;
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Use the matching, the oldest or the first free entry */
+
+  neighbor->ne_dev  = dev;
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_dev  = dev;
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  if (!found)
+    {
+      hashtable_add(g_neighbor_hash, &node->nn_node,
+                    NEIGHBOR_HASHKEY(neighbor->ne_ipaddr));
+    }
+#endif
 
   /* Notify the new entry */
 
   if (new_entry)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_NEWNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_NEWNEIGH, AF_INET6);
     }
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
+  neighbor_unlock();
 }
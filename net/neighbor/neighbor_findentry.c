@@ -29,6 +29,8 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -53,19 +55,53 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR hash_node_t *node;
+#else
   int i;
+#endif
+
+  ND_STATS(lookup);
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  hashtable_for_every_possible(g_neighbor_hash, node,
+                               NEIGHBOR_HASHKEY(ipaddr))
+    {
+      neighbor = &container_of(node, struct neighbor_node_s,
+                               nn_node)->nn_entry;
+#else
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      neighbor = &g_neighbors[i];
+#endif
 
+      ND_STATS(probe);
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
+#if CONFIG_NET_IPv6_NCONF_MAXAGE > 0
+          /* A mapping that was not confirmed for too long is stale */
+
+          if (clock_systime_ticks() - neighbor->ne_time >=
+              SEC2TICK(CONFIG_NET_IPv6_NCONF_MAXAGE))
+            {
+              break;
+            }
+#endif
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+          /* This is now the most recently used neighbor */
+
+          dq_rem(&neighbor_node(neighbor)->nn_lru, &g_neighbor_lru);
+          dq_addlast(&neighbor_node(neighbor)->nn_lru, &g_neighbor_lru);
+#endif
+
           neighbor_dumpentry("Entry found", neighbor);
           return neighbor;
         }
     }
 
+  ND_STATS(miss);
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
 }
@@ -26,18 +26,111 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+#include <assert.h>
+
+#include "utils/utils.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_MAX_ENTRIES
+#  define CONFIG_NET_IPv6_NCONF_MAX_ENTRIES 0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+NET_BUFPOOL_DECLARE(g_neighbor_pool, sizeof(struct neighbor_node_s),
+                    CONFIG_NET_IPv6_NCONF_ENTRIES,
+                    CONFIG_NET_IPv6_NCONF_ALLOC_ENTRIES,
+                    CONFIG_NET_IPv6_NCONF_MAX_ENTRIES);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* Neighbors hashed by IPv6 address, and all neighbors from the least to the
+ * most recently used.
+ */
+
+DECLARE_HASHTABLE(g_neighbor_hash, CONFIG_NET_IPv6_NCONF_HASH_BITS);
+dq_queue_t g_neighbor_lru;
+#else
 /* This is the Neighbor table.  The network should be locked when accessing
  * this table.
  */
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+
+/****************************************************************************
+ * Name: neighbor_lock
+ ****************************************************************************/
+
+void neighbor_lock(void)
+{
+  NET_BUFPOOL_LOCK(g_neighbor_pool);
+}
+
+/****************************************************************************
+ * Name: neighbor_unlock
+ ****************************************************************************/
+
+void neighbor_unlock(void)
+{
+  NET_BUFPOOL_UNLOCK(g_neighbor_pool);
+}
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get a node for a new neighbor: a free one if there is one, otherwise
+ *   the least recently used one, removed from its hash bucket but still
+ *   holding the old mapping (so that its removal can be notified).  The
+ *   node is the most recently used one on return.
+ *
+ * Assumptions:
+ *   The Neighbor Table is locked.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_node_s *neighbor_alloc(void)
+{
+  FAR struct neighbor_node_s *node;
+
+  node = NET_BUFPOOL_TRYALLOC(g_neighbor_pool);
+  if (node != NULL)
+    {
+      memset(node, 0, sizeof(*node));
+    }
+  else
+    {
+      DEBUGASSERT(g_neighbor_lru.head != NULL);
+      node = container_of(g_neighbor_lru.head, struct neighbor_node_s,
+                          nn_lru);
+
+      hashtable_delete(g_neighbor_hash, &node->nn_node,
+                       NEIGHBOR_HASHKEY(node->nn_entry.ne_ipaddr));
+      dq_rem(&node->nn_lru, &g_neighbor_lru);
+      ND_STATS(evict);
+    }
+
+  dq_addlast(&node->nn_lru, &g_neighbor_lru);
+  return node;
+}
+
+#endif /* CONFIG_NET_IPv6_NCONF_HASH */
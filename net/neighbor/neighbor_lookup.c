@@ -120,6 +120,7 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
 
   /* Check if the IPv6 address is already in the neighbor table. */
 
+  neighbor_lock();
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
@@ -132,6 +133,8 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
           memcpy(laddr, &neighbor->ne_addr, sizeof(*laddr));
         }
 
+      neighbor_unlock();
+
       /* Return success in any case meaning that a valid link layer
        * address mapping is available for the IPv6 address.
        */
@@ -139,6 +142,8 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
       return OK;
     }
 
+  neighbor_unlock();
+
   /* No.. check if the IPv6 address is the address assigned to a local
    * network device.  If so, return a mapping of that IPv6 address
    * to the linker layer address assigned to the network device.
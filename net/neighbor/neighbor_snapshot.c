@@ -63,16 +63,30 @@
 unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
                                unsigned int nentries)
 {
-  unsigned int ncopied;
+  unsigned int ncopied = 0;
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR dq_entry_t *node;
+#else
   int i;
+#endif
 
   /* Copy all non-empty entries in the Neighbor table. */
 
-  for (i = 0, ncopied = 0;
+  neighbor_lock();
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  for (node = g_neighbor_lru.head;
+       nentries > ncopied && node != NULL;
+       node = node->flink)
+    {
+      FAR struct neighbor_entry_s *neighbor =
+        &container_of(node, struct neighbor_node_s, nn_lru)->nn_entry;
+#else
+  for (i = 0;
        nentries > ncopied && i < CONFIG_NET_IPv6_NCONF_ENTRIES;
        i++)
     {
       FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+#endif
 
       /* An unused entry table entry will be nullified.  In particularly,
        * the Neighbor IP address will be all zero (i.e., the unspecified
@@ -87,6 +101,8 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
         }
     }
 
+  neighbor_unlock();
+
   /* Return the number of entries copied into the user buffer */
 
   return ncopied;
@@ -331,6 +331,58 @@ void netdev_ipv6_txnotify(FAR const net_ipv6addr_t lipaddr,
 
 void netdev_txnotify_dev(FAR struct net_driver_s *dev, uint32_t polltype);
 
+/****************************************************************************
+ * Name: netdev_txnotify_conn
+ *
+ * Description:
+ *   Notify the device driver that new TX data is available for a specific
+ *   connection.  With CONFIG_NETDEV_READYLIST, the connection is queued on
+ *   the device's ready list so that devif_poll() need not scan every
+ *   connection of that protocol.
+ *
+ * Input Parameters:
+ *   dev      - The network device driver state structure.
+ *   conn     - The connection that has something to send.
+ *   polltype - The type of poll to be triggered for the device.
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_READYLIST
+struct socket_conn_s; /* Forward reference */
+void netdev_txnotify_conn(FAR struct net_driver_s *dev,
+                          FAR struct socket_conn_s *conn,
+                          uint32_t polltype);
+#else
+#  define netdev_txnotify_conn(dev, conn, polltype) \
+     netdev_txnotify_dev(dev, polltype)
+#endif
+
+/****************************************************************************
+ * Name: netdev_txnotify_cancel
+ *
+ * Description:
+ *   Remove a connection from the ready list of the device it is queued on,
+ *   if any.  Must be called before the connection is freed.
+ *
+ * Input Parameters:
+ *   conn     - The connection being released.
+ *   polltype - The poll type the connection was queued with.
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_READYLIST
+void netdev_txnotify_cancel(FAR struct socket_conn_s *conn,
+                            uint32_t polltype);
+#else
+#  define netdev_txnotify_cancel(conn, polltype)
+#endif
+
 /****************************************************************************
  * Name: netdev_count
  *
@@ -183,11 +183,13 @@ netdev_prefixlen_findby_lipv6addr(const net_ipv6addr_t lipaddr,
 
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
   /* Find a hint from neighbor table in case same prefix length exists on
-   * multiple devices.
+   * multiple devices.  The lookup reorders the hashed table, lock it.
    */
 
+  neighbor_lock();
   ne   = neighbor_findentry(lipaddr);
   hint = ne ? ne->ne_dev : NULL;
+  neighbor_unlock();
 #endif
 
   /* Examine each registered network device */
@@ -237,7 +237,8 @@ FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
   FAR struct iob_s *iob;
   int ret;
 
-  iob = iob_tryalloc(throttled);
+  iob = iob_tryalloc_size(throttled, dev->d_iob->io_pktlen +
+                               CONFIG_NET_LL_GUARDSIZE);
   if (iob == NULL)
     {
       nwarn("WARNING: IOB alloc failed for dev %s!\n", dev->d_ifname);
@@ -85,6 +85,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
 
@@ -154,6 +155,7 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   in_addr_t target;
   in_addr_t netmask;
   in_addr_t router;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_dst;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -164,7 +166,13 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_gateway;
   router  = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_addroute_ipv4(target, netmask, router);
+  ret = net_addroute_ipv4(target, netmask, router);
+  if (ret >= 0)
+    {
+      ipfwd_flow_flush(NULL);
+    }
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -217,6 +225,7 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   FAR struct sockaddr_in *addr;
   in_addr_t target;
   in_addr_t netmask;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_dst;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -224,7 +233,13 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_genmask;
   netmask = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_delroute_ipv4(target, netmask);
+  ret = net_delroute_ipv4(target, netmask);
+  if (ret >= 0)
+    {
+      ipfwd_flow_flush(NULL);
+    }
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -929,6 +944,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFDSTADDR:  /* Set P-to-P address */
         ioctl_set_ipv4addr(&dev->d_draddr, &req->ifr_dstaddr);
+        ipfwd_flow_flush(NULL);
         break;
 
       case SIOCGIFBRDADDR:  /* Get broadcast IP address */
@@ -946,6 +962,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+        ipfwd_flow_flush(NULL);
         break;
 #endif
 
@@ -1162,6 +1179,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               }
 
             ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+            ipfwd_flow_flush(NULL);
             netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
 
@@ -1193,6 +1211,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+            ipfwd_flow_flush(NULL);
           }
 #endif
 
@@ -2094,6 +2113,10 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
 
               devif_dev_event(dev, NETDEV_DOWN);
 
+              /* Forget the flows using the device */
+
+              ipfwd_flow_flush(dev);
+
 #ifdef CONFIG_NETDOWN_NOTIFIER
               /* Provide signal notifications to threads that want to be
                * notified of the network down state via signal.
@@ -74,6 +74,7 @@ static const toeplitz_key_u g_random_key =
   }
 };
 
+#ifdef CONFIG_NETDEV_RSS
 static const uint32_t g_crc32c_table[256] =
 {
   0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
@@ -120,58 +121,13 @@ static const uint32_t g_crc32c_table[256] =
   0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
   0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
 };
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: compute_toeplitz_hash
- *
- * Description:
- *   HASHCAL_ALGO_TOEPLITZ is a hash algorithm that uses Toeplitz matrix to
- *   calculate hash values. Toeplitz matrix is a special matrix where each
- *   diagonal has the same elements.
- *
- * Input Parameters:
- *   packet - The packet data
- *   len    - The packet length in bytes
- *
- * Returned Value:
- *   The hash value with toeplitz matrix calculation
- *
- ****************************************************************************/
-
-static uint32_t compute_toeplitz_hash(FAR const uint8_t *packet,
-                                      uint32_t len)
-{
-  uint32_t key = (g_random_key.u8[0] << 24) | (g_random_key.u8[1] << 16) |
-                 (g_random_key.u8[2] << 8) | g_random_key.u8[3];
-  uint32_t ret = 0;
-  int i;
-  int j;
-
-  for (i = 0; i < len; i++)
-    {
-      for (j = 0; j < 8; j++)
-        {
-          if (packet[i] & (1 << (7 - j)))
-            {
-              ret ^= key;
-            }
-
-          key <<= 1;
-          if ((i + 4) < RANDOM_KEY_SIZE &&
-              (g_random_key.u8[i + 4] & (1 << (7 - j))))
-            {
-              key |= 1;
-            }
-        }
-    }
-
-  return ret;
-}
-
+#ifdef CONFIG_NETDEV_RSS
 /****************************************************************************
  * Name: compute_xor_hash
  *
@@ -368,7 +324,7 @@ static uint32_t compute_hash(hashcal_algo_e hash_algo,
   switch (hash_algo)
     {
       case HASHCAL_ALGO_TOEPLITZ:
-        hash_val = compute_toeplitz_hash(packet, cal_len);
+        hash_val = netdev_toeplitz_hash(packet, cal_len);
         break;
 
       case HASHCAL_ALGO_XOR:
@@ -386,10 +342,61 @@ static uint32_t compute_hash(hashcal_algo_e hash_algo,
   return hash_val;
 }
 
+#endif /* CONFIG_NETDEV_RSS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_toeplitz_hash
+ *
+ * Description:
+ *   HASHCAL_ALGO_TOEPLITZ is a hash algorithm that uses Toeplitz matrix to
+ *   calculate hash values. Toeplitz matrix is a special matrix where each
+ *   diagonal has the same elements.  The key is the default RSS key of the
+ *   Microsoft RSS specification, so the result matches what NICs compute
+ *   for their receive queues unless they are reprogrammed.
+ *
+ * Input Parameters:
+ *   packet - The packet data
+ *   len    - The packet length in bytes
+ *
+ * Returned Value:
+ *   The hash value with toeplitz matrix calculation
+ *
+ ****************************************************************************/
+
+uint32_t netdev_toeplitz_hash(FAR const uint8_t *packet, uint32_t len)
+{
+  uint32_t key = (g_random_key.u8[0] << 24) | (g_random_key.u8[1] << 16) |
+                 (g_random_key.u8[2] << 8) | g_random_key.u8[3];
+  uint32_t ret = 0;
+  int i;
+  int j;
+
+  for (i = 0; i < len; i++)
+    {
+      for (j = 0; j < 8; j++)
+        {
+          if (packet[i] & (1 << (7 - j)))
+            {
+              ret ^= key;
+            }
+
+          key <<= 1;
+          if ((i + 4) < RANDOM_KEY_SIZE &&
+              (g_random_key.u8[i + 4] & (1 << (7 - j))))
+            {
+              key |= 1;
+            }
+        }
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_NETDEV_RSS
 /****************************************************************************
  * Name: netdev_notify_recvcpu
  *
@@ -436,3 +443,4 @@ void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
         }
     }
 }
+#endif /* CONFIG_NETDEV_RSS */
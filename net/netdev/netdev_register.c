@@ -426,6 +426,14 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_devcb = NULL;
 
       dev->d_polltype = 0;
+#ifdef CONFIG_NETDEV_READYLIST
+#  ifdef CONFIG_NET_TCP
+      dq_init(&dev->d_tcpready);
+#  endif
+#  ifdef CONFIG_NET_UDP
+      dq_init(&dev->d_udpready);
+#  endif
+#endif
 
       nxrmutex_init(&dev->d_lock);
 
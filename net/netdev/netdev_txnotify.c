@@ -31,11 +31,48 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 
+#include "devif/devif.h"
 #include "netdev/netdev.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_readyq
+ *
+ * Description:
+ *   Return the device ready list used for a poll type, or NULL if that
+ *   protocol does not use one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_READYLIST
+static FAR dq_queue_t *netdev_readyq(FAR struct net_driver_s *dev,
+                                     uint32_t polltype)
+{
+#ifdef CONFIG_NET_TCP
+  if (polltype == TCP_POLL)
+    {
+      return &dev->d_tcpready;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (polltype == UDP_POLL)
+    {
+      return &dev->d_udpready;
+    }
+#endif
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,3 +159,91 @@ void netdev_txnotify_dev(FAR struct net_driver_s *dev, uint32_t polltype)
       dev->d_txavail(dev);
     }
 }
+
+/****************************************************************************
+ * Name: netdev_txnotify_conn
+ *
+ * Description:
+ *   Notify the device driver that new TX data is available for a specific
+ *   connection and queue the connection on the device ready list.
+ *
+ * Input Parameters:
+ *   dev      - The network device driver state structure.
+ *   conn     - The connection that has something to send.
+ *   polltype - The type of poll to be triggered for the device.
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_READYLIST
+void netdev_txnotify_conn(FAR struct net_driver_s *dev,
+                          FAR struct socket_conn_s *conn,
+                          uint32_t polltype)
+{
+  FAR dq_queue_t *readyq;
+
+  if (dev == NULL || dev->d_txavail == NULL)
+    {
+      return;
+    }
+
+  netdev_lock(dev);
+
+  /* A connection is on at most one ready list.  If it is already queued
+   * (on this device or, transiently, on the one it used before) it will
+   * be visited by that poll.
+   */
+
+  readyq = netdev_readyq(dev, polltype);
+  if (readyq != NULL && conn->s_readydev == NULL)
+    {
+      dq_addlast(&conn->s_ready, readyq);
+      conn->s_readydev = dev;
+    }
+
+  netdev_txnotify_dev(dev, polltype);
+  netdev_unlock(dev);
+}
+
+/****************************************************************************
+ * Name: netdev_txnotify_cancel
+ *
+ * Description:
+ *   Remove a connection from the ready list of the device it is queued on.
+ *
+ * Input Parameters:
+ *   conn     - The connection being released.
+ *   polltype - The poll type the connection was queued with.
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+void netdev_txnotify_cancel(FAR struct socket_conn_s *conn,
+                            uint32_t polltype)
+{
+  FAR struct net_driver_s *dev = conn->s_readydev;
+  FAR dq_queue_t *readyq;
+
+  if (dev == NULL)
+    {
+      return;
+    }
+
+  netdev_lock(dev);
+
+  /* The poll may have dequeued it while we were waiting for the lock */
+
+  readyq = netdev_readyq(dev, polltype);
+  if (readyq != NULL && conn->s_readydev == dev)
+    {
+      dq_rem(&conn->s_ready, readyq);
+      conn->s_readydev = NULL;
+    }
+
+  netdev_unlock(dev);
+}
+#endif /* CONFIG_NETDEV_READYLIST */
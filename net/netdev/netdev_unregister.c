@@ -35,11 +35,14 @@
 
 #include <net/if.h>
 #include <net/ethernet.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 
 #include "mld/mld.h"
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -89,6 +92,29 @@ static inline void free_ifindex(int ndx)
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_readyq_flush
+ *
+ * Description:
+ *   Detach every connection still queued on a device ready list so that no
+ *   connection is left pointing at the departing device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_READYLIST
+static void netdev_readyq_flush(FAR dq_queue_t *readyq)
+{
+  FAR struct socket_conn_s *conn;
+  FAR dq_entry_t *entry;
+
+  while ((entry = dq_remfirst(readyq)) != NULL)
+    {
+      conn = container_of(entry, struct socket_conn_s, s_ready);
+      conn->s_readydev = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -163,6 +189,21 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
       netdev_list_unlock();
 
+      /* Forget the flows using the device */
+
+      ipfwd_flow_flush(dev);
+
+#ifdef CONFIG_NETDEV_READYLIST
+      netdev_lock(dev);
+#  ifdef CONFIG_NET_TCP
+      netdev_readyq_flush(&dev->d_tcpready);
+#  endif
+#  ifdef CONFIG_NET_UDP
+      netdev_readyq_flush(&dev->d_udpready);
+#  endif
+      netdev_unlock(dev);
+#endif
+
       nxrmutex_destroy(&dev->d_lock);
 
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
@@ -352,6 +352,38 @@ skip_match:
 }
 #endif
 
+/****************************************************************************
+ * Name: ipt_filter_counter / ip6t_filter_counter
+ *
+ * Description:
+ *   Copy the counters of a filter entry into its iptables entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static void ipt_filter_counter(FAR struct ipfilter_entry_s *filter,
+                               FAR void *arg)
+{
+  FAR struct ipt_entry *entry = (FAR struct ipt_entry *)
+                                ((FAR uint8_t *)arg + filter->offset);
+
+  entry->counters.pcnt = filter->pcnt;
+  entry->counters.bcnt = filter->bcnt;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static void ip6t_filter_counter(FAR struct ipfilter_entry_s *filter,
+                                FAR void *arg)
+{
+  FAR struct ip6t_entry *entry = (FAR struct ip6t_entry *)
+                                 ((FAR uint8_t *)arg + filter->offset);
+
+  entry->counters.pcnt = filter->pcnt;
+  entry->counters.bcnt = filter->bcnt;
+}
+#endif
+
 /****************************************************************************
  * Name: adjust_filter
  *
@@ -393,6 +425,8 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
           FAR struct ipv4_filter_entry_s *filter = convert_ipv4entry(entry);
           if (filter != NULL)
             {
+              filter->common.offset = (uintptr_t)entry -
+                                      (uintptr_t)repl->entries;
               ipfilter_cfg_add(&filter->common, PF_INET, chain);
             }
           else
@@ -400,6 +434,8 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
               nwarn("WARNING: Failed to convert entry!\n");
             }
         }
+
+      ipfilter_cfg_commit(PF_INET, chain);
     }
 }
 #endif
@@ -434,6 +470,8 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
           FAR struct ipv6_filter_entry_s *filter = convert_ipv6entry(entry);
           if (filter != NULL)
             {
+              filter->common.offset = (uintptr_t)entry -
+                                      (uintptr_t)repl->entries;
               ipfilter_cfg_add(&filter->common, PF_INET6, chain);
             }
           else
@@ -441,6 +479,8 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
               nwarn("WARNING: Failed to convert entry!\n");
             }
         }
+
+      ipfilter_cfg_commit(PF_INET6, chain);
     }
 }
 #endif
@@ -599,3 +639,38 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl)
   return OK;
 }
 #endif
+
+/****************************************************************************
+ * Name: ipt_filter_counters
+ *
+ * Description:
+ *   Fill the packet and byte counters of the filter table entries.
+ *
+ * Input Parameters:
+ *   entries - A copy of the entries of the current filter table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipt_filter_counters(FAR void *entries)
+{
+  enum ipfilter_chain_e chain;
+
+  for (chain = IPFILTER_CHAIN_INPUT; chain < IPFILTER_CHAIN_MAX; chain++)
+    {
+      ipfilter_cfg_foreach(PF_INET, chain, ipt_filter_counter, entries);
+    }
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void ip6t_filter_counters(FAR void *entries)
+{
+  enum ipfilter_chain_e chain;
+
+  for (chain = IPFILTER_CHAIN_INPUT; chain < IPFILTER_CHAIN_MAX; chain++)
+    {
+      ipfilter_cfg_foreach(PF_INET6, chain, ip6t_filter_counter, entries);
+    }
+}
+#endif
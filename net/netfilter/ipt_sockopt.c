@@ -55,6 +55,7 @@ struct ipt_table_s
   FAR struct ipt_replace *repl;
   FAR struct ipt_replace *(*init_func)(void);
   FAR int (*apply_func)(FAR const struct ipt_replace *);
+  void (*counters_func)(FAR void *entries);
 };
 
 /* Following structs represent the layout of an entry with standard/error
@@ -82,10 +83,10 @@ struct ipt_error_entry_s
 static struct ipt_table_s g_tables[] =
 {
 #ifdef CONFIG_NET_NAT
-  {NULL, ipt_nat_init, ipt_nat_apply},
+  {NULL, ipt_nat_init, ipt_nat_apply, NULL},
 #endif
 #ifdef CONFIG_NET_IPFILTER
-  {NULL, ipt_filter_init, ipt_filter_apply},
+  {NULL, ipt_filter_init, ipt_filter_apply, ipt_filter_counters},
 #endif
 };
 
@@ -200,6 +201,7 @@ static int get_info(FAR struct ipt_getinfo *get, FAR socklen_t *len)
 
 static int get_entries(FAR struct ipt_get_entries *get, FAR socklen_t *len)
 {
+  FAR struct ipt_table_s *table;
   FAR struct ipt_replace *repl;
 
   if (*len < sizeof(*get) || *len != sizeof(*get) + get->size)
@@ -207,12 +209,13 @@ static int get_entries(FAR struct ipt_get_entries *get, FAR socklen_t *len)
       return -EINVAL;
     }
 
-  repl = ipt_table_repl(get->name);
-  if (repl == NULL)
+  table = ipt_table(get->name);
+  if (table == NULL || table->repl == NULL)
     {
       return -ENOENT;
     }
 
+  repl = table->repl;
   if (get->size != repl->size)
     {
       return -EAGAIN;
@@ -220,6 +223,13 @@ static int get_entries(FAR struct ipt_get_entries *get, FAR socklen_t *len)
 
   memcpy(get->entrytable, repl->entries, get->size);
 
+  /* The counters are kept by the table, not in the saved entries. */
+
+  if (table->counters_func != NULL)
+    {
+      table->counters_func(get->entrytable);
+    }
+
   return OK;
 }
 
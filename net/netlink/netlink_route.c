@@ -48,6 +48,7 @@
 #include "net/if_arp.h"
 #include "neighbor/neighbor.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
 
@@ -1025,6 +1026,10 @@ static int netlink_new_ipv4addr(NETLINK_HANDLE handle,
                                ifm->ifa_prefixlen);
   netdev_unlock(dev);
 
+  /* Cached flows may have been resolved against the old address */
+
+  ipfwd_flow_flush(NULL);
+
   return OK;
 }
 #endif
@@ -1124,6 +1129,7 @@ static int netlink_del_ipv4addr(NETLINK_HANDLE handle,
   dev->d_ipaddr  = 0;
 
   netdev_unlock(dev);
+  ipfwd_flow_flush(NULL);
 
   return OK;
 }
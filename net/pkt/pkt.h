@@ -54,6 +54,8 @@
 
 struct devif_callback_s; /* Forward reference */
 struct pollfd;           /* Forward reference */
+struct pkt_filter_s;     /* Forward reference */
+struct pkt_ring_s;       /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -98,14 +100,25 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 
   FAR struct iob_s  *pendiob;     /* The iob currently being sent */
 
+#ifdef CONFIG_NET_PKT_FILTER
+  FAR struct pkt_filter_s *filter; /* SO_ATTACH_FILTER program */
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+  /* Memory-mapped receive ring (PACKET_RX_RING).  Received frames are
+   * written to the ring instead of the read-ahead queue while it is set.
+   */
+
+  FAR struct pkt_ring_s *ring;
+  uint8_t    version;             /* PACKET_VERSION */
+#endif
+
   /* The following is a list of poll structures of threads waiting for
    * socket events.
    */
@@ -133,8 +146,12 @@ EXTERN const struct sock_intf_s g_pkt_sockif;
  * Public Function Prototypes
  ****************************************************************************/
 
-struct net_driver_s; /* Forward reference */
-struct socket;       /* Forward reference */
+struct net_driver_s;     /* Forward reference */
+struct socket;           /* Forward reference */
+struct sock_fprog;       /* Forward reference */
+struct tpacket_req3;     /* Forward reference */
+struct tpacket_stats_v3; /* Forward reference */
+struct mm_map_entry_s;   /* Forward reference */
 
 /****************************************************************************
  * Name: pkt_alloc()
@@ -463,6 +480,124 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
 #endif
 
+#ifdef CONFIG_NET_PKT_FILTER
+/****************************************************************************
+ * Name: pkt_filter_attach
+ *
+ * Description:
+ *   Attach a classic BPF program to a packet socket (SO_ATTACH_FILTER),
+ *   replacing the previous one.
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_filter_attach(FAR struct pkt_conn_s *conn,
+                      FAR const struct sock_fprog *fprog);
+
+/****************************************************************************
+ * Name: pkt_filter_detach
+ *
+ * Description:
+ *   Remove the filter of a packet socket (SO_DETACH_FILTER).
+ *
+ ****************************************************************************/
+
+void pkt_filter_detach(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run the filter of a packet socket on the received frame.
+ *
+ * Returned Value:
+ *   The number of bytes of the frame to deliver, 0 to drop it.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+uint32_t pkt_filter_run(FAR struct net_driver_s *dev,
+                        FAR struct pkt_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up (or with tp_block_nr 0, release) the receive ring of a packet
+ *   socket (PACKET_RX_RING).
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Detach the receive ring of a packet socket, if any.  The memory is
+ *   freed once the ring is no longer mapped.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Write the first 'snaplen' bytes of the received frame to the ring.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, uint32_t snaplen);
+
+/****************************************************************************
+ * Name: pkt_ring_ready
+ *
+ * Description:
+ *   Return true if a block of the ring is owned by the application.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_ready(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the receive ring into the caller (the si_mmap method).
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock,
+                  FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_stats
+ *
+ * Description:
+ *   Return and reset the ring statistics (PACKET_STATISTICS).
+ *
+ ****************************************************************************/
+
+void pkt_ring_stats(FAR struct pkt_conn_s *conn,
+                    FAR struct tpacket_stats_v3 *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -122,6 +122,19 @@ void pkt_free(FAR struct pkt_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+#ifdef CONFIG_NET_PKT_RING
+  /* Release the receive ring, it waits for the retire timer so this is
+   * done before taking the list lock.
+   */
+
+  pkt_ring_free(conn);
+  conn->version = 0;
+#endif
+
+#ifdef CONFIG_NET_PKT_FILTER
+  pkt_filter_detach(conn);
+#endif
+
   NET_BUFPOOL_LOCK(g_pkt_connections);
 
   /* Remove the connection from the active list */
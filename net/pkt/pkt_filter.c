@@ -0,0 +1,505 @@
+/****************************************************************************
+ * net/pkt/pkt_filter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/bpf.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#if defined(CONFIG_NET_PKT) && defined(CONFIG_NET_PKT_FILTER)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pkt_filter_s
+{
+  uint16_t len;                /* Number of instructions */
+  struct sock_filter insns[1]; /* The program, len instructions */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_check
+ *
+ * Description:
+ *   Verify that a program can be run safely: all jumps are forward and stay
+ *   in the program, scratch memory accesses are in range, divisions by a
+ *   constant are not by zero and the last instruction returns.
+ *
+ ****************************************************************************/
+
+static int pkt_filter_check(FAR const struct sock_filter *insns,
+                            uint16_t len)
+{
+  FAR const struct sock_filter *insn;
+  uint32_t pc;
+
+  if (len == 0 || len > BPF_MAXINSNS)
+    {
+      return -EINVAL;
+    }
+
+  for (pc = 0; pc < len; pc++)
+    {
+      insn = &insns[pc];
+
+      switch (BPF_CLASS(insn->code))
+        {
+          case BPF_LD:
+          case BPF_LDX:
+            if (BPF_MODE(insn->code) == BPF_MEM &&
+                insn->k >= BPF_MEMWORDS)
+              {
+                return -EINVAL;
+              }
+
+            if (BPF_MODE(insn->code) == BPF_MSH &&
+                (BPF_CLASS(insn->code) != BPF_LDX ||
+                 BPF_SIZE(insn->code) != BPF_B))
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_ST:
+          case BPF_STX:
+            if (insn->k >= BPF_MEMWORDS)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_ALU:
+            if ((BPF_OP(insn->code) == BPF_DIV ||
+                 BPF_OP(insn->code) == BPF_MOD) &&
+                BPF_SRC(insn->code) == BPF_K && insn->k == 0)
+              {
+                return -EINVAL;
+              }
+
+            if (BPF_OP(insn->code) > BPF_XOR)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_JMP:
+            if (BPF_OP(insn->code) == BPF_JA)
+              {
+                if (insn->k >= len - pc - 1)
+                  {
+                    return -EINVAL;
+                  }
+              }
+            else if (BPF_OP(insn->code) > BPF_JSET ||
+                     pc + 1 + insn->jt >= len || pc + 1 + insn->jf >= len)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_RET:
+          case BPF_MISC:
+            break;
+        }
+    }
+
+  return BPF_CLASS(insns[len - 1].code) == BPF_RET ? OK : -EINVAL;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_load
+ *
+ * Description:
+ *   Load 'size' bytes at offset 'off' of the link layer frame in network
+ *   byte order.
+ *
+ * Returned Value:
+ *   true on success, false if the data is beyond the end of the frame.
+ *
+ ****************************************************************************/
+
+static bool pkt_filter_load(FAR struct net_driver_s *dev, uint32_t off,
+                            unsigned int size, FAR uint32_t *val)
+{
+  FAR const uint8_t *ptr;
+  uint8_t buf[4];
+  unsigned int head;
+
+  if (off >= dev->d_len || size > dev->d_len - off)
+    {
+      return false;
+    }
+
+  /* The link layer header and the data of the first I/O buffer are
+   * contiguous, most loads are from there.
+   */
+
+  head = NET_LL_HDRLEN(dev) + dev->d_iob->io_len;
+  if (off + size <= head)
+    {
+      ptr = (FAR const uint8_t *)NETLLBUF + off;
+    }
+  else
+    {
+      if (iob_copyout(buf, dev->d_iob, size,
+                      (int)off - NET_LL_HDRLEN(dev)) != size)
+        {
+          return false;
+        }
+
+      ptr = buf;
+    }
+
+  switch (size)
+    {
+      case 4:
+        *val = ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) |
+               ((uint32_t)ptr[2] << 8) | ptr[3];
+        break;
+
+      case 2:
+        *val = ((uint32_t)ptr[0] << 8) | ptr[1];
+        break;
+
+      default:
+        *val = ptr[0];
+        break;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_attach
+ *
+ * Description:
+ *   Attach a classic BPF program to a packet socket (SO_ATTACH_FILTER),
+ *   replacing the previous one.
+ *
+ * Input Parameters:
+ *   conn  - The packet socket connection
+ *   fprog - The program from the application
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_filter_attach(FAR struct pkt_conn_s *conn,
+                      FAR const struct sock_fprog *fprog)
+{
+  FAR struct pkt_filter_s *filter;
+  FAR struct pkt_filter_s *old;
+  uint16_t len;
+  int ret;
+
+  if (fprog == NULL || fprog->filter == NULL)
+    {
+      return -EINVAL;
+    }
+
+  len = fprog->len;
+  if (len == 0 || len > BPF_MAXINSNS)
+    {
+      return -EINVAL;
+    }
+
+  filter = kmm_malloc(sizeof(struct pkt_filter_s) +
+                      (len - 1) * sizeof(struct sock_filter));
+  if (filter == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Check the copy, the caller may change its program meanwhile */
+
+  filter->len = len;
+  memcpy(filter->insns, fprog->filter, len * sizeof(struct sock_filter));
+
+  ret = pkt_filter_check(filter->insns, len);
+  if (ret < 0)
+    {
+      nerr("ERROR: Invalid packet filter\n");
+      kmm_free(filter);
+      return ret;
+    }
+
+  conn_lock(&conn->sconn);
+  old = conn->filter;
+  conn->filter = filter;
+  conn_unlock(&conn->sconn);
+
+  kmm_free(old);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_detach
+ *
+ * Description:
+ *   Remove the filter of a packet socket (SO_DETACH_FILTER).
+ *
+ ****************************************************************************/
+
+void pkt_filter_detach(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_filter_s *old;
+
+  conn_lock(&conn->sconn);
+  old = conn->filter;
+  conn->filter = NULL;
+  conn_unlock(&conn->sconn);
+
+  kmm_free(old);
+}
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run the filter of a packet socket on the received frame.
+ *
+ * Input Parameters:
+ *   dev  - The device with the frame in d_iob, d_len bytes including the
+ *          link layer header
+ *   conn - The packet socket connection
+ *
+ * Returned Value:
+ *   The number of bytes of the frame to deliver, 0 to drop it.  d_len if
+ *   the socket has no filter.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+uint32_t pkt_filter_run(FAR struct net_driver_s *dev,
+                        FAR struct pkt_conn_s *conn)
+{
+  FAR const struct pkt_filter_s *filter = conn->filter;
+  FAR const struct sock_filter *insn;
+  uint32_t mem[BPF_MEMWORDS];
+  uint32_t a = 0;
+  uint32_t x = 0;
+  uint32_t pc;
+  uint32_t val;
+  uint32_t src;
+  bool ok;
+
+  if (filter == NULL)
+    {
+      return dev->d_len;
+    }
+
+  /* The scratch memory reads as zero until it is stored to */
+
+  memset(mem, 0, sizeof(mem));
+
+  for (pc = 0; pc < filter->len; pc++)
+    {
+      insn = &filter->insns[pc];
+
+      switch (BPF_CLASS(insn->code))
+        {
+          case BPF_LD:
+          case BPF_LDX:
+            switch (BPF_MODE(insn->code))
+              {
+                case BPF_IMM:
+                  val = insn->k;
+                  break;
+
+                case BPF_LEN:
+                  val = dev->d_len;
+                  break;
+
+                case BPF_MEM:
+                  val = mem[insn->k];
+                  break;
+
+                case BPF_ABS:
+                case BPF_IND:
+                case BPF_MSH:
+                  ok = pkt_filter_load(dev,
+                         BPF_MODE(insn->code) == BPF_IND ? x + insn->k :
+                                                           insn->k,
+                         BPF_SIZE(insn->code) == BPF_W ? 4 :
+                         BPF_SIZE(insn->code) == BPF_H ? 2 : 1, &val);
+                  if (!ok)
+                    {
+                      /* Out of the frame, drop it */
+
+                      return 0;
+                    }
+
+                  if (BPF_MODE(insn->code) == BPF_MSH)
+                    {
+                      val = (val & 0x0f) << 2;
+                    }
+                  break;
+
+                default:
+                  return 0;
+              }
+
+            if (BPF_CLASS(insn->code) == BPF_LD)
+              {
+                a = val;
+              }
+            else
+              {
+                x = val;
+              }
+            break;
+
+          case BPF_ST:
+            mem[insn->k] = a;
+            break;
+
+          case BPF_STX:
+            mem[insn->k] = x;
+            break;
+
+          case BPF_ALU:
+            src = BPF_SRC(insn->code) == BPF_X ? x : insn->k;
+            switch (BPF_OP(insn->code))
+              {
+                case BPF_ADD:
+                  a += src;
+                  break;
+
+                case BPF_SUB:
+                  a -= src;
+                  break;
+
+                case BPF_MUL:
+                  a *= src;
+                  break;
+
+                case BPF_DIV:
+                case BPF_MOD:
+                  if (src == 0)
+                    {
+                      return 0;
+                    }
+
+                  a = BPF_OP(insn->code) == BPF_DIV ? a / src : a % src;
+                  break;
+
+                case BPF_OR:
+                  a |= src;
+                  break;
+
+                case BPF_AND:
+                  a &= src;
+                  break;
+
+                case BPF_LSH:
+                  a = src < 32 ? a << src : 0;
+                  break;
+
+                case BPF_RSH:
+                  a = src < 32 ? a >> src : 0;
+                  break;
+
+                case BPF_NEG:
+                  a = -a;
+                  break;
+
+                case BPF_XOR:
+                  a ^= src;
+                  break;
+              }
+            break;
+
+          case BPF_JMP:
+            src = BPF_SRC(insn->code) == BPF_X ? x : insn->k;
+            switch (BPF_OP(insn->code))
+              {
+                case BPF_JA:
+                  pc += insn->k;
+                  break;
+
+                case BPF_JEQ:
+                  pc += a == src ? insn->jt : insn->jf;
+                  break;
+
+                case BPF_JGT:
+                  pc += a > src ? insn->jt : insn->jf;
+                  break;
+
+                case BPF_JGE:
+                  pc += a >= src ? insn->jt : insn->jf;
+                  break;
+
+                case BPF_JSET:
+                  pc += (a & src) != 0 ? insn->jt : insn->jf;
+                  break;
+              }
+            break;
+
+          case BPF_RET:
+            return BPF_RVAL(insn->code) == BPF_A ? a : insn->k;
+
+          case BPF_MISC:
+            if (BPF_MISCOP(insn->code) == BPF_TAX)
+              {
+                x = a;
+              }
+            else
+              {
+                a = x;
+              }
+            break;
+        }
+    }
+
+  /* Not reached, the program was checked to end with a return */
+
+  return 0;
+}
+
+#endif /* CONFIG_NET_PKT && CONFIG_NET_PKT_FILTER */
@@ -32,6 +32,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <netpacket/packet.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/pkt.h>
 
@@ -113,6 +114,32 @@ int pkt_getsockopt(FAR struct socket *psock, int level, int option,
           }
 #endif
 
+#ifdef CONFIG_NET_PKT_RING
+      case PACKET_VERSION:
+        {
+          FAR struct pkt_conn_s *conn = psock->s_conn;
+
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->version;
+          *value_len        = sizeof(int);
+        }
+        break;
+
+      case PACKET_STATISTICS:
+        if (*value_len < sizeof(struct tpacket_stats_v3))
+          {
+            return -EINVAL;
+          }
+
+        pkt_ring_stats(psock->s_conn, value);
+        *value_len = sizeof(struct tpacket_stats_v3);
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized RAW PKT socket option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
 
+#include <sys/param.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -160,6 +161,10 @@ static int pkt_in(FAR struct net_driver_s *dev)
   conn = pkt_active(dev);
   if (conn)
     {
+#if defined(CONFIG_NET_PKT_FILTER) || defined(CONFIG_NET_PKT_RING)
+      uint32_t snaplen = dev->d_len;
+      uint16_t len;
+#endif
       uint32_t flags;
 
       if (conn->pendiob == dev->d_iob)
@@ -181,6 +186,38 @@ static int pkt_in(FAR struct net_driver_s *dev)
         }
 #endif /* CONFIG_NET_TIMESTAMP */
 
+#if defined(CONFIG_NET_PKT_FILTER) || defined(CONFIG_NET_PKT_RING)
+      /* Run the socket filter, it decides how much of the frame to keep */
+
+      conn_lock(&conn->sconn);
+#  ifdef CONFIG_NET_PKT_FILTER
+      snaplen = MIN(pkt_filter_run(dev, conn), dev->d_len);
+#  endif
+
+#  ifdef CONFIG_NET_PKT_RING
+      if (snaplen > 0 && conn->ring != NULL)
+        {
+          /* Write the frame to the memory-mapped ring instead */
+
+          pkt_ring_input(dev, conn, snaplen);
+          snaplen = 0;
+        }
+#  endif
+
+      conn_unlock(&conn->sconn);
+
+      if (snaplen == 0)
+        {
+          pkt_conn_list_unlock();
+          return OK;
+        }
+
+      /* Deliver only the accepted part of the frame */
+
+      len        = dev->d_len;
+      dev->d_len = snaplen;
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -208,6 +245,10 @@ static int pkt_in(FAR struct net_driver_s *dev)
               ret = -EAGAIN;
             }
         }
+
+#if defined(CONFIG_NET_PKT_FILTER) || defined(CONFIG_NET_PKT_RING)
+      dev->d_len = len;
+#endif
     }
   else
     {
@@ -245,7 +245,11 @@ int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   /* Check for read data availability now */
 
-  if (iob_peek_queue(&conn->readahead) != NULL)
+  if (iob_peek_queue(&conn->readahead) != NULL
+#ifdef CONFIG_NET_PKT_RING
+      || pkt_ring_ready(conn)
+#endif
+     )
     {
       /* Normal data may be read without blocking. */
 
@@ -0,0 +1,639 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#if defined(CONFIG_NET_PKT) && defined(CONFIG_NET_PKT_RING)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Block retire timeout if the application did not ask for one */
+
+#define PKT_RING_DEFAULT_TOV   8
+
+/* Offset of the frame data from the start of a frame */
+
+#define PKT_RING_MACOFF        TPACKET_ALIGN(TPACKET3_HDRLEN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pkt_ring_s
+{
+  FAR struct pkt_conn_s *conn;    /* The owner of the ring */
+  FAR uint8_t *buffer;            /* The blocks, shared with the user */
+  size_t       size;              /* Size of the buffer */
+  uint32_t     block_size;        /* Size of a block */
+  uint32_t     block_nr;          /* Number of blocks */
+  uint32_t     frame_size;        /* Maximum size of a frame */
+  uint32_t     first_off;         /* Offset of the first frame of a block */
+  clock_t      tov;               /* Block retire timeout in ticks */
+  atomic_t     refs;              /* The socket plus one per mapping */
+
+  /* State of the block being filled */
+
+  uint32_t     cur;               /* Index of the current block */
+  uint32_t     off;               /* Offset of the next frame */
+  uint32_t     num_pkts;          /* Frames in the block, 0 = not opened */
+  uint32_t     last;              /* Offset of the last frame */
+  uint64_t     seq;               /* Sequence number of the current block */
+  uint64_t     tmo_seq;           /* The block the retire timer is for */
+  bool         losing;            /* Frames were dropped since last retire */
+  struct tpacket_bd_ts ts_first;  /* Time of the first frame */
+  struct tpacket_bd_ts ts_last;   /* Time of the last frame */
+
+  /* Statistics, PACKET_STATISTICS */
+
+  uint32_t     packets;
+  uint32_t     drops;
+
+  struct work_s work;             /* Block retire timer */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_block
+ ****************************************************************************/
+
+static inline FAR struct tpacket_block_desc *
+pkt_ring_block(FAR struct pkt_ring_s *ring, uint32_t index)
+{
+  return (FAR struct tpacket_block_desc *)
+         (ring->buffer + index * ring->block_size);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_release
+ *
+ * Description:
+ *   Drop a reference to the ring, the memory is freed with the last one.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_release(FAR struct pkt_ring_s *ring)
+{
+  if (atomic_fetch_sub(&ring->refs, 1) == 1)
+    {
+      kmm_free(ring->buffer);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_munmap
+ *
+ * Description:
+ *   Undo pkt_ring_mmap().  The ring outlives the socket while it is still
+ *   mapped, so the mapping drops its reference here.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  FAR struct pkt_ring_s *ring = entry->priv.p;
+  off_t offset;
+  int ret;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      nerr("ERROR: Cannot unmap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  if (offset > 0)
+    {
+      /* Only the tail is unmapped, the ring is still in use */
+
+      entry->length = offset;
+      return OK;
+    }
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  if (ret >= 0)
+    {
+      pkt_ring_release(ring);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_notify
+ *
+ * Description:
+ *   Wake up the threads polling the packet socket for input.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_notify(FAR struct pkt_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      if (conn->pollinfo[i].fds != NULL)
+        {
+          poll_notify(&conn->pollinfo[i].fds, 1, POLLIN);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the current block over to the application and move to the next
+ *   one.
+ *
+ * Assumptions:
+ *   The connection is locked and the current block holds frames.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_ring_s *ring, uint32_t status)
+{
+  FAR struct tpacket_block_desc *desc = pkt_ring_block(ring, ring->cur);
+  FAR struct tpacket_hdr_v1 *bh1 = &desc->hdr.bh1;
+
+  desc->version        = TPACKET_V3;
+  desc->offset_to_priv = TPACKET_ALIGN(sizeof(struct tpacket_block_desc));
+
+  bh1->num_pkts            = ring->num_pkts;
+  bh1->offset_to_first_pkt = ring->first_off;
+  bh1->blk_len             = ring->off;
+  bh1->seq_num             = ring->seq++;
+  bh1->ts_first_pkt        = ring->ts_first;
+  bh1->ts_last_pkt         = ring->ts_last;
+
+  if (ring->losing)
+    {
+      status |= TP_STATUS_LOSING;
+      ring->losing = false;
+    }
+
+  /* The block must be complete before the application can see it */
+
+  SMP_WMB();
+  bh1->block_status = TP_STATUS_USER | status;
+
+  ring->num_pkts = 0;
+  ring->cur      = (ring->cur + 1) % ring->block_nr;
+
+  pkt_ring_notify(ring->conn);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire the current block if it was not filled within the timeout, so
+ *   that the application sees slow traffic without waiting for a full
+ *   block.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_ring_s *ring = arg;
+  FAR struct pkt_conn_s *conn = ring->conn;
+
+  conn_lock(&conn->sconn);
+
+  /* The ring may be being released, pkt_ring_free() waits for us */
+
+  if (conn->ring == ring && ring->num_pkts > 0 &&
+      ring->seq == ring->tmo_seq)
+    {
+      pkt_ring_retire(ring, TP_STATUS_BLK_TMO);
+    }
+
+  conn_unlock(&conn->sconn);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start filling the current block if the application gave it back.
+ *
+ * Returned Value:
+ *   true if the block can be used, false if the ring is full.
+ *
+ ****************************************************************************/
+
+static bool pkt_ring_open(FAR struct pkt_ring_s *ring)
+{
+  FAR struct tpacket_block_desc *desc = pkt_ring_block(ring, ring->cur);
+  FAR volatile uint32_t *status = &desc->hdr.bh1.block_status;
+
+  if (*status != TP_STATUS_KERNEL)
+    {
+      return false;
+    }
+
+  ring->off  = ring->first_off;
+  ring->last = 0;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up the receive ring of a packet socket (PACKET_RX_RING).  A request
+ *   with tp_block_nr 0 releases the ring, unless it is still mapped.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   req  - The ring geometry
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_ring_s *ring;
+  uint32_t first_off;
+
+  if (req->tp_block_nr == 0)
+    {
+      conn_lock(&conn->sconn);
+      ring = conn->ring;
+      if (ring != NULL && atomic_read(&ring->refs) > 1)
+        {
+          /* As Linux, refuse to pull the ring from under a mapping */
+
+          conn_unlock(&conn->sconn);
+          return -EBUSY;
+        }
+
+      conn_unlock(&conn->sconn);
+      pkt_ring_free(conn);
+      return OK;
+    }
+
+  if (conn->version != TPACKET_V3)
+    {
+      return -EINVAL;
+    }
+
+  first_off = TPACKET_ALIGN(sizeof(struct tpacket_block_desc)) +
+              TPACKET_ALIGN(req->tp_sizeof_priv);
+
+  if (req->tp_block_size == 0 ||
+      req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size <= PKT_RING_MACOFF ||
+      req->tp_sizeof_priv > req->tp_block_size ||
+      first_off + req->tp_frame_size > req->tp_block_size ||
+      req->tp_block_nr > SIZE_MAX / req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  ring = kmm_zalloc(sizeof(struct pkt_ring_s));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->size   = (size_t)req->tp_block_size * req->tp_block_nr;
+  ring->buffer = kmm_zalloc(ring->size);
+  if (ring->buffer == NULL)
+    {
+      kmm_free(ring);
+      return -ENOMEM;
+    }
+
+  atomic_set(&ring->refs, 1);
+  ring->conn       = conn;
+  ring->block_size = req->tp_block_size;
+  ring->block_nr   = req->tp_block_nr;
+  ring->frame_size = req->tp_frame_size;
+  ring->first_off  = first_off;
+  ring->tov        = MSEC2TICK(req->tp_retire_blk_tov != 0 ?
+                               req->tp_retire_blk_tov :
+                               PKT_RING_DEFAULT_TOV);
+  if (ring->tov == 0)
+    {
+      ring->tov = 1;
+    }
+
+  conn_lock(&conn->sconn);
+  if (conn->ring != NULL)
+    {
+      conn_unlock(&conn->sconn);
+      kmm_free(ring->buffer);
+      kmm_free(ring);
+      return -EBUSY;
+    }
+
+  conn->ring = ring;
+  conn_unlock(&conn->sconn);
+
+  ninfo("Ring of %" PRIu32 " blocks of %" PRIu32 " bytes\n",
+        ring->block_nr, ring->block_size);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Detach the receive ring from a packet socket, if any.  The memory is
+ *   only freed once the ring is no longer mapped.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring;
+
+  conn_lock(&conn->sconn);
+  ring = conn->ring;
+  conn->ring = NULL;
+  conn_unlock(&conn->sconn);
+
+  if (ring != NULL)
+    {
+      /* The timer takes the connection lock, so cancel it unlocked */
+
+      work_cancel_sync(LPWORK, &ring->work);
+      pkt_ring_release(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Write the received frame to the receive ring.  The frames are batched
+ *   in blocks, a block is handed to the application when it is full or
+ *   when the retire timeout expires.  The frame is dropped if no block is
+ *   free.
+ *
+ * Input Parameters:
+ *   dev     - The device with the frame, d_len bytes including the link
+ *             layer header
+ *   conn    - The packet socket connection
+ *   snaplen - The number of bytes to keep, from the filter
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, uint32_t snaplen)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  FAR uint8_t *block;
+  struct timespec ts;
+  uint32_t need;
+
+  ring->packets++;
+
+  if (snaplen > dev->d_len)
+    {
+      snaplen = dev->d_len;
+    }
+
+  if (snaplen > ring->frame_size - PKT_RING_MACOFF)
+    {
+      snaplen = ring->frame_size - PKT_RING_MACOFF;
+    }
+
+  need = TPACKET_ALIGN(PKT_RING_MACOFF + snaplen);
+
+  /* Retire the current block if the frame doesn't fit anymore */
+
+  if (ring->num_pkts > 0 && ring->off + need > ring->block_size)
+    {
+      pkt_ring_retire(ring, 0);
+    }
+
+  if (ring->num_pkts == 0 && !pkt_ring_open(ring))
+    {
+      ring->drops++;
+      ring->losing = true;
+      return;
+    }
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  block = (FAR uint8_t *)pkt_ring_block(ring, ring->cur);
+  hdr   = (FAR struct tpacket3_hdr *)(block + ring->off);
+  sll   = (FAR struct sockaddr_ll *)
+          ((FAR uint8_t *)hdr + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+
+  memset(hdr, 0, PKT_RING_MACOFF);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = TP_STATUS_USER;
+  hdr->tp_mac     = PKT_RING_MACOFF;
+  hdr->tp_net     = PKT_RING_MACOFF + NET_LL_HDRLEN(dev);
+
+  sll->sll_family   = AF_PACKET;
+  sll->sll_protocol = conn->type;
+  sll->sll_ifindex  = dev->d_ifindex;
+  sll->sll_hatype   = dev->d_lltype;
+
+  iob_copyout((FAR uint8_t *)hdr + PKT_RING_MACOFF, dev->d_iob, snaplen,
+              -NET_LL_HDRLEN(dev));
+
+  /* Chain the frame to the previous one of the block */
+
+  if (ring->num_pkts > 0)
+    {
+      FAR struct tpacket3_hdr *prev =
+        (FAR struct tpacket3_hdr *)(block + ring->last);
+
+      prev->tp_next_offset = ring->off - ring->last;
+    }
+  else
+    {
+      ring->ts_first.ts_sec  = ts.tv_sec;
+      ring->ts_first.ts_nsec = ts.tv_nsec;
+
+      /* Retire the block after the timeout even if it is not full */
+
+      ring->tmo_seq = ring->seq;
+      work_queue(LPWORK, &ring->work, pkt_ring_timeout, ring, ring->tov);
+    }
+
+  ring->ts_last.ts_sec  = ts.tv_sec;
+  ring->ts_last.ts_nsec = ts.tv_nsec;
+  ring->last = ring->off;
+  ring->off += need;
+  ring->num_pkts++;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_ready
+ *
+ * Description:
+ *   Return true if the last retired block is owned by the application,
+ *   i.e. poll() should report input.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_ready(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+  uint32_t prev;
+
+  if (ring == NULL)
+    {
+      return false;
+    }
+
+  prev = (ring->cur + ring->block_nr - 1) % ring->block_nr;
+  return (pkt_ring_block(ring, prev)->hdr.bh1.block_status &
+          TP_STATUS_USER) != 0;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the receive ring into the caller, the si_mmap method of packet
+ *   sockets.  The flat build shares the address space, so this just
+ *   returns the address of the ring.  Each mapping holds a reference on
+ *   the ring that is dropped by munmap().
+ *
+ * Input Parameters:
+ *   psock - The packet socket
+ *   map   - The mapping request
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_ring_s *ring;
+  int ret = -EINVAL;
+
+  conn_lock(&conn->sconn);
+  ring = conn->ring;
+  if (ring == NULL)
+    {
+      ret = -ENODEV;
+    }
+  else if (map->offset >= 0 && map->length > 0 &&
+           map->offset < ring->size &&
+           map->length <= ring->size - map->offset)
+    {
+      map->vaddr  = ring->buffer + map->offset;
+      map->priv.p = ring;
+      map->munmap = pkt_ring_munmap;
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret >= 0)
+        {
+          atomic_fetch_add(&ring->refs, 1);
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_stats
+ *
+ * Description:
+ *   Return and reset the statistics of the receive ring
+ *   (PACKET_STATISTICS).
+ *
+ ****************************************************************************/
+
+void pkt_ring_stats(FAR struct pkt_conn_s *conn,
+                    FAR struct tpacket_stats_v3 *stats)
+{
+  FAR struct pkt_ring_s *ring;
+
+  memset(stats, 0, sizeof(*stats));
+
+  conn_lock(&conn->sconn);
+  ring = conn->ring;
+  if (ring != NULL)
+    {
+      stats->tp_packets = ring->packets;
+      stats->tp_drops   = ring->drops;
+      ring->packets     = 0;
+      ring->drops       = 0;
+    }
+
+  conn_unlock(&conn->sconn);
+}
+
+#endif /* CONFIG_NET_PKT && CONFIG_NET_PKT_RING */
@@ -32,6 +32,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <net/bpf.h>
 #include <netpacket/packet.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/pkt.h>
@@ -79,6 +80,28 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
   DEBUGASSERT(value_len == 0 || value != NULL);
 
+#ifdef CONFIG_NET_PKT_FILTER
+  /* Socket filters are socket level options handled by the packet socket */
+
+  if (level == SOL_SOCKET)
+    {
+      if (option == SO_ATTACH_FILTER)
+        {
+          if (value == NULL || value_len < sizeof(struct sock_fprog))
+            {
+              return -EINVAL;
+            }
+
+          return pkt_filter_attach(psock->s_conn, value);
+        }
+      else if (option == SO_DETACH_FILTER)
+        {
+          pkt_filter_detach(psock->s_conn);
+          return OK;
+        }
+    }
+#endif
+
   if (level != SOL_PACKET)
     {
       return -ENOPROTOOPT;
@@ -172,6 +195,42 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_PKT_RING
+      case PACKET_VERSION:
+        {
+          FAR struct pkt_conn_s *conn = psock->s_conn;
+
+          if (value == NULL || value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* Only the block based TPACKET_V3 ring is supported */
+
+          if (*(FAR const int *)value != TPACKET_V3)
+            {
+              return -EINVAL;
+            }
+
+          if (conn->ring != NULL)
+            {
+              return -EBUSY;
+            }
+
+          conn->version = TPACKET_V3;
+        }
+        break;
+
+      case PACKET_RX_RING:
+        if (value == NULL || value_len < sizeof(struct tpacket_req3))
+          {
+            return -EINVAL;
+          }
+
+        ret = pkt_ring_setup(psock->s_conn, value);
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized PKT option: %d\n", option);
         ret = -ENOPROTOOPT;
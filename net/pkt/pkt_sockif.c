@@ -87,6 +87,13 @@ const struct sock_intf_s g_pkt_sockif =
   , pkt_getsockopt /* si_getsockopt */
   , pkt_setsockopt /* si_setsockopt */
 #endif
+#ifdef CONFIG_NET_PKT_RING
+#  ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#  endif
+  , NULL           /* si_recvmmsg */
+  , pkt_ring_mmap  /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -68,6 +68,12 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_ARP
+static int netprocfs_arp_cache(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_ARP */
+#ifdef CONFIG_NET_IPv6
+static int netprocfs_nd_cache(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPv6 */
 
 /****************************************************************************
  * Private Data
@@ -102,6 +108,14 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_ARP
+  , netprocfs_arp_cache
+#endif /* CONFIG_NET_ARP */
+
+#ifdef CONFIG_NET_IPv6
+  , netprocfs_nd_cache
+#endif /* CONFIG_NET_IPv6 */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -449,6 +463,36 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_arp_cache
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_ARP)
+static int netprocfs_arp_cache(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "ARP      Lookup: %04x Probe: %04x Miss: %04x "
+                  "Evict: %04x\n",
+                  g_netstats.arp.lookup, g_netstats.arp.probe,
+                  g_netstats.arp.miss, g_netstats.arp.evict);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_ARP */
+
+/****************************************************************************
+ * Name: netprocfs_nd_cache
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPv6)
+static int netprocfs_nd_cache(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Neighbor Lookup: %04x Probe: %04x Miss: %04x "
+                  "Evict: %04x\n",
+                  g_netstats.nd.lookup, g_netstats.nd.probe,
+                  g_netstats.nd.miss, g_netstats.nd.evict);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
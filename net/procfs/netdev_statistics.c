@@ -56,6 +56,25 @@
 #  define NETSTAT_IPv6_IDX 1
 #endif
 
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+#  ifdef CONFIG_NET_IPv6
+#    if defined(CONFIG_NETDEV_MULTIPLE_IPv6) && \
+        defined(CONFIG_DESIGNATED_INITIALIZERS)
+#      define NETSTAT_IPv6_LINES (CONFIG_NETDEV_MAX_IPv6_ADDR + 1)
+#    else
+#      define NETSTAT_IPv6_LINES 2
+#    endif
+#  elif !defined(CONFIG_NET_IPv4)
+#    define NETSTAT_IPv6_LINES 1 /* Blank line */
+#  else
+#    define NETSTAT_IPv6_LINES 0
+#  endif
+
+/* The per queue lines follow the RX/TX statistics and the queue header */
+
+#  define NETSTAT_QUEUE_IDX (NETSTAT_IPv6_IDX + NETSTAT_IPv6_LINES + 7)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -80,6 +99,10 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netprocfs_queue_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_queue(FAR struct netprocfs_file_s *netfile);
+#endif
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -116,6 +139,15 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#  ifdef CONFIG_NETDEV_MULTIQUEUE
+  netprocfs_queue_header,
+#    ifdef CONFIG_DESIGNATED_INITIALIZERS
+  [NETSTAT_QUEUE_IDX ... NETSTAT_QUEUE_IDX + CONFIG_NETDEV_MAX_QUEUES - 1]
+  = netprocfs_queue,
+#    else
+  netprocfs_queue,
+#    endif
+#  endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -558,6 +590,48 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_queue_header
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+static int netprocfs_queue_header(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+  return snprintf(netfile->line, NET_LINELEN, "\tQUEUE: %-8s %-8s\n",
+                  "RX", "TX");
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_queue
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+static int netprocfs_queue(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+  int idx = netfile->lineno - NETSTAT_QUEUE_IDX;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  /* Skip the queues the device does not use */
+
+  if (idx > 0 && stats->rxq_packets[idx] == 0 &&
+      stats->txq_packets[idx] == 0)
+    {
+      return 0;
+    }
+
+  return snprintf(netfile->line, NET_LINELEN, "\t%5d  %08lx %08lx\n",
+                  idx, (unsigned long)stats->rxq_packets[idx],
+                  (unsigned long)stats->txq_packets[idx]);
+}
+#endif
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
@@ -84,6 +84,18 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lockroute_ipv4();
 
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+  /* Index the new entry in the prefix trie */
+
+  if (net_trieroute_add_ipv4((FAR struct net_route_ipv4_entry_s *)route) < 0)
+    {
+      net_unlockroute_ipv4();
+      net_freeroute_ipv4(route);
+      nerr("ERROR:  Failed to allocate a trie node\n");
+      return -ENOMEM;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
@@ -121,6 +133,18 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lockroute_ipv6();
 
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+  /* Index the new entry in the prefix trie */
+
+  if (net_trieroute_add_ipv6((FAR struct net_route_ipv6_entry_s *)route) < 0)
+    {
+      net_unlockroute_ipv6();
+      net_freeroute_ipv6(route);
+      nerr("ERROR:  Failed to allocate a trie node\n");
+      return -ENOMEM;
+    }
+#endif
+
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
   net_unlockroute_ipv6();
@@ -0,0 +1,646 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/net/net.h>
+
+#include "utils/utils.h"
+#include "route/ramroute.h"
+#include "route/route.h"
+
+#if defined(CONFIG_ROUTE_IPv4_TRIE) || defined(CONFIG_ROUTE_IPv6_TRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Nodes hold the prefix in network order, large enough for either family */
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+#  define TRIE_KEYSIZE 16
+#else
+#  define TRIE_KEYSIZE 4
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node of a path-compressed binary trie.  A node either holds the routes
+ * with exactly its prefix, or it is a branch node with two children where
+ * the prefixes below it first differ.  Nodes with one child and no route
+ * are removed, so there are less than two nodes per distinct prefix.
+ */
+
+struct route_trie_node_s
+{
+  FAR struct route_trie_node_s *tn_parent;
+  FAR struct route_trie_node_s *tn_child[2];
+  FAR void *tn_routes;          /* Routes with this prefix, NULL if none */
+  uint8_t tn_key[TRIE_KEYSIZE]; /* The prefix, bits beyond tn_plen clear */
+  uint8_t tn_plen;              /* The prefix length in bits */
+};
+
+struct route_trie_s
+{
+  FAR struct route_trie_node_s *root;
+  FAR struct net_bufpool_s *pool; /* Pool of the nodes */
+  uint8_t keybits;                /* Address length in bits */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+NET_BUFPOOL_DECLARE(g_ipv4trie_nodes, sizeof(struct route_trie_node_s),
+                    2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES, 0, 0);
+
+static struct route_trie_s g_ipv4_trie =
+{
+  NULL, &g_ipv4trie_nodes, 32
+};
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+NET_BUFPOOL_DECLARE(g_ipv6trie_nodes, sizeof(struct route_trie_node_s),
+                    2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES, 0, 0);
+
+static struct route_trie_s g_ipv6_trie =
+{
+  NULL, &g_ipv6trie_nodes, 128
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return bit n of the key, counting from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits two keys have in common, at most
+ *   maxbits.
+ *
+ ****************************************************************************/
+
+static int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                       int maxbits)
+{
+  uint8_t diff;
+  int n;
+
+  for (n = 0; n < maxbits; n += 8)
+    {
+      diff = a[n >> 3] ^ b[n >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              n++;
+            }
+
+          break;
+        }
+    }
+
+  return MIN(n, maxbits);
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Allocate a node for the first plen bits of key.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *
+trie_alloc(FAR struct route_trie_s *trie, FAR const uint8_t *key,
+           int plen, FAR struct route_trie_node_s *parent)
+{
+  FAR struct route_trie_node_s *node;
+  int nbytes = (plen + 7) >> 3;
+
+  node = net_bufpool_timedalloc(trie->pool, 0);
+  if (node != NULL)
+    {
+      memset(node, 0, sizeof(*node));
+      memcpy(node->tn_key, key, nbytes);
+      if ((plen & 7) != 0)
+        {
+          node->tn_key[nbytes - 1] &= 0xff << (8 - (plen & 7));
+        }
+
+      node->tn_plen   = plen;
+      node->tn_parent = parent;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_link
+ *
+ * Description:
+ *   Return the pointer that links the node into the trie.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s **
+trie_link(FAR struct route_trie_s *trie, FAR struct route_trie_node_s *node)
+{
+  FAR struct route_trie_node_s *parent = node->tn_parent;
+
+  if (parent == NULL)
+    {
+      return &trie->root;
+    }
+
+  return &parent->tn_child[trie_bit(node->tn_key, parent->tn_plen)];
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Return the node of the prefix, creating it if necessary.  NULL is
+ *   returned if no node could be allocated.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *
+trie_insert(FAR struct route_trie_s *trie, FAR const uint8_t *key,
+            int plen)
+{
+  FAR struct route_trie_node_s **link = &trie->root;
+  FAR struct route_trie_node_s *parent = NULL;
+  FAR struct route_trie_node_s *branch;
+  FAR struct route_trie_node_s *node;
+  FAR struct route_trie_node_s *leaf;
+  int common = 0;
+
+  /* Walk down while the node prefixes cover the new one */
+
+  while ((node = *link) != NULL)
+    {
+      common = trie_common(node->tn_key, key, MIN(node->tn_plen, plen));
+      if (common < node->tn_plen)
+        {
+          break;
+        }
+
+      if (node->tn_plen == plen)
+        {
+          return node;
+        }
+
+      parent = node;
+      link   = &node->tn_child[trie_bit(key, node->tn_plen)];
+    }
+
+  leaf = trie_alloc(trie, key, plen, parent);
+  if (leaf == NULL)
+    {
+      return NULL;
+    }
+
+  if (node == NULL)
+    {
+      /* Empty slot, just hang the new node there */
+
+      *link = leaf;
+    }
+  else if (common == plen)
+    {
+      /* The new prefix covers the node, put it above the node */
+
+      leaf->tn_child[trie_bit(node->tn_key, plen)] = node;
+      node->tn_parent = leaf;
+      *link = leaf;
+    }
+  else
+    {
+      /* The prefixes differ at bit 'common', add a branch node there */
+
+      branch = trie_alloc(trie, key, common, parent);
+      if (branch == NULL)
+        {
+          net_bufpool_free(trie->pool, leaf);
+          return NULL;
+        }
+
+      branch->tn_child[trie_bit(key, common)] = leaf;
+      branch->tn_child[trie_bit(node->tn_key, common)] = node;
+      leaf->tn_parent = branch;
+      node->tn_parent = branch;
+      *link = branch;
+    }
+
+  return leaf;
+}
+
+/****************************************************************************
+ * Name: trie_find
+ *
+ * Description:
+ *   Return the node of exactly this prefix, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *
+trie_find(FAR struct route_trie_s *trie, FAR const uint8_t *key, int plen)
+{
+  FAR struct route_trie_node_s *node = trie->root;
+
+  while (node != NULL && node->tn_plen <= plen)
+    {
+      if (trie_common(node->tn_key, key, node->tn_plen) < node->tn_plen)
+        {
+          break;
+        }
+
+      if (node->tn_plen == plen)
+        {
+          return node;
+        }
+
+      node = node->tn_child[trie_bit(key, node->tn_plen)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: trie_prune
+ *
+ * Description:
+ *   Remove a node that has no more routes, and the branch node above it if
+ *   that is left with a single child.
+ *
+ ****************************************************************************/
+
+static void trie_prune(FAR struct route_trie_s *trie,
+                       FAR struct route_trie_node_s *node)
+{
+  FAR struct route_trie_node_s *parent;
+  FAR struct route_trie_node_s *child;
+
+  while (node != NULL && node->tn_routes == NULL &&
+         (node->tn_child[0] == NULL || node->tn_child[1] == NULL))
+    {
+      parent = node->tn_parent;
+      child  = node->tn_child[0] != NULL ? node->tn_child[0] :
+                                           node->tn_child[1];
+
+      *trie_link(trie, node) = child;
+      net_bufpool_free(trie->pool, node);
+
+      if (child != NULL)
+        {
+          /* The parent still has the same number of children */
+
+          child->tn_parent = parent;
+          break;
+        }
+
+      node = parent;
+    }
+}
+
+/****************************************************************************
+ * Name: trie_next
+ *
+ * Description:
+ *   Return the next node with routes on the path to key, starting below
+ *   node (or at the root if node is NULL).
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *
+trie_next(FAR struct route_trie_s *trie, FAR struct route_trie_node_s *node,
+          FAR const uint8_t *key)
+{
+  if (node == NULL)
+    {
+      node = trie->root;
+    }
+  else if (node->tn_plen < trie->keybits)
+    {
+      node = node->tn_child[trie_bit(key, node->tn_plen)];
+    }
+  else
+    {
+      return NULL;
+    }
+
+  while (node != NULL)
+    {
+      if (trie_common(node->tn_key, key, node->tn_plen) < node->tn_plen)
+        {
+          /* The key leaves the prefix of this subtree */
+
+          return NULL;
+        }
+
+      if (node->tn_routes != NULL)
+        {
+          return node;
+        }
+
+      if (node->tn_plen >= trie->keybits)
+        {
+          return NULL;
+        }
+
+      node = node->tn_child[trie_bit(key, node->tn_plen)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_trieroute_add_ipv4 and net_trieroute_add_ipv6
+ *
+ * Description:
+ *   Add a route to the prefix trie.  Routes with the same prefix are kept
+ *   in the order they were added.
+ *
+ * Input Parameters:
+ *   route - The routing table entry to add
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if no trie node is available.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_trieroute_add_ipv4(FAR struct net_route_ipv4_entry_s *route)
+{
+  FAR struct route_trie_node_s *node;
+  FAR struct net_route_ipv4_entry_s *last;
+
+  node = trie_insert(&g_ipv4_trie, (FAR const uint8_t *)&route->entry.target,
+                     net_ipv4_mask2pref(route->entry.netmask));
+  if (node == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  route->tlink = NULL;
+  if (node->tn_routes == NULL)
+    {
+      node->tn_routes = route;
+    }
+  else
+    {
+      last = node->tn_routes;
+      while (last->tlink != NULL)
+        {
+          last = last->tlink;
+        }
+
+      last->tlink = route;
+    }
+
+  return OK;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_trieroute_add_ipv6(FAR struct net_route_ipv6_entry_s *route)
+{
+  FAR struct route_trie_node_s *node;
+  FAR struct net_route_ipv6_entry_s *last;
+
+  node = trie_insert(&g_ipv6_trie, (FAR const uint8_t *)route->entry.target,
+                     net_ipv6_mask2pref(route->entry.netmask));
+  if (node == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  route->tlink = NULL;
+  if (node->tn_routes == NULL)
+    {
+      node->tn_routes = route;
+    }
+  else
+    {
+      last = node->tn_routes;
+      while (last->tlink != NULL)
+        {
+          last = last->tlink;
+        }
+
+      last->tlink = route;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_del_ipv4 and net_trieroute_del_ipv6
+ *
+ * Description:
+ *   Remove a route from the prefix trie.
+ *
+ * Input Parameters:
+ *   route - The routing table entry to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+void net_trieroute_del_ipv4(FAR struct net_route_ipv4_entry_s *route)
+{
+  FAR struct route_trie_node_s *node;
+  FAR struct net_route_ipv4_entry_s *prev;
+
+  node = trie_find(&g_ipv4_trie, (FAR const uint8_t *)&route->entry.target,
+                   net_ipv4_mask2pref(route->entry.netmask));
+  DEBUGASSERT(node != NULL);
+
+  if (node->tn_routes == route)
+    {
+      node->tn_routes = route->tlink;
+    }
+  else
+    {
+      prev = node->tn_routes;
+      while (prev->tlink != route)
+        {
+          DEBUGASSERT(prev->tlink != NULL);
+          prev = prev->tlink;
+        }
+
+      prev->tlink = route->tlink;
+    }
+
+  if (node->tn_routes == NULL)
+    {
+      trie_prune(&g_ipv4_trie, node);
+    }
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+void net_trieroute_del_ipv6(FAR struct net_route_ipv6_entry_s *route)
+{
+  FAR struct route_trie_node_s *node;
+  FAR struct net_route_ipv6_entry_s *prev;
+
+  node = trie_find(&g_ipv6_trie, (FAR const uint8_t *)route->entry.target,
+                   net_ipv6_mask2pref(route->entry.netmask));
+  DEBUGASSERT(node != NULL);
+
+  if (node->tn_routes == route)
+    {
+      node->tn_routes = route->tlink;
+    }
+  else
+    {
+      prev = node->tn_routes;
+      while (prev->tlink != route)
+        {
+          DEBUGASSERT(prev->tlink != NULL);
+          prev = prev->tlink;
+        }
+
+      prev->tlink = route->tlink;
+    }
+
+  if (node->tn_routes == NULL)
+    {
+      trie_prune(&g_ipv6_trie, node);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: net_foreachmatch_ipv4 and net_foreachmatch_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers the target address, in the
+ *   order of increasing prefix length.
+ *
+ * Input Parameters:
+ *   target  - The address to be routed
+ *   handler - Will be called for each matching route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the search early with any non-zero, non-negative value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_foreachmatch_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                          FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)&target;
+  FAR struct route_trie_node_s *node = NULL;
+  FAR struct net_route_ipv4_entry_s *route;
+  int ret = 0;
+
+  net_lockroute_ipv4();
+
+  while (ret == 0 && (node = trie_next(&g_ipv4_trie, node, key)) != NULL)
+    {
+      for (route = node->tn_routes; ret == 0 && route != NULL;
+           route = route->tlink)
+        {
+          ret = handler(&route->entry, arg);
+        }
+    }
+
+  net_unlockroute_ipv4();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_foreachmatch_ipv6(const net_ipv6addr_t target,
+                          route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)target;
+  FAR struct route_trie_node_s *node = NULL;
+  FAR struct net_route_ipv6_entry_s *route;
+  int ret = 0;
+
+  net_lockroute_ipv6();
+
+  while (ret == 0 && (node = trie_next(&g_ipv6_trie, node, key)) != NULL)
+    {
+      for (route = node->tn_routes; ret == 0 && route != NULL;
+           route = route->tlink)
+        {
+          ret = handler(&route->entry, arg);
+        }
+    }
+
+  net_unlockroute_ipv6();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_TRIE || CONFIG_ROUTE_IPv6_TRIE */
@@ -68,6 +68,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+  FAR struct net_route_ipv4_entry_s *tlink; /* Next route with same prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -86,6 +89,9 @@ struct net_route_ipv6_entry_s
 {
   struct net_route_ipv6_s entry;
   FAR struct net_route_ipv6_entry_s *flink;
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+  FAR struct net_route_ipv6_entry_s *tlink; /* Next route with same prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -225,5 +231,87 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: net_trieroute_add_ipv4 and net_trieroute_add_ipv6
+ *
+ * Description:
+ *   Add a route to the prefix trie.  Routes with the same prefix are kept
+ *   in the order they were added.
+ *
+ * Input Parameters:
+ *   route - The routing table entry to add
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if no trie node is available.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_trieroute_add_ipv4(FAR struct net_route_ipv4_entry_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_trieroute_add_ipv6(FAR struct net_route_ipv6_entry_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_del_ipv4 and net_trieroute_del_ipv6
+ *
+ * Description:
+ *   Remove a route from the prefix trie.
+ *
+ * Input Parameters:
+ *   route - The routing table entry to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+void net_trieroute_del_ipv4(FAR struct net_route_ipv4_entry_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+void net_trieroute_del_ipv6(FAR struct net_route_ipv6_entry_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_foreachmatch_ipv4 and net_foreachmatch_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers the target address, in the
+ *   order of increasing prefix length.  This visits the same routes that
+ *   a net_foreachroute_ipv4/6() traversal would match, without visiting
+ *   the rest of the routing table.
+ *
+ * Input Parameters:
+ *   target  - The address to be routed
+ *   handler - Will be called for each matching route.  It must not modify
+ *             the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the search early with any non-zero, non-negative value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_foreachmatch_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                          FAR void *arg);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_foreachmatch_ipv6(const net_ipv6addr_t target,
+                          route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
@@ -0,0 +1,207 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages with a single call.  It
+ *   is the internal OS interface equivalent of recvmmsg(), see
+ *   psock_recvmsg() for the differences.
+ *
+ *   If the address family provides si_recvmmsg(), it is given the remaining
+ *   part of the vector so that it can collect everything that is already
+ *   queued at once; otherwise the messages are received one by one.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of buffers to receive the messages
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags
+ *   timeout   Time limit for the whole operation (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received; the msg_len member
+ *   of each of them holds the number of bytes received.  An error is
+ *   returned only if no message was received; then a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  unsigned int count = 0;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  ssize_t ret = 0;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (msgvec == NULL || vlen == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_nsec < 0 || timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      start = clock_systime_ticks();
+      ticks = clock_time2ticks(timeout);
+    }
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  while (count < vlen)
+    {
+      if (psock->s_sockif->si_recvmmsg != NULL)
+        {
+          ret = psock->s_sockif->si_recvmmsg(psock, &msgvec[count],
+                                             vlen - count,
+                                             flags & ~MSG_WAITFORONE);
+        }
+      else
+        {
+          ret = psock_recvmsg(psock, &msgvec[count].msg_hdr,
+                              flags & ~MSG_WAITFORONE);
+          if (ret >= 0)
+            {
+              msgvec[count].msg_len = ret;
+              ret = 1;
+            }
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      count += ret;
+
+      /* MSG_WAITFORONE turns on MSG_DONTWAIT after the first message */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      /* The timeout is only checked after each receive, as on Linux */
+
+      if (timeout != NULL && clock_systime_ticks() - start >= ticks)
+        {
+          break;
+        }
+    }
+
+  return count > 0 ? count : ret;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives multiple messages from a socket with a single call.
+ *   It is equivalent to a loop of recvmsg() calls, but the socket is looked
+ *   up only once and protocols may receive all queued messages at once.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Vector of buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags; MSG_WAITFORONE turns on MSG_DONTWAIT after
+ *            the first message has been received
+ *   timeout  Time limit for the whole operation, checked after each
+ *            message (may be NULL).  It is not updated.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned, and errno is set appropriately (see recvmsg()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      file_put(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
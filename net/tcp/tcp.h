@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -76,11 +77,29 @@
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
      (iob_copyin((wrb)->wb_iob,src,(n),(off),true))
-#  define TCP_WBTRYCOPYIN(wrb,src,n,off) \
-     (iob_trycopyin((wrb)->wb_iob,src,(n),(off),true))
 
-#  define TCP_WBTRIM(wrb,n) \
-     do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
+/* The payload is summed while it is copied into the write buffer, so that
+ * tcp_send() only has to sum the headers when a write buffer is sent as a
+ * whole.  Trimming the buffer invalidates the sum.
+ */
+
+#  if defined(CONFIG_NET_TCP_CHECKSUMS) && !defined(CONFIG_NET_ARCH_CHKSUM)
+#    define TCP_WB_CHKSUM 1
+#    define TCP_WBTRYCOPYIN(wrb,src,n,off) \
+       tcp_wrbuffer_trycopyin(wrb,src,(n),(off))
+#    define TCP_WBTRIM(wrb,n) \
+       do \
+         { \
+           (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); \
+           (wrb)->wb_chksumlen = 0; \
+         } \
+       while (0)
+#  else
+#    define TCP_WBTRYCOPYIN(wrb,src,n,off) \
+       (iob_trycopyin((wrb)->wb_iob,src,(n),(off),true))
+#    define TCP_WBTRIM(wrb,n) \
+       do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
+#  endif
 
 #ifdef CONFIG_DEBUG_FEATURES
 #  define TCP_WBDUMP(msg,wrb,len,offset) \
@@ -105,6 +124,7 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TSTAMP            0x20U /* Timestamps option enabled */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -114,6 +134,19 @@
 
 #endif
 
+/* The size of the options carried in every segment of a connection */
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+#  define tcp_optsize(conn) \
+     (((conn)->flags & TCP_TSTAMP) != 0 ? TCP_OPT_TS_ALIGNED_LEN : 0)
+#else
+#  define tcp_optsize(conn) 0
+#endif
+
+/* PAWS: ts_recent is invalid after 24 days idle (RFC 7323 section 5.5) */
+
+#define TCP_PAWS_IDLE         (24 * SEC_PER_DAY)
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -149,6 +182,7 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_zcrecv_s;      /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -176,6 +210,44 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  The common code in tcp_cc.c handles
+ * slow start, duplicate ACKs and fast recovery; the algorithm decides how
+ * the window grows in congestion avoidance and how far it is reduced on
+ * loss.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+
+  /* Initialize the private state of the algorithm (optional) */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Return the new ssthresh after a loss (fast retransmit or RTO) */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd in congestion avoidance after 'acked' bytes were ACKed */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of the CUBIC algorithm (RFC 8312) */
+
+struct tcp_cubic_s
+{
+  clock_t  epoch;         /* Start of the current epoch, 0 if none */
+  uint32_t w_max;         /* cwnd before the last reduction */
+  uint32_t origin;        /* cwnd at the plateau of the cubic function */
+  uint32_t k;             /* Time to reach the origin, in ms */
+  uint32_t w_est;         /* The estimated Reno cwnd */
+};
+#endif
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -208,6 +280,9 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hash_node_t hnode;      /* Node in the active or listener hashtable */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -251,6 +326,12 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* The congestion control
+                                          * algorithm */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic; /* CUBIC state */
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -263,6 +344,12 @@ struct tcp_conn_s
 #endif
   uint32_t snd_wl1;
   uint32_t snd_wl2;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t ts_recent;     /* The timestamp to echo to the peer */
+  uint32_t ts_recent_age; /* When ts_recent was updated (seconds) */
+  uint32_t srtt;          /* Smoothed RTT (ms, scaled by 8) */
+  uint32_t rttvar;        /* RTT variation (ms, scaled by 4) */
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcv_bufs;      /* Maximum amount of bytes queued in recv */
 #endif
@@ -297,6 +384,12 @@ struct tcp_conn_s
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+  /* Read-ahead data loaned by tcp_zcrecv() and not returned yet */
+
+  sq_queue_t zcloans;
+#endif
+
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
 
   /* Number of out-of-order segments */
@@ -325,6 +418,10 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef TCP_WB_CHKSUM
+  uint16_t   sndsum;      /* Raw checksum of the payload being sent */
+  uint16_t   sndsumlen;   /* Payload length it is for, 0: not known */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -414,6 +511,10 @@ struct tcp_wrbuffer_s
   uint8_t    wb_nack;      /* The number of ack count */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
+#ifdef TCP_WB_CHKSUM
+  uint16_t   wb_chksum;    /* Raw checksum of the first wb_chksumlen bytes */
+  uint16_t   wb_chksumlen; /* Number of bytes summed in wb_chksum */
+#endif
 };
 #endif
 
@@ -454,6 +555,13 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1050,6 +1158,36 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn);
 
 void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout);
 
+/****************************************************************************
+ * Name: tcp_update_rtt
+ *
+ * Description:
+ *   Feed an RTT sample to the SRTT/RTTVAR estimator of the connection and
+ *   update the retransmission time-out (RFC 6298).
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection of interest
+ *   rtt     - The measured round trip time in milliseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+void tcp_update_rtt(FAR struct tcp_conn_s *conn, uint32_t rtt);
+
+/****************************************************************************
+ * Name: tcp_ts_now
+ *
+ * Description:
+ *   Return the current value of the timestamp clock (1 ms per tick).
+ *
+ ****************************************************************************/
+
+#define tcp_ts_now() ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+#endif
+
 /****************************************************************************
  * Name: tcp_update_keeptimer
  *
@@ -1158,6 +1296,41 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno,
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_shared
+ *
+ * Description:
+ *   Return true if every listener on this address and port has set
+ *   SO_REUSEPORT.
+ *
+ * Assumptions:
+ *   Called with the TCP connection list locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+bool tcp_reuseport_shared(uint8_t domain, FAR const union ip_addr_u *ipaddr,
+                          uint16_t portno);
+#endif
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Pick the listener of a SO_REUSEPORT group that should own a new
+ *   connection, by a hash of the remote address and port.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct tcp_conn_s *
+tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                     FAR union ip_binding_u *uaddr, uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -1895,6 +2068,25 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(void);
 void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_trycopyin
+ *
+ * Description:
+ *   Copy user data into a write buffer at 'off' without waiting for I/O
+ *   buffers, like iob_trycopyin().  Data appended to the summed part of
+ *   the write buffer is summed as it is copied.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef TCP_WB_CHKSUM
+int tcp_wrbuffer_trycopyin(FAR struct tcp_wrbuffer_s *wrb,
+                           FAR const uint8_t *src, unsigned int len,
+                           unsigned int off);
+#endif
+
 /****************************************************************************
  * Name: tcp_wrbuffer_inqueue_size
  *
@@ -2221,6 +2413,62 @@ int tcp_txdrain(FAR struct socket *psock, unsigned int timeout);
 
 int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg);
 
+/****************************************************************************
+ * Name: tcp_zcrecv
+ *
+ * Description:
+ *   Loan the read-ahead data of a TCP connection to the caller instead of
+ *   copying it (SIOCZCRECV).  This never waits for data.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   zc   - The zero-copy receive request
+ *
+ * Returned Value:
+ *   OK on success, zc_len is 0 at the end of the stream.  A negated errno
+ *   value on failure (-EAGAIN if no data is available).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+int tcp_zcrecv(FAR struct tcp_conn_s *conn, FAR struct tcp_zcrecv_s *zc);
+#endif
+
+/****************************************************************************
+ * Name: tcp_zcrelease
+ *
+ * Description:
+ *   Return the data loaned by tcp_zcrecv() (SIOCZCRELEASE).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   handle - The zc_handle returned by tcp_zcrecv()
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+int tcp_zcrelease(FAR struct tcp_conn_s *conn, FAR void *handle);
+#endif
+
+/****************************************************************************
+ * Name: tcp_zcfree
+ *
+ * Description:
+ *   Free the data loaned by tcp_zcrecv() that was never returned, called
+ *   when the connection is freed.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+void tcp_zcfree(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_sendbuffer_notify
  *
@@ -2356,6 +2604,56 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   time-out.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_setops
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION socket option).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, not necessarily NUL terminated
+ *   len    - The length of the name
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_setops(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_getops
+ *
+ * Description:
+ *   Return the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_ops_s *tcp_cc_getops(FAR struct tcp_conn_s *conn);
 #endif
 
 #ifdef __cplusplus
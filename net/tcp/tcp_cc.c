@@ -24,7 +24,13 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
+#include <syslog.h>
 
 #include "tcp/tcp.h"
 
@@ -74,10 +80,119 @@
     } \
  } while(0)
 
+/* Trace the congestion state of a connection */
+
+#ifdef CONFIG_NET_TCP_CC_TRACE
+#  define tcp_cc_trace(conn, event) \
+     syslog(LOG_DEBUG, "tcp_cc %p %s %s: cwnd=%" PRIu32 " ssthresh=%" \
+            PRIu32 " unacked=%" PRIu32 " sa=%u\n", (conn), \
+            (conn)->cc_ops->name, (event), (conn)->cwnd, \
+            (conn)->ssthresh, (uint32_t)(conn)->tx_unacked, (conn)->sa)
+#else
+#  define tcp_cc_trace(conn, event)
+#endif
+
+/* The algorithm of the sockets that do not select one */
+
+#ifdef CONFIG_NET_TCP_CC_DEFAULT_CUBIC
+#  define TCP_CC_DEFAULT_OPS    (&g_tcp_cc_cubic)
+#else
+#  define TCP_CC_DEFAULT_OPS    (&g_tcp_cc_newreno)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",            /* name */
+  NULL,                 /* init */
+  newreno_ssthresh,     /* ssthresh */
+  newreno_cong_avoid    /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All of the available algorithms */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_ops[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd linearly by approximately maxseg per RTT using maxseg^2 / cwnd
+ *   per ACK as the increment (RFC 5681).  If cwnd > maxseg^2, fix the cwnd
+ *   increment at 1 byte to avoid capping cwnd.
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+  CC_CWND_INC(conn->cwnd, increase);
+  conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_find
+ *
+ * Description:
+ *   Find an algorithm by name.
+ *
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *tcp_cc_find(FAR const char *name,
+                                                  size_t len)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_ops); i++)
+    {
+      if (strncmp(g_tcp_cc_ops[i]->name, name, len) == 0 &&
+          g_tcp_cc_ops[i]->name[len] == '\0')
+        {
+          return g_tcp_cc_ops[i];
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +218,12 @@
 
 void tcp_cc_init(FAR struct tcp_conn_s *conn)
 {
+  conn->cc_ops = tcp_cc_getops(conn);
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
+
   CC_INIT_CWND(conn->cwnd, conn->mss);
 
   /* RFC 5681 recommends setting ssthresh arbitrarily high and
@@ -140,19 +261,20 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, let the algorithm reduce ssthresh (NewReno:
+   * the maximum of half the unacked and the 2*SMSS), and enter to Fast
+   * Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
       conn->flags |= TCP_INFR;
+      tcp_cc_trace(conn, "fastrexmit");
     }
 
   /* Update the cc parameters in the TCP_SYN_RCVD and TCP_SYN_SENT states
@@ -257,6 +379,7 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
               conn->flags &= ~TCP_INFR;
               conn->cwnd = conn->ssthresh;
+              tcp_cc_trace(conn, "recovered");
             }
           else
             {
@@ -284,19 +407,113 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+              /* cong avoid: up to the algorithm */
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
-
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+              conn->cc_ops->cong_avoid(conn, acked);
               ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
             }
+
+          tcp_cc_trace(conn, "ack");
         }
     }
 }
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   time-out.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
+
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+  tcp_cc_trace(conn, "timeout");
+}
+
+/****************************************************************************
+ * Name: tcp_cc_setops
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION socket option).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, not necessarily NUL terminated
+ *   len    - The length of the name
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_setops(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+
+  len = strnlen(name, len);
+  ops = tcp_cc_find(name, len);
+  if (ops == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* A connection that is already running continues from its current
+   * window with the new algorithm.
+   */
+
+  conn->cc_ops = ops;
+  if (conn->tcpstateflags != TCP_ALLOCATED && ops->init != NULL)
+    {
+      ops->init(conn);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_getops
+ *
+ * Description:
+ *   Return the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_ops_s *tcp_cc_getops(FAR struct tcp_conn_s *conn)
+{
+  FAR const struct tcp_cc_ops_s *ops = conn->cc_ops;
+
+  if (ops == NULL)
+    {
+      ops = TCP_CC_DEFAULT_OPS;
+    }
+
+  return ops;
+}
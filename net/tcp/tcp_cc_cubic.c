@@ -0,0 +1,229 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 8312: C = 0.4 and beta_cubic = 0.7.  With t in milliseconds and the
+ * window in segments, W_cubic(t) = C * (t - K)^3 / 10^9 + W_max, so one
+ * segment of growth takes CUBIC_SCALE ms^3.
+ */
+
+#define CUBIC_SCALE       2500000000ull  /* 10^9 / C */
+#define CUBIC_BETA(w)     ((uint32_t)(((uint64_t)(w) * 7) / 10))
+#define CUBIC_FASTCONV(w) ((uint32_t)(((uint64_t)(w) * 17) / 20))
+
+/* Beyond this the cubic term no longer fits in 64 bits; the window is
+ * long past any sensible size by then anyway.
+ */
+
+#define CUBIC_MAX_MS      100000
+#define CUBIC_MAX_SEGS    ((((uint64_t)CUBIC_MAX_MS * CUBIC_MAX_MS * \
+                             CUBIC_MAX_MS) / CUBIC_SCALE) << 10)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",              /* name */
+  cubic_init,           /* init */
+  cubic_ssthresh,       /* ssthresh */
+  cubic_cong_avoid      /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      if ((x >> s) >= 3 * y * (y + 1) + 1)
+        {
+          x -= (3 * y * (y + 1) + 1) << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cubic, 0, sizeof(conn->cubic));
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss (reduced further with fast convergence
+ *   if the previous maximum was not reached) and reduce to beta_cubic.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  uint32_t flight = conn->tx_unacked;
+
+  cubic->epoch = 0;
+  if (flight < cubic->w_max)
+    {
+      cubic->w_max = CUBIC_FASTCONV(flight);
+    }
+  else
+    {
+      cubic->w_max = flight;
+    }
+
+  return MAX(CUBIC_BETA(flight), 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  clock_t now = clock_systime_ticks();
+  uint32_t target;
+  int64_t delta;
+  int64_t t;
+
+  if (acked == 0)
+    {
+      acked = conn->mss;
+    }
+
+  /* Start a new epoch on the first ACK after a reduction */
+
+  if (cubic->epoch == 0)
+    {
+      cubic->epoch = now ? now : 1;
+      cubic->w_est = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          uint64_t segs = ((uint64_t)(cubic->w_max - conn->cwnd) << 10) /
+                          conn->mss;
+
+          segs = MIN(segs, CUBIC_MAX_SEGS);
+          cubic->k      = cubic_cbrt((segs * CUBIC_SCALE) >> 10);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* W_cubic(t) = C * (t - K)^3 + W_max */
+
+  t = (int64_t)TICK2MSEC(now - cubic->epoch) - cubic->k;
+  t = MIN(MAX(t, -CUBIC_MAX_MS), CUBIC_MAX_MS);
+
+  delta = (t * t * t * 1024) / (int64_t)CUBIC_SCALE;
+  delta = (delta * conn->mss) / 1024;
+
+  if (delta < 0 && (uint64_t)-delta >= cubic->origin)
+    {
+      target = conn->mss;
+    }
+  else
+    {
+      target = (uint32_t)MIN((int64_t)cubic->origin + delta,
+                             (int64_t)UINT32_MAX);
+    }
+
+  /* TCP friendly region: the window of standard TCP with the same loss
+   * rate grows by 3 * (1 - beta) / (1 + beta) = 9/17 segments per RTT.
+   */
+
+  cubic->w_est += MAX((uint32_t)(((uint64_t)9 * conn->mss * acked) /
+                                 (17 * (uint64_t)conn->cwnd)), 1);
+  target = MAX(target, cubic->w_est);
+
+  /* Move cwnd towards the target over one RTT */
+
+  if (target > conn->cwnd)
+    {
+      uint64_t increase = ((uint64_t)(target - conn->cwnd) * acked) /
+                          conn->cwnd;
+
+      conn->cwnd = (uint32_t)MIN((uint64_t)conn->cwnd +
+                                 MAX(increase, 1), UINT32_MAX);
+    }
+  else
+    {
+      conn->cwnd += MAX(conn->mss * conn->mss / (100 * conn->cwnd), 1);
+    }
+
+  conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -71,6 +72,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -95,10 +97,125 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The active connections hashed by local port, remote port and remote
+ * address, so that the input path does not need to scan the whole list.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_conn_hash, CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/****************************************************************************
+ * Name: tcp_ipv4_hash_key / tcp_ipv6_hash_key
+ *
+ * Description:
+ *   Create the hash key of an active connection.  The local address is not
+ *   part of the key because a connection may be bound to INADDR_ANY.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hash_key(in_addr_t raddr, uint16_t lport,
+                                         uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hash_key(const net_ipv6addr_t raddr,
+                                         uint16_t lport, uint16_t rport)
+{
+  uint32_t key = (((uint32_t)raddr[0] << 16) | raddr[1]) ^
+                 (((uint32_t)raddr[2] << 16) | raddr[3]) ^
+                 (((uint32_t)raddr[4] << 16) | raddr[5]) ^
+                 (((uint32_t)raddr[6] << 16) | raddr[7]);
+
+  return key ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hash_key
+ *
+ * Description:
+ *   Create the hash key of an active connection from its bindings.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_hash_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_ipv6_hash_key(conn->u.ipv6.raddr, conn->lport,
+                               conn->rport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_ipv4_hash_key(conn->u.ipv4.raddr, conn->lport,
+                               conn->rport);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_nexthashed
+ *
+ * Description:
+ *   Traverse the active connections that hash to the same bucket as 'key'.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_nexthashed(FAR struct tcp_conn_s *conn, uint32_t key)
+{
+  FAR hash_node_t *node;
+
+  if (conn == NULL)
+    {
+      node = g_tcp_conn_hash[HASH(key, hashtable_bits(g_tcp_conn_hash))].head;
+    }
+  else
+    {
+      node = conn->hnode.flink;
+    }
+
+  return node != NULL ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_addconn
+ *
+ * Description:
+ *   Add a connection to the list (and hashtable) of active connections.
+ *
+ * Assumptions:
+ *   Called with the TCP connection list locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addconn(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_add(g_tcp_conn_hash, &conn->hnode, tcp_conn_hash_key(conn));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -150,6 +267,58 @@ static FAR struct tcp_conn_s *
 #endif
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_bindable
+ *
+ * Description:
+ *   Return true if conn may bind this explicit address and port although
+ *   it is already in use, because conn and every connection and listener
+ *   using it have set SO_REUSEPORT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+static bool tcp_reuseport_bindable(FAR struct tcp_conn_s *conn,
+                                   uint8_t domain,
+                                   FAR const union ip_addr_u *ipaddr,
+                                   uint16_t portno)
+{
+  FAR struct tcp_conn_s *other = NULL;
+  bool ret;
+
+  if (portno == 0 || !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+  tcp_conn_list_lock();
+  ret = tcp_reuseport_shared(domain, ipaddr, portno);
+  while (ret && (other = tcp_nextconn(other)) != NULL)
+    {
+      if (other->tcpstateflags != TCP_CLOSED &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          tcp_conn_cmp(domain, ipaddr, portno, other) &&
+#else
+          tcp_conn_cmp(ipaddr, portno, other) &&
+#endif
+          !_SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+        {
+          ret = false;
+        }
+    }
+
+#ifdef CONFIG_NET_NAT
+  if (ret && nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno))
+    {
+      ret = false;
+    }
+#endif
+
+  tcp_conn_list_unlock();
+  return ret;
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Name: tcp_ipv4_active
  *
@@ -170,10 +339,18 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  uint32_t key;
+#endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  key        = tcp_ipv4_hash_key(srcipaddr, tcp->destport, tcp->srcport);
+  conn       = tcp_nexthashed(NULL, key);
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -210,7 +387,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = tcp_nexthashed(conn, key);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -237,10 +418,18 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  uint32_t key;
+#endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  key        = tcp_ipv6_hash_key(*srcipaddr, tcp->destport, tcp->srcport);
+  conn       = tcp_nexthashed(NULL, key);
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -277,7 +466,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = tcp_nexthashed(conn, key);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -341,9 +534,21 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
+#ifdef CONFIG_NET_REUSEPORT
+  if (tcp_reuseport_bindable(conn, PF_INET,
+                       (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                       addr->sin_port))
+    {
+      port = addr->sin_port;
+    }
+  else
+#endif
+    {
+      port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
                        addr->sin_port);
+    }
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -437,9 +642,21 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* The port number must be unique for this address binding */
 
-  port = tcp_selectport(PF_INET6,
+#ifdef CONFIG_NET_REUSEPORT
+  if (tcp_reuseport_bindable(conn, PF_INET6,
+                (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
+                addr->sin6_port))
+    {
+      port = addr->sin6_port;
+    }
+  else
+#endif
+    {
+      port = tcp_selectport(PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
                 addr->sin6_port);
+    }
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -803,6 +1020,14 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   conn_dev_unlock(&conn->sconn, conn->dev);
 
+  /* Drop any pending poll request left on the device ready list before the
+   * connection leaves the active list, so that the device poll can no
+   * longer pick it up.  This takes the device lock, so do it before the
+   * connection list lock.
+   */
+
+  netdev_txnotify_cancel(&conn->sconn, TCP_POLL);
+
   /* TCP_ALLOCATED means that that the connection is not in the active list
    * yet.
    */
@@ -812,7 +1037,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_removeconn(conn);
       tcp_conn_list_unlock();
     }
 
@@ -823,6 +1048,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   nxrmutex_destroy(&conn->sconn.s_lock);
   tcp_free_rx_buffers(conn);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+  /* Release any read-ahead data still loaned to the application */
+
+  tcp_zcfree(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -1118,6 +1349,13 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_SOCKOPTS
       conn->sconn.s_rcvtimeo = listener->sconn.s_rcvtimeo;
       conn->sconn.s_sndtimeo = listener->sconn.s_sndtimeo;
+#  ifdef CONFIG_NET_REUSEPORT
+      /* The accepted connection shares the port with the listener's
+       * group, so it must not block later members from binding.
+       */
+
+      conn->sconn.s_options |= listener->sconn.s_options & _SO_REUSEPORT;
+#  endif
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
@@ -1155,8 +1393,11 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-      /* Initialize the variables of congestion control */
+      /* Initialize the variables of congestion control, using the
+       * algorithm selected on the listener.
+       */
 
+      conn->cc_ops = listener->cc_ops;
       tcp_cc_init(conn);
 #endif
 
@@ -1181,7 +1422,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addconn(conn);
       tcp_conn_list_unlock();
 
       tcp_update_retrantimer(conn, TCP_RTO);
@@ -1490,7 +1731,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addconn(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1536,6 +1777,9 @@ void tcp_conn_list_unlock(void)
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
   dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_delete(g_tcp_conn_hash, &conn->hnode, tcp_conn_hash_key(conn));
+#endif
 }
 
 /****************************************************************************
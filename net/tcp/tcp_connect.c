@@ -379,7 +379,7 @@ int psock_tcp_connect(FAR struct socket *psock,
 
               /* Notify the device driver that new connection is available. */
 
-              netdev_txnotify_dev(conn->dev, TCP_POLL);
+              netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
 
               /* Wait for either the connect to complete or for an
                * error/timeout to occur.
@@ -443,7 +443,7 @@ int psock_tcp_connect(FAR struct socket *psock,
 
           /* Notify the device driver that new connection is available. */
 
-          netdev_txnotify_dev(conn->dev, TCP_POLL);
+          netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
         }
     }
 
@@ -554,6 +554,7 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
   unsigned int tcpiplen;
   uint16_t tmp16;
   uint8_t  opt;
+  int optlen;
   int i;
 
   tcp = IPBUF(iplen);
@@ -564,8 +565,9 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
     }
 
   tcpiplen = iplen + TCP_HDRLEN;
+  optlen   = ((tcp->tcpoffset >> 4) - 5) << 2;
 
-  for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
+  for (i = 0; i < optlen; )
     {
       opt = IPDATA(tcpiplen + i);
       if (opt == TCP_OPT_END)
@@ -615,6 +617,16 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
         {
           conn->flags    |= TCP_SACK;
         }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen)
+        {
+          conn->ts_recent     = tcp_getsequence(&IPDATA(tcpiplen + 2 + i));
+          conn->ts_recent_age = TICK2SEC(clock_systime_ticks());
+          conn->flags        |= TCP_TSTAMP;
+        }
 #endif
       else
         {
@@ -634,7 +646,81 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
 
       i += IPDATA(tcpiplen + 1 + i);
     }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The Timestamps option is carried in every segment from now on */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      conn->mss -= TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_parse_tsopt
+ *
+ * Description:
+ *   Find the Timestamps option in an incoming segment.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received TCP packet.
+ *   iplen  - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *   tsval  - Location to return the timestamp value of the peer
+ *   tsecr  - Location to return the timestamp echo reply
+ *
+ * Returned Value:
+ *   True if the segment carries the Timestamps option.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+static bool tcp_parse_tsopt(FAR struct net_driver_s *dev,
+                            unsigned int iplen, FAR uint32_t *tsval,
+                            FAR uint32_t *tsecr)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  unsigned int tcpiplen = iplen + TCP_HDRLEN;
+  unsigned int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  unsigned int i;
+  uint8_t opt;
+
+  if ((tcp->tcpoffset & 0xf0) <= 0x50)
+    {
+      return false;
+    }
+
+  for (i = 0; i < optlen; )
+    {
+      opt = IPDATA(tcpiplen + i);
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || IPDATA(tcpiplen + 1 + i) < 2)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen)
+        {
+          *tsval = tcp_getsequence(&IPDATA(tcpiplen + 2 + i));
+          *tsecr = tcp_getsequence(&IPDATA(tcpiplen + 6 + i));
+          return true;
+        }
+
+      i += IPDATA(tcpiplen + 1 + i);
+    }
+
+  return false;
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_clear_zero_probe
@@ -700,6 +786,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   uint16_t tmp16;
   uint16_t result;
   int      len;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t tsval;
+  uint32_t tsecr = 0;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -834,7 +924,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
             {
               if ((tcp->flags & TCP_RST) == 0)
                 {
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
                   return;
                 }
               else
@@ -897,6 +987,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
     {
       net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+#ifdef CONFIG_NET_REUSEPORT
+      net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
+#endif
     }
 #endif
 
@@ -907,14 +1000,23 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
     {
       net_ipv4addr_copy(uaddr.ipv4.laddr,
                         net_ip4addr_conv32(IPv4BUF->destipaddr));
+#ifdef CONFIG_NET_REUSEPORT
+      net_ipv4addr_copy(uaddr.ipv4.raddr,
+                        net_ip4addr_conv32(IPv4BUF->srcipaddr));
+#endif
     }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if ((conn = tcp_findlistener(&uaddr, tmp16, domain)) != NULL)
+  conn = tcp_findlistener(&uaddr, tmp16, domain);
 #else
-  if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
+  conn = tcp_findlistener(&uaddr, tmp16);
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+  conn = tcp_reuseport_select(conn, &uaddr, tcp->srcport);
 #endif
+
+  if (conn != NULL)
     {
       /* According rfc793 p65&66, In LISTEN state, first ignore packet
        * contains RST flag, second reset packet contains ACK flag,
@@ -1064,6 +1166,43 @@ found:
       goto drop;
     }
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if ((conn->flags & TCP_TSTAMP) != 0 &&
+      tcp_parse_tsopt(dev, iplen, &tsval, &tsecr))
+    {
+      uint32_t now = TICK2SEC(clock_systime_ticks());
+      uint32_t seq = tcp_getsequence(tcp->seqno);
+
+      /* PAWS (RFC 7323 section 5.3): reject a segment whose timestamp is
+       * older than the most recent one accepted, unless that one has been
+       * idle for too long to be trusted.  RST segments are exempt.
+       */
+
+      if ((tcp->flags & TCP_RST) == 0 &&
+          TCP_SEQ_LT(tsval, conn->ts_recent) &&
+          now - conn->ts_recent_age < TCP_PAWS_IDLE)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.drop++;
+#endif
+          nwarn("WARNING: PAWS reject tsval %" PRIu32 " < %" PRIu32 "\n",
+                tsval, conn->ts_recent);
+          tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
+          return;
+        }
+
+      /* Remember the timestamp to echo if the segment covers the left edge
+       * of the receive window.
+       */
+
+      if (TCP_SEQ_LTE(seq, tcp_getsequence(conn->rcvseq)))
+        {
+          conn->ts_recent     = tsval;
+          conn->ts_recent_age = now;
+        }
+    }
+#endif
+
   /* Calculated the length of the data, if the application has sent
    * any data to us.
    */
@@ -1170,7 +1309,7 @@ found:
             {
               /* old ack */
 
-              tcp_send(dev, conn, TCP_ACK, tcpiplen);
+              tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
               return;
             }
           else
@@ -1196,7 +1335,7 @@ found:
           if ((conn->tcpstateflags & TCP_STATE_MASK) >= TCP_ESTABLISHED &&
               (conn->tcpstateflags & TCP_STATE_MASK) <= TCP_LAST_ACK)
             {
-              tcp_send(dev, conn, TCP_ACK, tcpiplen);
+              tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
               return;
             }
           else if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_SYN_RCVD)
@@ -1234,6 +1373,22 @@ found:
 #endif
 
 #ifndef CONFIG_NET_TCP_FIXED_RTO
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* With timestamps every ACK of new data gives an RTT sample, even
+       * after retransmissions, since the echoed timestamp identifies the
+       * segment that was ACKed.
+       */
+
+      if ((conn->flags & TCP_TSTAMP) != 0)
+        {
+          if (tsecr != 0 && conn->tx_unacked < lasttxunacked)
+            {
+              tcp_update_rtt(conn, tcp_ts_now() - tsecr);
+            }
+        }
+      else
+#endif
+
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
@@ -1333,7 +1488,7 @@ skip_rtt:
                    * E.g. a keep-alive segment.
                    */
 
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
                   return;
                 }
             }
@@ -1344,7 +1499,7 @@ skip_rtt:
 
               tcp_input_ofosegs(dev, conn, iplen);
 #endif
-              tcp_send(dev, conn, TCP_ACK, tcpiplen);
+              tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
               return;
             }
         }
@@ -1702,7 +1857,7 @@ skip_rtt:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_RXCLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
             return;
           }
         else if ((flags & TCP_ACKDATA) != 0 && conn->tx_unacked == 0)
@@ -1731,7 +1886,7 @@ skip_rtt:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_RXCLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
             return;
           }
 
@@ -1745,7 +1900,7 @@ skip_rtt:
         goto drop;
 
       case TCP_TIME_WAIT:
-        tcp_send(dev, conn, TCP_ACK, tcpiplen);
+        tcp_send(dev, conn, TCP_ACK, tcpiplen + tcp_optsize(conn));
         return;
 
       case TCP_CLOSING:
@@ -33,6 +33,7 @@
 #include <errno.h>
 
 #include <net/if.h>
+#include <netinet/tcp.h>
 
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
@@ -122,6 +123,19 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
 {
   int ret = OK;
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY_RECV
+  /* These take the device lock as well, before the connection lock */
+
+  if (cmd == SIOCZCRECV)
+    {
+      return tcp_zcrecv(conn, (FAR struct tcp_zcrecv_s *)(uintptr_t)arg);
+    }
+  else if (cmd == SIOCZCRELEASE)
+    {
+      return tcp_zcrelease(conn, (FAR void *)(uintptr_t)arg);
+    }
+#endif
+
   conn_lock(&conn->sconn);
 
   switch (cmd)
@@ -48,14 +48,18 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
@@ -65,6 +69,12 @@
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The listening connections hashed by local port */
+
+static DECLARE_HASHTABLE(g_tcp_listen_hash, CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -89,11 +99,25 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+#else
   int ndx;
+#endif
 
   /* Examine each connection structure in each slot of the listener list */
 
   tcp_conn_list_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_for_every_possible(g_tcp_listen_hash, node, portno)
+    {
+      /* Listeners on other ports may hash to the same bucket, the port
+       * is checked below.
+       */
+
+      FAR struct tcp_conn_s *conn =
+        container_of(node, struct tcp_conn_s, hnode);
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       /* Is this slot assigned?  If so, does the connection have the same
@@ -101,6 +125,7 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
                        conn))
@@ -119,6 +144,63 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_member
+ *
+ * Description:
+ *   Return true if conn is in the SO_REUSEPORT group of listener: it has
+ *   the option set and is bound to exactly the same address and port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+static bool tcp_reuseport_member(FAR struct tcp_conn_s *listener,
+                                 FAR struct tcp_conn_s *conn)
+{
+  return conn != NULL && conn->lport == listener->lport &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+         conn->domain == listener->domain &&
+#endif
+         _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+         memcmp(net_ip_binding_laddr(&conn->u, conn->domain),
+                net_ip_binding_laddr(&listener->u, listener->domain),
+                net_ip_domain_select(listener->domain, sizeof(in_addr_t),
+                                     sizeof(net_ipv6addr_t))) == 0;
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_grouped
+ *
+ * Description:
+ *   Return true if another listener shares the SO_REUSEPORT group of conn.
+ *
+ * Assumptions:
+ *   Called with the TCP connection list locked.
+ *
+ ****************************************************************************/
+
+static bool tcp_reuseport_grouped(FAR struct tcp_conn_s *conn)
+{
+  int ndx;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      if (tcp_listenports[ndx] != conn &&
+          tcp_reuseport_member(conn, tcp_listenports[ndx]))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -145,7 +227,19 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
       if (tcp_listenports[ndx] == conn)
         {
           tcp_listenports[ndx] = NULL;
-          tcp_remove_syn_backlog(conn);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+          hashtable_delete(g_tcp_listen_hash, &conn->hnode, conn->lport);
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+          /* Half-open connections are handed to the remaining members of
+           * a SO_REUSEPORT group when their handshake completes.
+           */
+
+          if (!tcp_reuseport_grouped(conn))
+#endif
+            {
+              tcp_remove_syn_backlog(conn);
+            }
           ret = OK;
           break;
         }
@@ -180,10 +274,20 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
   /* First, check if there is already a socket listening on this port */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  if (tcp_islistener(&conn->u, conn->lport, conn->domain)
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  if (tcp_islistener(&conn->u, conn->lport)
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+      /* Unless it and all the existing listeners permit sharing the port */
+
+      && !(_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+           tcp_reuseport_shared(net_ip_domain_select(conn->domain,
+                                                     PF_INET, PF_INET6),
+                                (FAR const union ip_addr_u *)&conn->u,
+                                conn->lport))
+#endif
+     )
     {
       /* Yes, then we must refuse this request */
 
@@ -208,6 +312,9 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               /* Yes.. we found it */
 
               tcp_listenports[ndx] = conn;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+              hashtable_add(g_tcp_listen_hash, &conn->hnode, conn->lport);
+#endif
               ret = OK;
               break;
             }
@@ -242,6 +349,103 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_shared
+ *
+ * Description:
+ *   Return true if every listener on this address and port has set
+ *   SO_REUSEPORT, so that one more socket may join them.
+ *
+ * Assumptions:
+ *   Called with the TCP connection list locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+bool tcp_reuseport_shared(uint8_t domain, FAR const union ip_addr_u *ipaddr,
+                          uint16_t portno)
+{
+  FAR struct tcp_conn_s *conn;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      conn = tcp_listenports[ndx];
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (tcp_conn_cmp(domain, ipaddr, portno, conn) &&
+#else
+      if (tcp_conn_cmp(ipaddr, portno, conn) &&
+#endif
+          !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Given the listener found for a new connection, pick the member of its
+ *   SO_REUSEPORT group (the listeners with the option set on exactly the
+ *   same local address and port) that should own the connection.  The
+ *   choice depends only on the remote address and port, so the SYN and the
+ *   ACK completing the handshake select the same listener.
+ *
+ * Input Parameters:
+ *   listener - The first listener matching the connection.
+ *   uaddr    - The addresses of the new connection.
+ *   rport    - The remote port of the new connection.
+ *
+ * Returned Value:
+ *   The selected listener; 'listener' itself if it is not in a group.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *
+tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                     FAR union ip_binding_u *uaddr, uint16_t rport)
+{
+  FAR struct tcp_conn_s *group[CONFIG_NET_MAX_LISTENPORTS];
+  int count = 0;
+  int ndx;
+
+  if (listener == NULL ||
+      !_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+  tcp_conn_list_lock();
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      if (tcp_reuseport_member(listener, tcp_listenports[ndx]))
+        {
+          group[count++] = tcp_listenports[ndx];
+        }
+    }
+
+  if (count > 1)
+    {
+      ndx = net_reuseport_hash(net_ip_binding_raddr(uaddr, listener->domain),
+                               net_ip_domain_select(listener->domain,
+                                                    sizeof(in_addr_t),
+                                                    sizeof(net_ipv6addr_t)),
+                               rport) % count;
+      listener = group[ndx];
+    }
+
+  tcp_conn_list_unlock();
+  return listener;
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -268,6 +472,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
   listener = tcp_findlistener(&conn->u, portno, conn->domain);
 #else
   listener = tcp_findlistener(&conn->u, portno);
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+  listener = tcp_reuseport_select(listener, &conn->u, conn->rport);
 #endif
   if (listener != NULL)
     {
@@ -836,7 +836,7 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
 
   if (tcp_should_send_recvwindow(conn))
     {
-      netdev_txnotify_dev(conn->dev, TCP_POLL);
+      netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
     }
 
   tcp_notify_recvcpu(conn);
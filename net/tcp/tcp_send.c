@@ -104,6 +104,36 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_sendchksum
+ *
+ * Description:
+ *   Calculate the checksum of the TCP segment of 'tcplen' bytes in d_iob.
+ *   The payload is not summed again if the write buffer it came from
+ *   already was.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+static uint16_t tcp_sendchksum(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn,
+                               FAR struct tcp_hdr_s *tcp,
+                               unsigned int tcplen)
+{
+#ifdef TCP_WB_CHKSUM
+  unsigned int hdrlen = (tcp->tcpoffset >> 4) << 2;
+
+  if (conn->sndsumlen != 0 && tcplen == hdrlen + conn->sndsumlen)
+    {
+      return net_upperlayer_chksum_presummed(dev, IP_PROTO_TCP, tcp,
+                                             hdrlen, conn->sndsum);
+    }
+#endif
+
+  return tcp_chksum(dev);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -202,7 +232,8 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
       if ((dev->d_features & NETDEV_TX_CSUM) == 0)
         {
-          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+          tcp->tcpchksum = ~tcp_sendchksum(dev, conn, tcp,
+                                           dev->d_len - IPv6_HDRLEN);
         }
 #endif
 
@@ -222,14 +253,18 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         &dev->d_ipaddr, &conn->u.ipv4.raddr,
                         conn->sconn.s_ttl, conn->sconn.s_tos, NULL);
 
-      /* Calculate TCP checksum. */
+      /* Calculate TCP checksum.  A segment still to be split is summed
+       * per segment by whoever splits it.
+       */
 
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0 &&
+          NETDEV_GSO_SIZE(dev) == 0)
         {
-          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+          tcp->tcpchksum = ~tcp_sendchksum(dev, conn, tcp,
+                                           dev->d_len - IPv4_HDRLEN);
         }
 #endif
 
@@ -239,6 +274,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef TCP_WB_CHKSUM
+  /* The payload sum was only good for this segment */
+
+  conn->sndsumlen = 0;
+#endif
+
   ninfo("Outgoing TCP packet length: %d bytes\n", dev->d_len);
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.tcp.sent++;
@@ -260,6 +301,26 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
 }
 
+/****************************************************************************
+ * Name: tcp_addtsopt
+ *
+ * Description:
+ *   Write the Timestamps option, preceded by two NOOPs, at 'opt'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+static void tcp_addtsopt(FAR uint8_t *opt, uint32_t tsecr)
+{
+  opt[0] = TCP_OPT_NOOP;
+  opt[1] = TCP_OPT_NOOP;
+  opt[2] = TCP_OPT_TS;
+  opt[3] = TCP_OPT_TS_LEN;
+  tcp_setsequence(&opt[4], tcp_ts_now());
+  tcp_setsequence(&opt[8], tsecr);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -275,7 +336,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
  *   conn   - The TCP connection structure holding connection information
  *   flags  - flags to apply to the TCP header
  *   len    - length of the message (includes the length of the IP and TCP
- *            headers)
+ *            headers, as returned by tcpip_hdrsize())
  *
  * Returned Value:
  *   None
@@ -289,6 +350,7 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp;
+  int tsoptlen = tcp_optsize(conn);
 
   if (dev->d_iob == NULL)
     {
@@ -299,38 +361,53 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags = flags;
   dev->d_len = len;
 
+  /* The space for the options sent in every segment is already included
+   * in len, any data follows it.
+   */
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if (tsoptlen > 0)
+    {
+      tcp_addtsopt(tcp->optdata, conn->ts_recent);
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      FAR uint8_t *optdata = &tcp->optdata[tsoptlen];
+      int nsacks = MIN(conn->nofosegs,
+                       (TCP_MAX_HDRLEN - TCP_HDRLEN - tsoptlen - 4) /
+                       (int)sizeof(struct tcp_sack_s));
+      int optlen = nsacks * sizeof(struct tcp_sack_s);
       int i;
 
-      tcp->optdata[0] = TCP_OPT_NOOP;
-      tcp->optdata[1] = TCP_OPT_NOOP;
-      tcp->optdata[2] = TCP_OPT_SACK;
-      tcp->optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
+      optdata[0] = TCP_OPT_NOOP;
+      optdata[1] = TCP_OPT_NOOP;
+      optdata[2] = TCP_OPT_SACK;
+      optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
 
       optlen += 4;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
                 conn->ofosegs[i].left, conn->ofosegs[i].right,
                 TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
-          tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
+          tcp_setsequence(&optdata[4 + i * 2 * sizeof(uint32_t)],
                           conn->ofosegs[i].left);
-          tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
+          tcp_setsequence(&optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
                           conn->ofosegs[i].right);
         }
 
       dev->d_len += optlen;
-      tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+      tcp->tcpoffset = ((TCP_HDRLEN + tsoptlen + optlen) / 4) << 4;
     }
   else
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
     {
-      tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+      tcp->tcpoffset = ((TCP_HDRLEN + tsoptlen) / 4) << 4;
     }
 
   tcp_sendcommon(dev, conn, tcp);
@@ -623,9 +700,11 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   tcp = tcp_header(dev);
 
-  /* Set the packet length for the TCP Maximum Segment Size */
+  /* Set the packet length for the TCP Maximum Segment Size.  All of the
+   * options are added below.
+   */
 
-  dev->d_len = tcpip_hdrsize(conn);
+  dev->d_len = tcpip_hdrsize(conn) - tcp_optsize(conn);
 
   /* Set the packet length for the TCP Maximum Segment Size */
 
@@ -673,6 +752,16 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if (tcp->flags == TCP_SYN ||
+      ((tcp->flags == (TCP_ACK | TCP_SYN)) && (conn->flags & TCP_TSTAMP)))
+    {
+      tcp_addtsopt(&tcp->optdata[optlen],
+                   tcp->flags == TCP_SYN ? 0 : conn->ts_recent);
+      optlen += TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -711,7 +800,9 @@ void tcp_send_txnotify(FAR struct socket *psock,
     {
       /* Notify the device driver that send data is available */
 
-      netdev_ipv4_txnotify(conn->u.ipv4.laddr, conn->u.ipv4.raddr, TCP_POLL);
+      netdev_txnotify_conn(netdev_findby_ripv4addr(conn->u.ipv4.laddr,
+                                                   conn->u.ipv4.raddr),
+                           &conn->sconn, TCP_POLL);
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -723,7 +814,9 @@ void tcp_send_txnotify(FAR struct socket *psock,
       /* Notify the device driver that send data is available */
 
       DEBUGASSERT(psock->s_domain == PF_INET6);
-      netdev_ipv6_txnotify(conn->u.ipv6.laddr, conn->u.ipv6.raddr, TCP_POLL);
+      netdev_txnotify_conn(netdev_findby_ripv6addr(conn->u.ipv6.laddr,
+                                                   conn->u.ipv6.raddr),
+                           &conn->sconn, TCP_POLL);
     }
 #endif /* CONFIG_NET_IPv6 */
 }
@@ -744,9 +837,8 @@ void tcp_send_txnotify(FAR struct socket *psock,
 
 uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn)
 {
-  uint16_t hdrsize = sizeof(struct tcp_hdr_s);
+  uint16_t hdrsize = sizeof(struct tcp_hdr_s) + tcp_optsize(conn);
 
-  UNUSED(conn);
   return net_ip_domain_select(conn->domain,
                               sizeof(struct ipv4_hdr_s) + hdrsize,
                               sizeof(struct ipv6_hdr_s) + hdrsize);
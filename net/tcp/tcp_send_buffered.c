@@ -411,6 +411,62 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: tcp_send_maxlen
+ *
+ * Description:
+ *   Return the largest amount of data that may be passed to the device in
+ *   one segment: the MSS, or as much as fits in one packet if the device
+ *   splits oversized segments itself.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_send_maxlen(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_GSO
+  if ((dev->d_features & NETDEV_GSO) != 0 &&
+#ifdef CONFIG_NET_IPv6
+      conn->domain == PF_INET &&
+#endif
+      !net_ipv4addr_cmp(conn->u.ipv4.raddr, dev->d_ipaddr))
+    {
+      return UINT16_MAX - NET_LL_HDRLEN(dev) - tcpip_hdrsize(conn);
+    }
+#endif
+
+  return conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_send_setsum
+ *
+ * Description:
+ *   Tell tcp_send() the payload checksum of the segment about to be sent
+ *   if it is the whole of a write buffer whose sum is known.
+ *
+ ****************************************************************************/
+
+#ifdef TCP_WB_CHKSUM
+static void tcp_send_setsum(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_wrbuffer_s *wrb,
+                            uint32_t offset, uint32_t sndlen)
+{
+  if (offset == 0 && sndlen == TCP_WBPKTLEN(wrb) &&
+      wrb->wb_chksumlen == sndlen)
+    {
+      conn->sndsum    = wrb->wb_chksum;
+      conn->sndsumlen = sndlen;
+    }
+  else
+    {
+      conn->sndsumlen = 0;
+    }
+}
+#else
+#  define tcp_send_setsum(conn,wrb,offset,sndlen)
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -626,7 +682,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                        */
 
                       conn->timeout = true;
-                      netdev_txnotify_dev(conn->dev, TCP_POLL);
+                      netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
                       netdev_iob_replace(dev, iob);
                       dev->d_buf = buf;
                       dev->d_appdata = appdata;
@@ -790,10 +846,14 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+          tcp_send_setsum(conn, wrb, 0, sndlen);
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                0, tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef TCP_WB_CHKSUM
+              conn->sndsumlen = 0;
+#endif
               return flags;
             }
 
@@ -1062,9 +1122,9 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_send_maxlen(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_send_maxlen(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1128,10 +1188,23 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+          /* Tell the driver how to split a segment larger than the MSS */
+
+          dev->d_gso_size = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
+          tcp_send_setsum(conn, wrb, TCP_WBSENT(wrb), sndlen);
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef TCP_WB_CHKSUM
+              conn->sndsumlen = 0;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+              dev->d_gso_size = 0;
+#endif
               return flags;
             }
 
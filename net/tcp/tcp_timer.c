@@ -155,7 +155,7 @@ static void tcp_timer_expiry(FAR void *arg)
           tcp_conn_list_unlock();
           conn->timeout = true;
           netdev_lock(conn->dev);
-          netdev_txnotify_dev(conn->dev, TCP_POLL);
+          netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
           netdev_unlock(conn->dev);
           return;
         }
@@ -294,6 +294,67 @@ void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout)
   tcp_update_timer(conn);
 }
 
+/****************************************************************************
+ * Name: tcp_update_rtt
+ *
+ * Description:
+ *   Feed an RTT sample to the SRTT/RTTVAR estimator of the connection and
+ *   update the retransmission time-out (RFC 6298).
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection of interest
+ *   rtt     - The measured round trip time in milliseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+void tcp_update_rtt(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  uint32_t rto;
+  int32_t delta;
+
+  /* Ignore samples from a clock that went backwards or a bogus echo */
+
+  if (rtt > (uint32_t)TCP_RTO_MAX * MSEC_PER_HSEC)
+    {
+      return;
+    }
+
+  if (conn->srtt == 0)
+    {
+      /* First measurement: SRTT = R, RTTVAR = R / 2 */
+
+      conn->srtt   = MAX(rtt, 1) << 3;
+      conn->rttvar = rtt << 1;
+    }
+  else
+    {
+      /* RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R */
+
+      delta = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+      conn->srtt = MAX((int32_t)conn->srtt + delta, 8);
+      if (delta < 0)
+        {
+          delta = -delta;
+        }
+
+      delta -= conn->rttvar >> 2;
+      conn->rttvar += delta;
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), in units of the retransmission
+   * timer, rounded up.
+   */
+
+  rto = (conn->srtt >> 3) + MAX(conn->rttvar, MSEC_PER_TICK);
+  rto = (rto + MSEC_PER_HSEC - 1) / MSEC_PER_HSEC;
+  conn->rto = MIN(MAX(rto, TCP_RTO_MIN), TCP_RTO_MAX);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_update_keeptimer
  *
@@ -628,22 +689,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Reset cwnd and ssthresh */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
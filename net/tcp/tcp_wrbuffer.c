@@ -237,6 +237,41 @@ uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn)
 }
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_trycopyin
+ *
+ * Description:
+ *   Copy user data into a write buffer at 'off' without waiting for I/O
+ *   buffers, like iob_trycopyin().  Data appended to the summed part of
+ *   the write buffer is summed as it is copied.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef TCP_WB_CHKSUM
+int tcp_wrbuffer_trycopyin(FAR struct tcp_wrbuffer_s *wrb,
+                           FAR const uint8_t *src, unsigned int len,
+                           unsigned int off)
+{
+  bool odd = (off & 1) != 0;
+  int ret;
+
+  if (off != wrb->wb_chksumlen)
+    {
+      return iob_trycopyin(wrb->wb_iob, src, len, off, true);
+    }
+
+  /* The sum covers whatever was copied, even if not all of it could be */
+
+  ret = net_iob_copyin_chksum(wrb->wb_iob, src, len, off, true, false,
+                              &wrb->wb_chksum, &odd);
+  wrb->wb_chksumlen = TCP_WBPKTLEN(wrb);
+  return ret;
+}
+#endif /* TCP_WB_CHKSUM */
+
 /****************************************************************************
  * Name: tcp_wrbuffer_test
  *
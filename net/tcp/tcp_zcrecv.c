@@ -0,0 +1,278 @@
+/****************************************************************************
+ * net/tcp/tcp_zcrecv.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <netinet/tcp.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_ZEROCOPY_RECV)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* An I/O buffer chain loaned to the application */
+
+struct tcp_zcloan_s
+{
+  sq_entry_t        zl_node;  /* Link in the zcloans list of the connection */
+  FAR struct iob_s *zl_iob;   /* The loaned chain, also the zc_handle */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zcrecv
+ *
+ * Description:
+ *   Loan the read-ahead data of a TCP connection to the caller instead of
+ *   copying it (SIOCZCRECV).  Up to zc_iovcnt I/O buffers are detached from
+ *   the head of the read-ahead chain and described in zc_iov, the detached
+ *   chain is returned as zc_handle.
+ *
+ *   This never waits for data; use poll() to wait for POLLIN.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   zc   - The zero-copy receive request
+ *
+ * Returned Value:
+ *   OK on success, zc_len is 0 at the end of the stream.  A negated errno
+ *   value on failure:
+ *
+ *   EAGAIN   - No data is available
+ *   ENOTCONN - The connection is not connected
+ *   EINVAL   - Invalid request
+ *   ENOMEM   - The loan could not be recorded
+ *
+ ****************************************************************************/
+
+int tcp_zcrecv(FAR struct tcp_conn_s *conn, FAR struct tcp_zcrecv_s *zc)
+{
+  FAR struct tcp_zcloan_s *loan;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *last = NULL;
+  int ret = OK;
+  int n = 0;
+
+  if (zc == NULL || zc->zc_iov == NULL || zc->zc_iovcnt <= 0)
+    {
+      return -EINVAL;
+    }
+
+  zc->zc_len    = 0;
+  zc->zc_handle = NULL;
+
+  conn_dev_lock(&conn->sconn, conn->dev);
+
+  /* NOTE that there may be read-ahead data to be retrieved even after
+   * the socket has been disconnected.
+   */
+
+  iob = conn->readahead;
+  if (iob == NULL)
+    {
+      if (!_SS_ISCONNECTED(conn->sconn.s_flags) ||
+          (conn->shutdown & SHUT_RD) != 0)
+        {
+          if (!_SS_ISCLOSED(conn->sconn.s_flags) &&
+              (conn->shutdown & SHUT_RD) == 0)
+            {
+              ret = -ENOTCONN;
+            }
+        }
+      else
+        {
+          ret = -EAGAIN;
+        }
+
+      zc->zc_iovcnt = 0;
+      goto out;
+    }
+
+  DEBUGASSERT(iob->io_pktlen > 0);
+
+  /* Record the loan, tcp_zcrelease() accepts only recorded handles */
+
+  loan = kmm_malloc(sizeof(struct tcp_zcloan_s));
+  if (loan == NULL)
+    {
+      zc->zc_iovcnt = 0;
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  /* Describe the buffers at the head of the chain */
+
+  for (last = iob; ; last = last->io_flink)
+    {
+      zc->zc_iov[n].iov_base = last->io_data + last->io_offset;
+      zc->zc_iov[n].iov_len  = last->io_len;
+      zc->zc_len            += last->io_len;
+
+      if (++n >= zc->zc_iovcnt || last->io_flink == NULL)
+        {
+          break;
+        }
+    }
+
+  /* Detach them, the rest of the chain stays read-ahead data */
+
+  conn->readahead = last->io_flink;
+  if (conn->readahead != NULL)
+    {
+      conn->readahead->io_pktlen = iob->io_pktlen - zc->zc_len;
+      last->io_flink = NULL;
+      iob->io_pktlen = zc->zc_len;
+    }
+
+  loan->zl_iob = iob;
+  sq_addlast(&loan->zl_node, &conn->zcloans);
+
+  zc->zc_iovcnt = n;
+  zc->zc_handle = iob;
+
+  ninfo("Loaned %zu bytes in %d buffers\n", zc->zc_len, n);
+
+  /* The loaned buffers still count as used IOBs, the window is opened
+   * again when they are returned.
+   */
+
+  if (tcp_should_send_recvwindow(conn))
+    {
+      netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
+    }
+
+out:
+  conn_dev_unlock(&conn->sconn, conn->dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_zcrelease
+ *
+ * Description:
+ *   Return the data loaned by tcp_zcrecv() (SIOCZCRELEASE).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   handle - The zc_handle returned by tcp_zcrecv()
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure.  -EINVAL if handle is
+ *   not a loan of this connection, e.g. if it was already returned.
+ *
+ ****************************************************************************/
+
+int tcp_zcrelease(FAR struct tcp_conn_s *conn, FAR void *handle)
+{
+  FAR struct tcp_zcloan_s *loan = NULL;
+  FAR sq_entry_t *entry;
+
+  if (handle == NULL)
+    {
+      return -EINVAL;
+    }
+
+  conn_dev_lock(&conn->sconn, conn->dev);
+
+  for (entry = sq_peek(&conn->zcloans); entry != NULL;
+       entry = sq_next(entry))
+    {
+      loan = (FAR struct tcp_zcloan_s *)entry;
+      if (loan->zl_iob == handle)
+        {
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      conn_dev_unlock(&conn->sconn, conn->dev);
+      nwarn("WARNING: Not a loan of this connection: %p\n", handle);
+      return -EINVAL;
+    }
+
+  sq_rem(entry, &conn->zcloans);
+  iob_free_chain(loan->zl_iob);
+  kmm_free(loan);
+
+  /* Freeing the buffers may open the receive window again */
+
+  if (tcp_should_send_recvwindow(conn))
+    {
+      netdev_txnotify_conn(conn->dev, &conn->sconn, TCP_POLL);
+    }
+
+  conn_dev_unlock(&conn->sconn, conn->dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_zcfree
+ *
+ * Description:
+ *   Free the data loaned by tcp_zcrecv() that was never returned, called
+ *   when the connection is freed.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_zcfree(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_zcloan_s *loan;
+
+  while ((loan = (FAR struct tcp_zcloan_s *)
+                 sq_remfirst(&conn->zcloans)) != NULL)
+    {
+      iob_free_chain(loan->zl_iob);
+      kmm_free(loan);
+    }
+}
+
+#endif /* CONFIG_NET_TCP && CONFIG_NET_TCP_ZEROCOPY_RECV */
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -58,6 +59,14 @@
 #  else
 #    define UDP_WBDUMP(msg,wrb,len,offset)
 #  endif
+
+/* The payload is summed while it is copied into the write buffer, so that
+ * udp_send() only has to sum the headers.
+ */
+
+#  if defined(CONFIG_NET_UDP_CHECKSUMS) && !defined(CONFIG_NET_ARCH_CHKSUM)
+#    define UDP_WB_CHKSUM 1
+#  endif
 #endif
 
 /* Allocate a new UDP data callback */
@@ -110,6 +119,9 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  hash_node_t hnode;      /* Node in the local port hashtable */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -126,6 +138,9 @@ struct udp_conn_s
 #endif
 #ifdef CONFIG_NETDEV_RSS
   int      rcvcpu;        /* Last recvfrom cpuid */
+#endif
+#ifdef CONFIG_NET_UDP_SEGMENT
+  uint16_t seg_size;      /* UDP_SEGMENT datagram size, 0: disabled */
 #endif
   /* Read-ahead buffering.
    *
@@ -147,6 +162,11 @@ struct udp_conn_s
   /* Callback instance for UDP sendto() */
 
   FAR struct devif_callback_s *sndcb;
+
+#ifdef UDP_WB_CHKSUM
+  uint16_t sndsum;                /* Payload checksum of the datagram being
+                                   * sent, 0 if not known */
+#endif
 #endif
 
 #if defined(CONFIG_NET_IGMP) || defined(CONFIG_NET_MLD)
@@ -175,6 +195,9 @@ struct udp_wrbuffer_s
   sq_entry_t wb_node;              /* Supports a singly linked list */
   struct sockaddr_storage wb_dest; /* Destination address */
   FAR struct iob_s *wb_iob;        /* Head of the I/O buffer chain */
+#ifdef UDP_WB_CHKSUM
+  uint16_t wb_chksum;              /* Raw checksum of the payload */
+#endif
 };
 #endif
 
@@ -253,6 +276,18 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Set (or clear, if portno is zero) the local port of a UDP connection.
+ *   All changes of the local port of an allocated connection must go
+ *   through this function so that the connection can be found by its port.
+ *
+ ****************************************************************************/
+
+void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -496,6 +531,60 @@ int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the complete list of appropriate return error codes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
+/****************************************************************************
+ * Name: udp_sendto_split
+ *
+ * Description:
+ *   Send 'buf' as a train of datagrams of the UDP_SEGMENT size, the last
+ *   one possibly shorter.  Called by psock_udp_sendto() when the buffer is
+ *   larger than the segment size.  The buffer is split here, in the socket
+ *   layer, and each datagram is sent through psock_udp_sendto() on its
+ *   own; no segmentation offload is involved.
+ *
+ * Input Parameters:
+ *   See psock_udp_sendto()
+ *
+ * Returned Value:
+ *   The number of bytes sent if at least one datagram was sent.  Otherwise
+ *   a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+ssize_t udp_sendto_split(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags,
+                         FAR const struct sockaddr *to, socklen_t tolen);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_alloc
  *
@@ -767,6 +856,29 @@ void udp_callback_cleanup(FAR void *arg);
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' datagrams on a UDP SOCK_DGRAM socket.  Only the
+ *   first receive may block; the datagrams queued behind it are collected
+ *   without releasing the connection lock in between.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Vector of buffers to receive the datagrams
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  On error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
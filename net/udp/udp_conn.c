@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/net/netconfig.h>
@@ -96,10 +97,51 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* The bound connections (lport != 0) hashed by local port */
+
+static DECLARE_HASHTABLE(g_udp_port_hash, CONFIG_NET_UDP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nextport
+ *
+ * Description:
+ *   Traverse the connections that may be bound to the local port 'portno'.
+ *   Without the hashtable this is every allocated connection; the caller
+ *   must still check the port of each connection returned.
+ *
+ * Assumptions:
+ *   This function must be called with the udp_conn_list_lock.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nextport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR hash_node_t *node;
+
+  if (conn == NULL)
+    {
+      node = g_udp_port_hash[HASH(portno,
+                                  hashtable_bits(g_udp_port_hash))].head;
+    }
+  else
+    {
+      node = conn->hnode.flink;
+    }
+
+  return node != NULL ? container_of(node, struct udp_conn_s, hnode) : NULL;
+#else
+  return udp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -112,6 +154,8 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: Likewise, the sockets then form a group that
+ *                            shares incoming datagrams.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -126,11 +170,14 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+  bool skip_shared = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
   /* Now search each connection structure. */
 
   udp_conn_list_lock();
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nextport(conn, portno)) != NULL)
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -143,6 +190,13 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         }
 #endif
 
+#ifdef CONFIG_NET_REUSEPORT
+      if (skip_shared && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -204,7 +258,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn)
     {
@@ -318,7 +372,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -344,7 +398,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -458,7 +512,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -570,6 +624,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
       nxsem_init(&conn->sndsem, 0, 0);
 #endif
+#ifdef CONFIG_NET_UDP_SEGMENT
+      conn->seg_size    = 0;
+#endif
 
       nxrmutex_init(&conn->sconn.s_lock);
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -605,8 +662,14 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  /* Drop any pending poll request left on the device ready list.  This
+   * takes the device lock, so do it before the connection list lock.
+   */
+
+  netdev_txnotify_cancel(&conn->sconn, UDP_POLL);
+
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_setlport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -735,6 +798,35 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Set (or clear, if portno is zero) the local port of a UDP connection.
+ *
+ ****************************************************************************/
+
+void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  udp_conn_list_lock();
+  if (conn->lport != 0)
+    {
+      hashtable_delete(g_udp_port_hash, &conn->hnode, conn->lport);
+    }
+
+  conn->lport = portno;
+  if (portno != 0)
+    {
+      hashtable_add(g_udp_port_hash, &conn->hnode, portno);
+    }
+
+  udp_conn_list_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -876,7 +968,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +993,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
       else
@@ -953,12 +1045,14 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      if (!conn->lport)
+      uint16_t portno = HTONS(udp_select_port(conn->domain, &conn->u));
+      if (!portno)
         {
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_setlport(conn, portno);
     }
 
   /* Is there a remote port (rport)? */
@@ -1065,7 +1159,9 @@ void udp_leavegroup(FAR struct udp_conn_s *conn)
 
       if ((dev = netdev_findbyindex(conn->mreq.imr_ifindex)) != NULL)
         {
+          netdev_lock(dev);
           igmp_leavegroup(dev, &conn->mreq.imr_multiaddr);
+          netdev_unlock(dev);
         }
     }
 }
@@ -48,6 +48,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <debug.h>
+#include <string.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
@@ -55,6 +56,7 @@
 #include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 #include "udp/udp.h"
 #include "icmp/icmp.h"
@@ -111,6 +113,91 @@ static bool udp_is_broadcast(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: udp_reuseport_member
+ *
+ * Description:
+ *   Return true if member is in the same SO_REUSEPORT group as conn.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+static bool udp_reuseport_member(FAR struct udp_conn_s *conn,
+                                 FAR struct udp_conn_s *member,
+                                 FAR const void *laddr, size_t addrlen)
+{
+  return member->domain == conn->domain &&
+         _SO_GETOPT(member->sconn.s_options, SO_REUSEPORT) &&
+         !_UDP_ISCONNECTMODE(member->flags) &&
+         memcmp(net_ip_binding_laddr(&member->u, member->domain), laddr,
+                addrlen) == 0;
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Given the first connection matching a unicast datagram, pick the member
+ *   of its SO_REUSEPORT group (unconnected sockets with the option set on
+ *   exactly the same local address and port) that should receive it.  The
+ *   choice is a hash of the source address and port, so a flow always goes
+ *   to the same socket while the group is unchanged.
+ *
+ * Assumptions:
+ *   Called with the UDP connection list locked.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *
+udp_reuseport_select(FAR struct net_driver_s *dev,
+                     FAR struct udp_conn_s *conn, FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *member;
+  FAR const void *raddr;
+  FAR void *laddr;
+  size_t addrlen;
+  uint32_t index;
+  uint32_t count = 0;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) ||
+      _UDP_ISCONNECTMODE(conn->flags))
+    {
+      return conn;
+    }
+
+  laddr   = net_ip_binding_laddr(&conn->u, conn->domain);
+  addrlen = net_ip_domain_select(conn->domain, sizeof(in_addr_t),
+                                 sizeof(net_ipv6addr_t));
+  raddr   = net_ip_domain_select(conn->domain,
+                                 (FAR const void *)IPv4BUF->srcipaddr,
+                                 (FAR const void *)IPv6BUF->srcipaddr);
+
+  /* Count the group, then walk to the member selected by the hash */
+
+  for (member = conn; member != NULL;
+       member = udp_active(dev, member, udp))
+    {
+      if (udp_reuseport_member(conn, member, laddr, addrlen))
+        {
+          count++;
+        }
+    }
+
+  index = net_reuseport_hash(raddr, addrlen, udp->srcport) % count;
+  for (member = conn; member != NULL;
+       member = udp_active(dev, member, udp))
+    {
+      if (udp_reuseport_member(conn, member, laddr, addrlen) &&
+          index-- == 0)
+        {
+          return member;
+        }
+    }
+
+  return conn;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_input_conn
  *
@@ -303,6 +390,17 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
       udp_conn_list_lock();
       conn = udp_active(dev, NULL, udp);
+#ifdef CONFIG_NET_REUSEPORT
+      if (conn != NULL
+#  ifdef CONFIG_NET_BROADCAST
+          && !udp_is_broadcast(dev)
+#  endif
+         )
+        {
+          conn = udp_reuseport_select(dev, conn, udp);
+        }
+#endif
+
       if (conn)
         {
           /* We'll only get multiple conn when we support SO_REUSEADDR */
@@ -796,4 +796,66 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' datagrams on a UDP SOCK_DGRAM socket.  Only the
+ *   first receive may block; the datagrams queued behind it are collected
+ *   without releasing the connection lock in between.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Vector of buffers to receive the datagrams
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  On error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  unsigned int count;
+  ssize_t ret = 0;
+
+  /* Hold the locks across the whole batch.  Each psock_recvmsg() below
+   * only nests on them, and a blocking wait for the first datagram still
+   * breaks them completely so that the input path can deliver it.
+   */
+
+  dev = udp_find_laddr_device(conn);
+  conn_dev_lock(&conn->sconn, dev);
+
+  for (count = 0; count < vlen; count++)
+    {
+      /* psock_recvmsg() also validates the message and fixes up the
+       * control buffer length, exactly as for a single recvmsg().
+       */
+
+      ret = psock_recvmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+      flags |= MSG_DONTWAIT;
+    }
+
+  conn_dev_unlock(&conn->sconn, dev);
+
+  if (count > 0)
+    {
+      return count;
+    }
+
+  return ret;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -152,6 +152,13 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
 #ifdef CONFIG_NET_IPv4
   in_addr_t raddr;
 #endif
+#ifdef UDP_WB_CHKSUM
+  uint16_t sndsum = conn->sndsum;
+
+  /* The payload sum is only good for this datagram */
+
+  conn->sndsum = 0;
+#endif
 
   ninfo("UDP payload: %d (%d) bytes\n", dev->d_sndlen, dev->d_len);
 
@@ -252,6 +259,16 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
 
       if ((dev->d_features & NETDEV_TX_CSUM) == 0)
         {
+#ifdef UDP_WB_CHKSUM
+          /* The payload was summed when it was buffered */
+
+          if (sndsum != 0)
+            {
+              udp->udpchksum = ~net_upperlayer_chksum_presummed(dev,
+                                 IP_PROTO_UDP, udp, UDP_HDRLEN, sndsum);
+            }
+          else
+#endif
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
           if (IFF_IS_IPv4(dev->d_flags))
@@ -269,12 +269,14 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      if (!conn->lport)
+      uint16_t portno = HTONS(udp_select_port(conn->domain, &conn->u));
+      if (!portno)
         {
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_setlport(conn, portno);
     }
 
   /* Get the device that will handle the remote packet transfers.  This
@@ -357,7 +359,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
 
   /* Notify the device driver of the availability of TX data */
 
-  netdev_txnotify_dev(dev, UDP_POLL);
+  netdev_txnotify_conn(dev, &conn->sconn, UDP_POLL);
 
 out:
   conn_dev_unlock(&conn->sconn, dev);
@@ -473,6 +475,12 @@ static uint32_t sendto_eventhandler(FAR struct net_driver_s *dev,
       dev->d_sndlen = wrb->wb_iob->io_pktlen - udpiplen;
       ninfo("wrb=%p sndlen=%d\n", wrb, dev->d_sndlen);
 
+#ifdef UDP_WB_CHKSUM
+      /* Let udp_send() reuse the sum of the payload */
+
+      conn->sndsum = wrb->wb_chksum;
+#endif
+
       /* Do not need to release wb_iob, the life cycle of wb_iob is
        * handed over to the network device
        */
@@ -588,6 +596,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EMSGSIZE;
     }
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  /* Let UDP_SEGMENT split large buffers into a train of datagrams */
+
+  if (conn->seg_size > 0 && len > conn->seg_size)
+    {
+      return udp_sendto_split(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
    * used with a non-NULL destination address.  Normally send() would be
@@ -840,6 +857,14 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+#ifdef UDP_WB_CHKSUM
+      bool odd = false;
+
+      wrb->wb_chksum = 0;
+      ret = net_iob_copyin_chksum(wrb->wb_iob, (FAR uint8_t *)buf,
+                                  len, udpiplen, false, !nonblock,
+                                  &wrb->wb_chksum, &odd);
+#else
       if (nonblock)
         {
           ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
@@ -850,6 +875,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
           ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
                            len, udpiplen, false);
         }
+#endif
 
       if (ret < 0)
         {
@@ -0,0 +1,104 @@
+/****************************************************************************
+ * net/udp/udp_sendto_split.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_sendto_split
+ *
+ * Description:
+ *   Send 'buf' as a train of datagrams of the UDP_SEGMENT size, the last
+ *   one possibly shorter.  Called by psock_udp_sendto() when the buffer is
+ *   larger than the segment size.  The buffer is split here, in the socket
+ *   layer, and each datagram is sent through psock_udp_sendto() on its
+ *   own; no segmentation offload is involved.
+ *
+ * Input Parameters:
+ *   See psock_udp_sendto()
+ *
+ * Returned Value:
+ *   The number of bytes sent if at least one datagram was sent.  Otherwise
+ *   a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t udp_sendto_split(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags,
+                         FAR const struct sockaddr *to, socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR const uint8_t *ptr = buf;
+  size_t segsize = conn->seg_size;
+  size_t sent = 0;
+  ssize_t ret;
+
+  if ((len + segsize - 1) / segsize > CONFIG_NET_UDP_SEGMENT_MAX)
+    {
+      nerr("ERROR: %zu bytes exceed %d segments of %zu\n",
+           len, CONFIG_NET_UDP_SEGMENT_MAX, segsize);
+      return -EINVAL;
+    }
+
+  /* Each piece is no larger than the segment size, so psock_udp_sendto()
+   * sends it as it is.
+   */
+
+  while (sent < len)
+    {
+      ret = psock_udp_sendto(psock, ptr + sent, MIN(segsize, len - sent),
+                             flags, to, tolen);
+      if (ret < 0)
+        {
+          if (sent > 0)
+            {
+              break;
+            }
+
+          return ret;
+        }
+
+      sent += ret;
+    }
+
+  return sent;
+}
+
+#endif /* CONFIG_NET_UDP_SEGMENT */
@@ -305,6 +305,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   conn = psock->s_conn;
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  /* Let UDP_SEGMENT split large buffers into a train of datagrams */
+
+  if (conn->seg_size > 0 && len > conn->seg_size)
+    {
+      return udp_sendto_split(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
   if (to != NULL && _SS_ISCONNECTED(conn->sconn.s_flags))
     {
       /* EISCONN - A destination address was specified and the socket is
@@ -477,7 +486,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
       /* Notify the device driver of the availability of TX data */
 
-      netdev_txnotify_dev(state.st_dev, UDP_POLL);
+      netdev_txnotify_conn(state.st_dev, &conn->sconn, UDP_POLL);
 
       /* Wait for either the receive to complete or for an error/timeout to
        * occur. NOTES: conn_dev_sem_timedwait will also terminate if a signal
@@ -76,7 +76,50 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-  return -ENOPROTOOPT;
+  int ret;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      nerr("ERROR:  Not a UDP socket\n");
+      return -ENOTCONN;
+    }
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_SEGMENT
+      case UDP_SEGMENT: /* Datagram size of the send train */
+        {
+          FAR struct udp_conn_s *conn = psock->s_conn;
+          int size;
+
+          if (value == NULL || value_len < sizeof(int))
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          size = *(FAR const int *)value;
+          if (size < 0 || size > UINT16_MAX)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          conn_lock(&conn->sconn);
+          conn->seg_size = size;
+          conn_unlock(&conn->sconn);
+          ret = OK;
+        }
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
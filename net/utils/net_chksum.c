@@ -27,12 +27,143 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <sys/endian.h>
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* chksum_copy() sums each chunk right after copying it, while it is still
+ * in the cache.
+ */
+
+#define CHKSUM_COPY_CHUNK 256
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 64-bit accumulator of 16-bit words into 16 bits, adding the
+ *   carries back in (end-around carry).
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static inline uint16_t chksum_fold(uint64_t acc)
+{
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Calculate the one's complement sum of the 16-bit words in the memory
+ *   region described by data and len, in native byte order.  The words
+ *   start at data, a trailing odd byte is padded with zero.
+ *
+ *   The words are added 32 bits at a time into a 64-bit accumulator, so
+ *   the carries can be folded back once at the end instead of being tested
+ *   after every addition (RFC 1071, section 2).  A misaligned buffer is
+ *   summed from the next aligned address and the result byte swapped.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_native(FAR const uint8_t *data, size_t len)
+{
+  uint64_t acc = 0;
+  uint16_t sum;
+  bool odd;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Start on a 16-bit boundary.  The first byte is the second one of its
+   * word then, the sum is swapped back below.
+   */
+
+  odd = ((uintptr_t)data & 1) != 0;
+  if (odd)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc = data[0];
+#else
+      acc = (uint32_t)data[0] << 8;
+#endif
+      data++;
+      len--;
+    }
+
+  /* And then on a 32-bit boundary */
+
+  if (len >= 2 && ((uintptr_t)data & 2) != 0)
+    {
+      acc += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* 32-bit words, four at a time.  The 64-bit accumulator cannot overflow
+   * here: that would take more than 2^32 words.
+   */
+
+  while (len >= 16)
+    {
+      FAR const uint32_t *word = (FAR const uint32_t *)data;
+
+      acc += (uint64_t)word[0] + word[1] + word[2] + word[3];
+      data += 16;
+      len  -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc += *(FAR const uint32_t *)data;
+      data += 4;
+      len  -= 4;
+    }
+
+  if (len >= 2)
+    {
+      acc += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint32_t)data[0] << 8;
+#else
+      acc += data[0];
+#endif
+    }
+
+  sum = chksum_fold(acc);
+  return odd ? swap16(sum) : sum;
+}
+
 /****************************************************************************
  * Name: checksum
  *
@@ -53,60 +184,30 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t part;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* The sum of the words of the data in host byte order */
 
-  if (*odd == true)
-    {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  part = NTOHS(chksum_native(data, len));
 
-      dataptr += 1;
-    }
+  /* If the previous data ended with an odd byte, the data starts with the
+   * second byte of a word: all of its words are byte swapped.
+   */
 
-  while (dataptr < last_byte)
+  if (*odd)
     {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      part = swap16(part);
     }
 
-  *odd = false;
-
-  if (dataptr == last_byte)
-    {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      *odd = true;
-    }
+  *odd ^= (len & 1) != 0;
 
   /* Return sum in host byte order. */
 
-  return sum;
+  part += sum;
+  return (uint16_t)((part & 0xffff) + (part >> 16));
 }
 
 /****************************************************************************
@@ -188,6 +289,154 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 }
 #endif /* CONFIG_MM_IOB */
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy data and calculate its raw checksum in the same pass, so that
+ *   the data is only brought into the cache once.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call.  This
+ *          should be zero on the first call.
+ *   dest - Where to copy the data to.
+ *   src  - The data to copy and to include in the checksum.
+ *   len  - Length of the data.
+ *   odd  - True if the previous data ended with an odd byte; updated for
+ *          the next call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len, FAR bool *odd)
+{
+  uint16_t ncopy;
+
+  while (len > 0)
+    {
+      ncopy = len > CHKSUM_COPY_CHUNK ? CHKSUM_COPY_CHUNK : len;
+
+      memcpy(dest, src, ncopy);
+      sum = checksum(sum, dest, ncopy, odd);
+
+      dest += ncopy;
+      src  += ncopy;
+      len  -= ncopy;
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: net_iob_copyin_chksum
+ *
+ * Description:
+ *   Copy data into an I/O buffer chain like iob_copyin() or
+ *   iob_trycopyin(), calculating its raw checksum on the way.
+ *
+ * Input Parameters:
+ *   iob       - The I/O buffer chain to copy to.
+ *   src       - The data to copy.
+ *   len       - Length of the data.
+ *   offset    - Offset in the I/O buffer chain to copy to.
+ *   throttled - An indication of the IOB allocation is "throttled".
+ *   can_block - Whether to wait for I/O buffers.
+ *   sum       - In: the checksum of the preceding data (zero if none);
+ *               out: updated with the data that was copied, even if not
+ *               all of it could be.
+ *   odd       - True if the preceding data ended with an odd byte;
+ *               updated like sum.
+ *
+ * Returned Value:
+ *   The number of bytes copied (len) on success; a negated errno value on
+ *   failure, as for iob_copyin().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+int net_iob_copyin_chksum(FAR struct iob_s *iob, FAR const uint8_t *src,
+                          unsigned int len, int offset, bool throttled,
+                          bool can_block, FAR uint16_t *sum, FAR bool *odd)
+{
+  FAR struct iob_s *head = iob;
+  FAR struct iob_s *next;
+  unsigned int total = len;
+  unsigned int ncopy;
+  unsigned int avail;
+
+  DEBUGASSERT(iob != NULL && src != NULL && sum != NULL && odd != NULL);
+
+  if (offset < 0 || offset > head->io_pktlen)
+    {
+      return -ESPIPE;
+    }
+
+  /* Skip to the I/O buffer containing the data offset */
+
+  while (offset > iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (len > 0)
+    {
+      next  = iob->io_flink;
+      avail = iob->io_len - offset;
+
+      if (len <= avail)
+        {
+          ncopy = len;
+        }
+      else if (next != NULL)
+        {
+          /* Overwrite up to the end of this buffer in mid-chain */
+
+          ncopy = avail;
+        }
+      else
+        {
+          /* Extend the last buffer as far as possible */
+
+          ncopy = IOB_BUFSIZE(iob) - iob->io_offset - offset;
+          if (ncopy > len)
+            {
+              ncopy = len;
+            }
+
+          head->io_pktlen += offset + ncopy - iob->io_len;
+          iob->io_len      = offset + ncopy;
+        }
+
+      *sum = chksum_copy(*sum, &iob->io_data[iob->io_offset + offset],
+                         src, ncopy, odd);
+
+      len -= ncopy;
+      src += ncopy;
+
+      if (len > 0 && next == NULL)
+        {
+          next = can_block ? iob_alloc(throttled) : iob_tryalloc(throttled);
+          if (next == NULL)
+            {
+              nerr("ERROR: Failed to allocate I/O buffer\n");
+              return -ENOMEM;
+            }
+
+          iob->io_flink = next;
+        }
+
+      iob    = next;
+      offset = 0;
+    }
+
+  return total;
+}
+#endif /* CONFIG_MM_IOB */
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -31,6 +31,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 
+#include "netdev/netdev.h"
 #include "utils/utils.h"
 
 #ifdef CONFIG_NET
@@ -276,6 +277,64 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: net_upperlayer_chksum_presummed
+ *
+ * Description:
+ *   Calculate the TCP or UDP checksum of the packet in d_iob from its
+ *   pseudo-header, its transport header and the raw checksum of its
+ *   payload, that was calculated before (e.g. when the payload was copied
+ *   from the user).
+ *
+ * Input Parameters:
+ *   dev    - The network driver instance.  The packet is in d_iob.
+ *   proto  - The transport protocol
+ *   hdr    - The transport header
+ *   hdrlen - The length of the transport header, a multiple of 2
+ *   paysum - The raw checksum of the payload
+ *
+ * Returned Value:
+ *   The calculated checksum, as ipv4_upperlayer_chksum() or
+ *   ipv6_upperlayer_chksum() return it.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_MM_IOB)
+uint16_t net_upperlayer_chksum_presummed(FAR struct net_driver_s *dev,
+                                         uint8_t proto,
+                                         FAR const void *hdr,
+                                         uint16_t hdrlen, uint16_t paysum)
+{
+  uint32_t sum;
+
+  DEBUGASSERT((hdrlen & 1) == 0);
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      sum = ipv6_upperlayer_header_chksum(dev, proto, IPv6_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      sum = ipv4_upperlayer_header_chksum(dev, proto);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  sum  = chksum(sum, hdr, hdrlen);
+  sum += paysum;
+  sum  = (sum & 0xffff) + (sum >> 16);
+
+  return (sum == 0) ? 0xffff : HTONS(sum);
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM && CONFIG_MM_IOB */
+
 /****************************************************************************
  * Name: ipv4_chksum
  *
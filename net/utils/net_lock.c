@@ -134,7 +134,10 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
  * Name: net_lock
  *
  * Description:
- *   Take the network lock
+ *   Take the network lock.  Packet processing is serialized by the
+ *   per-device (netdev_lock) and per-connection (conn_lock) locks; this
+ *   lock only protects global state owned by neither of them and must not
+ *   be needed on the RX/TX path of the stack itself.
  *
  * Input Parameters:
  *   None
@@ -0,0 +1,76 @@
+/****************************************************************************
+ * net/utils/net_reuseport.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_REUSEPORT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_reuseport_hash
+ *
+ * Description:
+ *   Hash the remote end of a flow to pick one socket out of a SO_REUSEPORT
+ *   group.  The same peer address and port always give the same value, so
+ *   every segment of a TCP handshake and every datagram of a UDP flow land
+ *   on the same socket while the group is unchanged.
+ *
+ * Input Parameters:
+ *   raddr   - The remote IPv4 or IPv6 address (network order).
+ *   addrlen - Size of raddr in bytes, a multiple of 4.
+ *   rport   - The remote port (network order).
+ *
+ * Returned Value:
+ *   The flow hash.
+ *
+ ****************************************************************************/
+
+uint32_t net_reuseport_hash(FAR const void *raddr, size_t addrlen,
+                            uint16_t rport)
+{
+  FAR const uint8_t *addr = raddr;
+  uint32_t hash = rport;
+  uint32_t word;
+  size_t i;
+
+  for (i = 0; i + sizeof(word) <= addrlen; i += sizeof(word))
+    {
+      memcpy(&word, addr + i, sizeof(word));
+      hash = (hash ^ word) * 0x9e3779b1u;
+    }
+
+  return hash ^ (hash >> 16);
+}
+
+#endif /* CONFIG_NET_REUSEPORT */
@@ -437,6 +437,28 @@ FAR void *net_ipv6_payload(FAR struct ipv6_hdr_s *ipv6, FAR uint8_t *proto);
 uint16_t net_iob_concat(FAR struct iob_s **iob1, FAR struct iob_s **iob2);
 #endif
 
+/****************************************************************************
+ * Name: net_reuseport_hash
+ *
+ * Description:
+ *   Hash the remote address and port of a flow, used to spread new flows
+ *   over the sockets of a SO_REUSEPORT group.
+ *
+ * Input Parameters:
+ *   raddr   - The remote IPv4 or IPv6 address (network order).
+ *   addrlen - Size of raddr in bytes, a multiple of 4.
+ *   rport   - The remote port (network order).
+ *
+ * Returned Value:
+ *   The flow hash.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+uint32_t net_reuseport_hash(FAR const void *raddr, size_t addrlen,
+                            uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: net_bufpool_timedalloc
  *
@@ -546,6 +568,67 @@ void net_chksum_adjust(FAR uint16_t *chksum,
                        FAR const uint16_t *optr, ssize_t olen,
                        FAR const uint16_t *nptr, ssize_t nlen);
 
+/****************************************************************************
+ * Name: net_iob_copyin_chksum
+ *
+ * Description:
+ *   Copy data into an I/O buffer chain like iob_copyin() or
+ *   iob_trycopyin(), calculating its raw checksum on the way.
+ *
+ * Input Parameters:
+ *   iob       - The I/O buffer chain to copy to.
+ *   src       - The data to copy.
+ *   len       - Length of the data.
+ *   offset    - Offset in the I/O buffer chain to copy to.
+ *   throttled - An indication of the IOB allocation is "throttled".
+ *   can_block - Whether to wait for I/O buffers.
+ *   sum       - In: the checksum of the preceding data (zero if none);
+ *               out: updated with the data that was copied, even if not
+ *               all of it could be.
+ *   odd       - True if the preceding data ended with an odd byte;
+ *               updated like sum.
+ *
+ * Returned Value:
+ *   The number of bytes copied (len) on success; a negated errno value on
+ *   failure, as for iob_copyin().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+int net_iob_copyin_chksum(FAR struct iob_s *iob, FAR const uint8_t *src,
+                          unsigned int len, int offset, bool throttled,
+                          bool can_block, FAR uint16_t *sum, FAR bool *odd);
+#endif
+
+/****************************************************************************
+ * Name: net_upperlayer_chksum_presummed
+ *
+ * Description:
+ *   Calculate the TCP or UDP checksum of the packet in d_iob from its
+ *   pseudo-header, its transport header and the raw checksum of its
+ *   payload, that was calculated before (e.g. when the payload was copied
+ *   from the user).
+ *
+ * Input Parameters:
+ *   dev    - The network driver instance.  The packet is in d_iob.
+ *   proto  - The transport protocol
+ *   hdr    - The transport header
+ *   hdrlen - The length of the transport header, a multiple of 2
+ *   paysum - The raw checksum of the payload
+ *
+ * Returned Value:
+ *   The calculated checksum, as ipv4_upperlayer_chksum() or
+ *   ipv6_upperlayer_chksum() return it.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_MM_IOB)
+uint16_t net_upperlayer_chksum_presummed(FAR struct net_driver_s *dev,
+                                         uint8_t proto,
+                                         FAR const void *hdr,
+                                         uint16_t hdrlen, uint16_t paysum);
+#endif
+
 /****************************************************************************
  * Name: tcp_chksum, tcp_ipv4_chksum, and tcp_ipv6_chksum
  *